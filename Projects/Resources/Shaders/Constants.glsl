@@ -0,0 +1,34 @@
+/* Per frame constants; must match with ShaderConstants.h */
+struct DirectionalLight
+{
+	vec3 Direction;
+	vec3 Intensity;
+};
+
+layout(std140, binding = 0) uniform FrameConstants
+{
+	mat4 viewMatrix;
+	mat4 projMatrix;
+	vec3 camPos;
+};
+
+layout(std140, binding = 1) uniform LightConstants
+{
+	DirectionalLight light;
+	mat4 shadowViewMat;
+	mat4 shadowProjMat;
+};
+
+layout(std140, binding = 2) uniform VoxelConstants
+{
+	mat4 projXAxis;
+	mat4 projYAxis;
+	mat4 projZAxis;
+	float voxelGridWorldSize;
+	float voxelDim;
+	float maxDist_VCT;
+	float step_VCT;
+	float alphaThreshold_VCT;
+	float initialStep_VCT;
+	int specularSampleNum_VCT;
+};
@@ -0,0 +1,32 @@
+#version 450 core
+#ifdef BINDLESS_MATERIALS
+#extension GL_ARB_bindless_texture : require
+#endif
+in vec2 texCoordsFrag;
+
+#include "Material.glsl"
+
+/* Only for alpha test, which must match with VoxelConeTracingFS */
+void main()
+{
+	LoadMaterial();
+	float alpha = baseColorFactor.a;
+	if (bOverrideBaseColor != 1)
+	{
+		alpha = SampleMaterialTexture(BaseColorTexture, texCoordsFrag).a;
+	}
+
+	if (bOverrideEmissive != 1)
+	{
+		float emissiveAlpha = SampleMaterialTexture(EmissiveTexture, texCoordsFrag).a;
+		if (emissiveAlpha < 1.0)
+		{
+			alpha = emissiveAlpha;
+		}
+	}
+
+	if (isRefract != 1 && alpha < 0.1)
+	{
+		discard;
+	}
+}
@@ -0,0 +1,20 @@
+#version 450 core
+#include "DrawData.glsl"
+#include "VertexInput.glsl"
+
+#include "Constants.glsl"
+
+flat out uint materialIndexFrag;
+out vec2 texCoordsFrag;
+
+// Must produce bit-exact depth with VoxelConeTracingVS for GL_EQUAL depth test
+invariant gl_Position;
+
+void main()
+{
+	mat4 worldMatrix = draws[aDrawIndex].WorldMatrix;
+	materialIndexFrag = draws[aDrawIndex].MaterialIndex;
+	vec4 worldPosition = worldMatrix * vec4(GetLocalPosition(), 1.0);
+	texCoordsFrag = aTexcoord;
+	gl_Position = projMatrix * viewMatrix * worldPosition;
+}
@@ -0,0 +1,13 @@
+/* Per draw data; must match with DrawData of RenderQueue.h */
+struct DrawData
+{
+	mat4 WorldMatrix;
+	vec3 PositionOffset;
+	uint MaterialIndex;
+	vec3 PositionScale;
+};
+
+layout(std430, binding = 0) readonly buffer DrawDataBuffer
+{
+	DrawData draws[];
+};
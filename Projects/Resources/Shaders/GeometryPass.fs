@@ -1,4 +1,7 @@
-#version 330 core
+#version 450 core
+#ifdef BINDLESS_MATERIALS
+#extension GL_ARB_bindless_texture : require
+#endif
 out vec4 fragColor;
 layout (location=0) out vec3 aPosition;
 layout (location=1) out vec3 aNormal;
@@ -11,26 +14,7 @@ in vec2 texcoord;
 in vec3 worldNormal;
 in mat3 tbn;
 
-// baseColorMap: sRGB
-uniform sampler2D baseColorMap;
-uniform vec4 baseColorFactor;
-
-uniform sampler2D normalMap;
-uniform int bUseNormalMap;
-
-// metallicRoughnessMap: Linear(B:Metallic, G:Roughness)
-uniform sampler2D metallicRoughnessMap;
-uniform float metallicFactor;
-uniform float roughnessFactor;
-
-// aoMap(Ambient Occlusion Map): Linear(R channel only)
-uniform sampler2D aoMap;
-
-// emissiveMap: sRGB
-uniform sampler2D emissiveMap;
-uniform vec3 emissiveFactor;
-uniform float emissiveIntensity;
-
+#include "Material.glsl"
 
 const float PI = 3.14159265359;
 
@@ -41,9 +25,10 @@ vec3 pow3(vec3 v, float power)
 
 void main()
 {
-	float ao = texture(aoMap, texcoord).r;
+	LoadMaterial();
+	float ao = SampleMaterialTexture(AOTexture, texcoord).r;
 
-	vec4 albedo = texture(baseColorMap, texcoord);
+	vec4 albedo = SampleMaterialTexture(BaseColorTexture, texcoord);
 	if (albedo.a < 0.1)
 	{
 		discard;
@@ -53,19 +38,19 @@ void main()
 	vec3 normal = worldNormal;
 	if (bUseNormalMap == 1)
 	{
-		normal = texture(normalMap, texcoord).rgb;
+		normal = SampleMaterialTexture(NormalTexture, texcoord).rgb;
 		normal = normalize(normal*2.0-1.0);
 		normal = normalize(tbn * normal);
 	}
 	
 	vec3 N = normalize(normal);
 
-	vec3 emissive = pow3(texture(emissiveMap, texcoord).rgb, 2.2);
+	vec3 emissive = pow3(SampleMaterialTexture(EmissiveTexture, texcoord).rgb, 2.2);
 	emissive += pow3(emissiveFactor, 2.2);
 	emissive *= emissiveIntensity;
 
-	float metallic = metallicFactor + texture(metallicRoughnessMap, texcoord).b;
-	float roughness = roughnessFactor + texture(metallicRoughnessMap, texcoord).g;
+	float metallic = metallicFactor + SampleMaterialTexture(MetallicRoughnessTexture, texcoord).b;
+	float roughness = roughnessFactor + SampleMaterialTexture(MetallicRoughnessTexture, texcoord).g;
 
 	aPosition = worldPos;
 	aNormal = N;
@@ -1,13 +1,10 @@
-#version 330 core
-layout (location=0) in vec3 aPos;
-layout (location=1) in vec2 aTexcoord;
-layout (location=2) in vec3 aNormal;
-layout (location=3) in vec3 aTangent;
+#version 450 core
+#include "DrawData.glsl"
+#include "VertexInput.glsl"
 
-uniform mat4 worldMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 projMatrix;
+#include "Constants.glsl"
 
+flat out uint materialIndexFrag;
 out vec3 worldPos;
 out vec2 texcoord;
 out vec3 worldNormal;
@@ -15,14 +12,16 @@ out mat3 tbn;
 
 void main()
 {
-	vec4 worldPosition = worldMatrix * vec4(aPos, 1.0);
+	mat4 worldMatrix = draws[aDrawIndex].WorldMatrix;
+	materialIndexFrag = draws[aDrawIndex].MaterialIndex;
+	vec4 worldPosition = worldMatrix * vec4(GetLocalPosition(), 1.0);
 	worldPos = worldPosition.xyz;
 	texcoord = aTexcoord;
 
-	vec3 normal = normalize(mat3(transpose(inverse(worldMatrix)))*aNormal.xyz);
+	vec3 normal = normalize(mat3(transpose(inverse(worldMatrix)))*GetLocalNormal());
 	worldNormal = normal;
 
-	vec3 tangent = normalize(worldMatrix * vec4(aTangent, 0.0)).xyz;
+	vec3 tangent = normalize(worldMatrix * vec4(GetLocalTangent(), 0.0)).xyz;
 	tangent = normalize(tangent - dot(tangent, normal) * normal);
 	vec3 bitangent = normalize(cross(normal, tangent).xyz);
 
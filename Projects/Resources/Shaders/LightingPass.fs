@@ -1,4 +1,4 @@
-#version 330 core
+#version 450 core
 out vec4 fragColor;
 
 const int maxLightsNum = 128;
@@ -8,17 +8,10 @@ struct Light{
 	vec3 intensity;
 };
 
-struct DirectionalLight
-{
-	vec3 Direction;
-	vec3 Intensity;
-};
-
 in vec2 texcoord;
 
 //uniform Light lights[maxLightsNum];
 //uniform int numOfLights;
-uniform DirectionalLight light;
 
 uniform sampler2D positionBuffer;
 uniform sampler2D normalBuffer;
@@ -27,9 +20,7 @@ uniform sampler2D metallicRoughnessBuffer;
 uniform sampler2D emissiveAOBuffer;
 uniform sampler2DShadow shadowMap;
 
-uniform vec3 camPos;
-uniform mat4 shadowViewMat;
-uniform mat4 shadowProjMat;
+#include "Constants.glsl"
 
 const float PI = 3.14159265359;
 
@@ -2,10 +2,12 @@
 layout (location=0) in vec3 aPos;
 layout (location=1) in vec2 aTexcoord;
 
+uniform vec2 uvScale = vec2(1.0);
+
 out vec2 texcoord;
 
 void main()
 {
 	gl_Position = vec4(aPos, 1.0);
-	texcoord = aTexcoord;
+	texcoord = aTexcoord * uvScale;
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+/* Material table; must match with MaterialGPUData of MaterialTable.h */
+struct MaterialData
+{
+	vec4 BaseColorFactor;
+	vec4 EmissiveFactor; // w: Intensity
+	float MetallicFactor;
+	float RoughnessFactor;
+	float IOR;
+	uint Flags;
+	uvec2 Textures[6]; // Bindless handle or (layer + 1) of materialTextures, zero if not exist. Last one is padding.
+};
+
+layout(std430, binding = 1) readonly buffer MaterialTable
+{
+	MaterialData materials[];
+};
+
+#ifndef BINDLESS_MATERIALS
+layout(binding = 7) uniform sampler2DArray materialTextures;
+#endif
+
+const uint MaterialFlagOverrideBaseColor = 1u;
+const uint MaterialFlagOverrideMetallicRoughness = 2u;
+const uint MaterialFlagOverrideEmissive = 4u;
+const uint MaterialFlagUseNormalMap = 8u;
+const uint MaterialFlagRefract = 16u;
+
+const int BaseColorTexture = 0; // sRGB
+const int NormalTexture = 1;
+const int MetallicRoughnessTexture = 2; // Linear(B:Metallic, G:Roughness)
+const int AOTexture = 3; // Linear(R channel only)
+const int EmissiveTexture = 4; // sRGB
+
+in flat uint materialIndexFrag;
+
+/* Material parameters, loaded by LoadMaterial() */
+vec4 baseColorFactor;
+float metallicFactor;
+float roughnessFactor;
+vec3 emissiveFactor;
+float emissiveIntensity;
+float ior;
+
+#ifdef MATERIAL_PERMUTATION
+/* Flags resolved at compile time; each combination is a separate shader permutation */
+#ifdef MATERIAL_USE_NORMAL_MAP
+const int bUseNormalMap = 1;
+#else
+const int bUseNormalMap = 0;
+#endif
+#ifdef MATERIAL_REFRACT
+const int isRefract = 1;
+#else
+const int isRefract = 0;
+#endif
+#ifdef MATERIAL_OVERRIDE_BASE_COLOR
+const int bOverrideBaseColor = 1;
+#else
+const int bOverrideBaseColor = 0;
+#endif
+#ifdef MATERIAL_OVERRIDE_METALLIC_ROUGHNESS
+const int bOverrideMetallicRoughness = 1;
+#else
+const int bOverrideMetallicRoughness = 0;
+#endif
+#ifdef MATERIAL_OVERRIDE_EMISSIVE
+const int bOverrideEmissive = 1;
+#else
+const int bOverrideEmissive = 0;
+#endif
+#else
+int bUseNormalMap;
+int isRefract;
+int bOverrideBaseColor;
+int bOverrideMetallicRoughness;
+int bOverrideEmissive;
+#endif
+
+void LoadMaterial()
+{
+	MaterialData material = materials[materialIndexFrag];
+	baseColorFactor = material.BaseColorFactor;
+	metallicFactor = material.MetallicFactor;
+	roughnessFactor = material.RoughnessFactor;
+	emissiveFactor = material.EmissiveFactor.xyz;
+	emissiveIntensity = material.EmissiveFactor.w;
+	ior = material.IOR;
+#ifndef MATERIAL_PERMUTATION
+	bUseNormalMap = (material.Flags & MaterialFlagUseNormalMap) != 0u ? 1 : 0;
+	isRefract = (material.Flags & MaterialFlagRefract) != 0u ? 1 : 0;
+	bOverrideBaseColor = (material.Flags & MaterialFlagOverrideBaseColor) != 0u ? 1 : 0;
+	bOverrideMetallicRoughness = (material.Flags & MaterialFlagOverrideMetallicRoughness) != 0u ? 1 : 0;
+	bOverrideEmissive = (material.Flags & MaterialFlagOverrideEmissive) != 0u ? 1 : 0;
+#endif
+}
+
+/* Same result as sampling unbound texture unit when material does not have the texture */
+vec4 SampleMaterialTexture(int textureType, vec2 texCoords)
+{
+	uvec2 textureRef = materials[materialIndexFrag].Textures[textureType];
+	if (textureRef == uvec2(0u))
+	{
+		return vec4(0.0, 0.0, 0.0, 1.0);
+	}
+
+#ifdef BINDLESS_MATERIALS
+	return texture(sampler2D(textureRef), texCoords);
+#else
+	return texture(materialTextures, vec3(texCoords, float(textureRef.x - 1u)));
+#endif
+}
+
@@ -1,11 +1,11 @@
 #version 450 core
-layout (location=0) in vec3 aPos;
+#include "DrawData.glsl"
+#include "VertexInput.glsl"
 
-uniform mat4 shadowViewMatrix;
-uniform mat4 shadowProjMatrix;
-uniform mat4 worldMatrix;
+#include "Constants.glsl"
 
 void main()
 {
-   gl_Position = shadowProjMatrix*shadowViewMatrix*worldMatrix*vec4(aPos, 1.0f);
+   mat4 worldMatrix = draws[aDrawIndex].WorldMatrix;
+   gl_Position = shadowProjMat*shadowViewMat*worldMatrix*vec4(GetLocalPosition(), 1.0f);
 }
\ No newline at end of file
@@ -0,0 +1,64 @@
+#version 450 core
+in vec2 texcoord;
+
+out vec4 fragColor;
+
+uniform sampler2D currentColor;
+uniform sampler2D currentDepth;
+uniform sampler2D historyColor;
+
+/* Scaled render area(render resolution / output resolution) */
+uniform vec2 renderScale;
+/* Projection jitter in NDC of current frame */
+uniform vec2 jitter;
+uniform mat4 invViewProj;
+uniform mat4 prevViewProj;
+uniform float historyWeight = 0.9;
+uniform int bResetHistory = 0;
+
+void main()
+{
+	vec2 texelSize = 1.0 / vec2(textureSize(currentColor, 0));
+	vec2 maxUV = renderScale - (0.5 * texelSize);
+
+	// Remove jitter: surface at this pixel was rasterized at (position + jitter)
+	vec2 currentUV = min((texcoord + (0.5 * jitter)) * renderScale, maxUV);
+	vec3 current = textureLod(currentColor, currentUV, 0.0).rgb;
+	if (bResetHistory == 1)
+	{
+		fragColor = vec4(current, 1.0);
+		return;
+	}
+
+	/* Neighborhood clamping(3x3) in render resolution */
+	vec3 neighborMin = current;
+	vec3 neighborMax = current;
+	for (int y = -1; y <= 1; ++y)
+	{
+		for (int x = -1; x <= 1; ++x)
+		{
+			vec2 neighborUV = clamp(currentUV + (vec2(x, y) * texelSize), vec2(0.0), maxUV);
+			vec3 neighbor = textureLod(currentColor, neighborUV, 0.0).rgb;
+			neighborMin = min(neighborMin, neighbor);
+			neighborMax = max(neighborMax, neighbor);
+		}
+	}
+
+	/* Reprojection(Camera motion only) */
+	float depth = textureLod(currentDepth, currentUV, 0.0).r;
+	vec4 worldPos = invViewProj * vec4((texcoord * 2.0) - 1.0, (depth * 2.0) - 1.0, 1.0);
+	worldPos /= worldPos.w;
+
+	vec4 prevClipPos = prevViewProj * worldPos;
+	vec2 prevUV = ((prevClipPos.xy / prevClipPos.w) * 0.5) + 0.5;
+	if (any(lessThan(prevUV, vec2(0.0))) || any(greaterThan(prevUV, vec2(1.0))))
+	{
+		fragColor = vec4(current, 1.0);
+		return;
+	}
+
+	vec3 history = textureLod(historyColor, prevUV, 0.0).rgb;
+	history = clamp(history, neighborMin, neighborMax);
+
+	fragColor = vec4(mix(current, history, historyWeight), 1.0);
+}
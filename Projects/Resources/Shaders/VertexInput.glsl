@@ -0,0 +1,53 @@
+/*
+* Vertex attributes of GeometryBuffer; must match with its vertex format.
+* PACKED_VERTEX selects VertexPacked of Vertex.h. DrawData.glsl has to be included before.
+*/
+#ifdef PACKED_VERTEX
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexcoord;
+layout(location = 2) in vec2 aNormal;
+layout(location = 3) in vec2 aTangent;
+#else
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexcoord;
+layout(location = 2) in vec3 aNormal;
+layout(location = 3) in vec3 aTangent;
+#endif
+layout(location = 4) in uint aDrawIndex;
+
+vec3 DecodeOctahedral(vec2 encoded)
+{
+	vec3 vector = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float fold = max(-vector.z, 0.0);
+	vector.x += (vector.x >= 0.0) ? -fold : fold;
+	vector.y += (vector.y >= 0.0) ? -fold : fold;
+	return normalize(vector);
+}
+
+vec3 GetLocalPosition()
+{
+#ifdef PACKED_VERTEX
+	return draws[aDrawIndex].PositionOffset + aPos * draws[aDrawIndex].PositionScale;
+#else
+	return aPos;
+#endif
+}
+
+vec3 GetLocalNormal()
+{
+#ifdef PACKED_VERTEX
+	return DecodeOctahedral(aNormal);
+#else
+	return aNormal;
+#endif
+}
+
+/* Zero tangent is not representable in packed format; it decodes to +Z */
+vec3 GetLocalTangent()
+{
+#ifdef PACKED_VERTEX
+	return DecodeOctahedral(aTangent);
+#else
+	return aTangent;
+#endif
+}
@@ -1,12 +1,8 @@
 #version 450 core
-layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec2 aTexcoord;
-layout(location = 2) in vec3 aNormal;
-layout(location = 3) in vec3 aTangent;
+#include "DrawData.glsl"
+#include "VertexInput.glsl"
 
-uniform mat4 worldMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 projMatrix;
+#include "Constants.glsl"
 
 out vec3 worldPosGeom;
 out vec3 worldNormalGeom;
@@ -16,19 +12,20 @@ out mat3 tnbGeom;
 
 void main()
 {
-	vec4 worldPosition = worldMatrix * vec4(aPos, 1.0);
+	mat4 worldMatrix = draws[aDrawIndex].WorldMatrix;
+	vec4 worldPosition = worldMatrix * vec4(GetLocalPosition(), 1.0);
 	worldPosGeom = worldPosition.xyz;
 
 	mat3 normalMatrix = mat3(transpose(inverse(worldMatrix)));
-	vec3 normal = normalize(normalMatrix * aNormal.xyz);
+	vec3 normal = normalize(normalMatrix * GetLocalNormal());
 	worldNormalGeom = normal;
 
 	const float epsilon = 0.0001;
 	vec3 tangent = vec3(0.0f);
 	vec3 bitangent = vec3(0.0f);
-	if (length(aTangent) - epsilon > 0.0)
+	if (length(GetLocalTangent()) - epsilon > 0.0)
 	{
-		tangent = normalize(normalMatrix * aTangent.xyz).xyz;
+		tangent = normalize(normalMatrix * GetLocalTangent()).xyz;
 		tangent = normalize(tangent - dot(tangent, normal) * normal); // Gram-Schmit 
 		bitangent = normalize(cross(normal, tangent).xyz);
 	}
@@ -1,4 +1,12 @@
 #version 450 core
+#ifdef BINDLESS_MATERIALS
+#extension GL_ARB_bindless_texture : require
+#endif
+#ifdef EARLY_DEPTH_TEST
+// Depth already resolved by depth prepass, shade only visible fragments
+layout(early_fragment_tests) in;
+#endif
+
 in vec3 worldPosFrag;
 in vec4 shadowPosFrag;
 in vec2 texCoordsFrag;
@@ -8,40 +16,15 @@ in mat3 tnbFrag;
 
 out vec4 fragColor;
 
-struct DirectionalLight
-{
-   vec3 Direction;
-   vec3 Intensity;
-};
-
 const float PI = 3.14159265359;
 
-/* Material Uniforms */
-uniform sampler2D baseColorMap; // baseColorMap: sRGB
-uniform vec4 baseColorFactor;
-uniform sampler2D normalMap;
-uniform int bUseNormalMap;
-uniform sampler2D metallicRoughnessMap; // metallicRoughnessMap: Linear(B:Metallic, G:Roughness)
-uniform float metallicFactor;
-uniform float roughnessFactor;
-uniform sampler2D aoMap; // aoMap(Ambient Occlusion Map): Linear(R channel only)
-uniform sampler2D emissiveMap; // emissiveMap: sRGB
-uniform vec3 emissiveFactor;
-uniform float emissiveIntensity;
-uniform float ior = 1.0;
-uniform int isRefract = 0;
-
-uniform int bOverrideBaseColor = 0;
-uniform int bOverrideMetallicRoughness = 0;
-uniform int bOverrideEmissive = 0;
+#include "Material.glsl"
 
 /* Uniforms */
-uniform DirectionalLight light;
-uniform vec3 camPos;
-uniform sampler2DShadow shadowMap;
-uniform sampler3D voxelVolume;
-uniform float voxelGridWorldSize;
-uniform float voxelDim;
+#include "Constants.glsl"
+
+layout(binding = 5) uniform sampler2DShadow shadowMap;
+layout(binding = 6) uniform sampler3D voxelVolume;
 
 /* Brdf */
 vec3 FresnelSchlick(float cosTheta, vec3 F0)
@@ -148,21 +131,11 @@ vec3 ImportanceSampleGGX(vec2 Xi, float roughness, vec3 N)
 }
 
 /* Voxel Cone Tracing(VCT Params) */
-uniform float maxDist_VCT = 300.0f;
-uniform float step_VCT = 0.5f;
-uniform float alphaThreshold_VCT = 1.0f;
-uniform int specularSampleNum_VCT = 4;
+/* Rest of params are in VoxelConstants, feature toggles are permutation defines */
 uniform float attenuationFactor_VCT = 0.1f;
-uniform float initialStep_VCT = 6.5f;
 uniform float indirectDiffusePower_VCT = 4.0f;
 uniform float indirectSpecularPower_VCT = 2.0f;
 
-uniform int enableDirectDiffuse = 1;
-uniform int enableIndirectDiffuse = 1;
-uniform int enableDirectSpecular = 1;
-uniform int enableIndirectSpecular = 1;
-uniform int debugAmbientOcclusion = 0;
-
 mat3 tangentToWorld;
 const int NumOfCones = 6;
 vec3 coneDirections[6] = vec3[](
@@ -334,18 +307,19 @@ vec3 IndirectSpecularDir(const uint numSamples, float roughness, vec3 N, vec3 V)
 
 void main()
 {
+	LoadMaterial();
 	float visibility = texture(shadowMap, vec3(shadowPosFrag.xy, (shadowPosFrag.z - 0.0005f) / (shadowPosFrag.w)));
 	vec4 albedo = baseColorFactor;
 	if (bOverrideBaseColor != 1)
 	{
-		albedo = texture(baseColorMap, texCoordsFrag).rgba;
+		albedo = SampleMaterialTexture(BaseColorTexture, texCoordsFrag).rgba;
 		albedo = vec4(pow(albedo.rgb, vec3(2.2)), albedo.a);
 	}
 
 	vec3 emissive = emissiveFactor;
 	if (bOverrideEmissive != 1)
 	{
-		vec4 emissiveColor = texture(emissiveMap, texCoordsFrag).rgba;
+		vec4 emissiveColor = SampleMaterialTexture(EmissiveTexture, texCoordsFrag).rgba;
 		emissive = pow(emissiveColor.rgb, vec3(2.2));
 		if (emissiveColor.a < 1.0)
 		{
@@ -361,20 +335,20 @@ void main()
 
 	tangentToWorld = tnbFrag;
 
-	float ao = texture(aoMap, texCoordsFrag).r;
+	float ao = SampleMaterialTexture(AOTexture, texCoordsFrag).r;
 
 	float metallic = metallicFactor;
 	float roughness = roughnessFactor;
 	if (bOverrideMetallicRoughness != 1)
 	{
-		metallic = texture(metallicRoughnessMap, texCoordsFrag).b;
-		roughness = texture(metallicRoughnessMap, texCoordsFrag).g;
+		metallic = SampleMaterialTexture(MetallicRoughnessTexture, texCoordsFrag).b;
+		roughness = SampleMaterialTexture(MetallicRoughnessTexture, texCoordsFrag).g;
 	}
 
 	vec3 normal = normalize(worldNormalFrag);
 	if (bUseNormalMap == 1)
 	{
-		normal = texture(normalMap, texCoordsFrag).rgb;
+		normal = SampleMaterialTexture(NormalTexture, texCoordsFrag).rgb;
 		normal = normalize(normal * 2.0 - 1.0);
 		normal = normalize(tbnFrag * normal);
 	}
@@ -407,21 +381,32 @@ void main()
 	//vec3 F_indirect = F_reflect;
 	//vec3 F_indirect = (FresnelSchlickRoughness(max(dot(N, V), 0.0f), F0, roughness)+F_reflect)/2.0;
 	vec3 F_indirect = FresnelSchlickRoughness(max(dot(N, V), 0.0f), F0, roughness);
+#ifdef ENABLE_INDIRECT_SPECULAR
 	vec3 indirectSpecular = indirectSpecularPower_VCT * IndirectSpecular(specularSampleNum_VCT, roughness, N, V, F_indirect);
+#else
+	vec3 indirectSpecular = vec3(0.0f);
+#endif
 	vec3 kS_indirect = F_indirect;
 	vec3 kD_indirect = vec3(1.0) - kS_indirect;
 	kD_indirect *= (1.0-metallic);
 
 	/* Indirect Diffuse */
 	float occlusion = 0.0f;
-	vec3 indirectDiffuse = indirectDiffusePower_VCT * IndirectDiffuse(N, occlusion).rgb;
+	vec3 indirectDiffuse = vec3(0.0f);
+#if defined(ENABLE_INDIRECT_DIFFUSE) || defined(DEBUG_AMBIENT_OCCLUSION)
+	vec3 tracedDiffuse = indirectDiffusePower_VCT * IndirectDiffuse(N, occlusion).rgb;
 	occlusion = 2.0f * min(1.0, 1.5 * occlusion);
-	indirectDiffuse =  occlusion * (kD_indirect * indirectDiffuse * (albedo.rgb/PI));
-
-	directDiffuse = (enableDirectDiffuse == 1) ? directDiffuse : vec3(0.0f);
-	indirectDiffuse = (enableIndirectDiffuse == 1) ? indirectDiffuse : vec3(0.0f);
-	directSpecular = (enableDirectSpecular == 1) ? directSpecular : vec3(0.0f);
-	indirectSpecular = (enableIndirectSpecular == 1) ? indirectSpecular : vec3(0.0f);
+#ifdef ENABLE_INDIRECT_DIFFUSE
+	indirectDiffuse = occlusion * (kD_indirect * tracedDiffuse * (albedo.rgb/PI));
+#endif
+#endif
+
+#ifndef ENABLE_DIRECT_DIFFUSE
+	directDiffuse = vec3(0.0f);
+#endif
+#ifndef ENABLE_DIRECT_SPECULAR
+	directSpecular = vec3(0.0f);
+#endif
 
 	vec3 directLight = (directDiffuse + directSpecular) * light.Intensity * NdotL * visibility;
 	vec3 indirectLight = (indirectDiffuse+indirectSpecular);
@@ -436,7 +421,11 @@ void main()
 	}
 	else
 	{
-		fragColor = (debugAmbientOcclusion == 1) ? vec4(vec3(occlusion), 1.0f) : vec4(emissive + directLight + indirectLight, albedo.a);
+#ifdef DEBUG_AMBIENT_OCCLUSION
+		fragColor = vec4(vec3(occlusion), 1.0f);
+#else
+		fragColor = vec4(emissive + directLight + indirectLight, albedo.a);
+#endif
 	}
 
 	fragColor.xyz = fragColor.xyz/(fragColor.xyz+vec3(1.0));
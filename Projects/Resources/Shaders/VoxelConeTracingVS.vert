@@ -1,15 +1,10 @@
 #version 450 core
-layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec2 aTexcoord;
-layout(location = 2) in vec3 aNormal;
-layout(location = 3) in vec3 aTangent;
+#include "DrawData.glsl"
+#include "VertexInput.glsl"
 
-uniform mat4 worldMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 projMatrix;
-uniform mat4 shadowViewMat;
-uniform mat4 shadowProjMat;
+#include "Constants.glsl"
 
+flat out uint materialIndexFrag;
 out vec3 worldPosFrag;
 out vec4 shadowPosFrag;
 out vec2 texCoordsFrag;
@@ -17,17 +12,21 @@ out vec3 worldNormalFrag;
 out mat3 tbnFrag;
 out mat3 tnbFrag;
 
+invariant gl_Position;
+
 void main()
 {
-	vec4 worldPosition = worldMatrix * vec4(aPos, 1.0);
+	mat4 worldMatrix = draws[aDrawIndex].WorldMatrix;
+	materialIndexFrag = draws[aDrawIndex].MaterialIndex;
+	vec4 worldPosition = worldMatrix * vec4(GetLocalPosition(), 1.0);
 	worldPosFrag = worldPosition.xyz;
 	texCoordsFrag = aTexcoord;
 
 	mat3 normalMatrix = mat3(transpose(inverse(worldMatrix)));
-	vec3 normal = normalize(normalMatrix * aNormal.xyz);
+	vec3 normal = normalize(normalMatrix * GetLocalNormal());
 	worldNormalFrag = normal;
 
-	vec3 tangent = normalize(normalMatrix * aTangent.xyz).xyz;
+	vec3 tangent = normalize(normalMatrix * GetLocalTangent()).xyz;
 	tangent = normalize(tangent - dot(tangent, normal) * normal); // Gram-Schmit 
 	vec3 bitangent = normalize(cross(normal, tangent).xyz);
 
@@ -3,12 +3,14 @@
 layout(triangles) in;
 layout(triangle_strip, max_vertices = 3) out;
 
+flat in uint materialIndexGeom[];
 in vec3 worldPosGeom[];
 in vec4 shadowPosGeom[];
 in vec2 texCoordsGeom[];
 in vec3 worldNormalGeom[];
 in mat3 tbnGeom[];
 
+flat out uint materialIndexFrag;
 out vec3 worldPosFrag;
 out vec4 shadowPosFrag;
 out vec2 texCoordsFrag;
@@ -17,9 +19,7 @@ out mat3 tbnFrag;
 out mat4 projFrag;
 out flat int axisFrag;
 
-uniform mat4 projXAxis;
-uniform mat4 projYAxis;
-uniform mat4 projZAxis;
+#include "Constants.glsl"
 
 void main()
 {
@@ -33,6 +33,7 @@ void main()
 
    for (int idx = 0; idx < gl_in.length(); ++idx)
    {
+      materialIndexFrag = materialIndexGeom[idx];
       worldPosFrag = worldPosGeom[idx];
       shadowPosFrag = shadowPosGeom[idx];
       texCoordsFrag = texCoordsGeom[idx];
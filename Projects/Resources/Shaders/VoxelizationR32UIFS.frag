@@ -1,12 +1,9 @@
 #version 450 core
+#ifdef BINDLESS_MATERIALS
+#extension GL_ARB_bindless_texture : require
+#endif
 const float PI = 3.14159265359;
 
-struct DirectionalLight
-{
-   vec3 Direction;
-   vec3 Intensity;
-};
-
 /* Input from previous shader stage */
 in vec3 worldPosFrag;
 in vec4 shadowPosFrag;
@@ -16,28 +13,13 @@ in mat3 tbnFrag;
 in mat4 projFrag;
 in flat int axisFrag;
 
-/* Material Uniforms */
-uniform sampler2D baseColorMap; // baseColorMap: sRGB
-uniform vec4 baseColorFactor;
-uniform sampler2D normalMap;
-uniform int bUseNormalMap;
-uniform sampler2D metallicRoughnessMap; // metallicRoughnessMap: Linear(B:Metallic, G:Roughness)
-uniform float metallicFactor;
-uniform float roughnessFactor;
-uniform sampler2D aoMap; // aoMap(Ambient Occlusion Map): Linear(R channel only)
-uniform sampler2D emissiveMap; // emissiveMap: sRGB
-uniform vec3 emissiveFactor;
-uniform float emissiveIntensity;
-
-uniform int bOverrideBaseColor = 0;
-uniform int bOverrideMetallicRoughness = 0;
-uniform int bOverrideEmissive = 0;
+#include "Material.glsl"
 
 uniform sampler2DShadow shadowMap;
 
 /* Uniforms */
-uniform DirectionalLight light;
-uniform vec3 camPos;
+#include "Constants.glsl"
+
 layout(r32ui) uniform volatile coherent uimage3D voxelVolume;
 
 /* Predefined Functions */
@@ -84,14 +66,14 @@ vec4 LambertianDiffuse()
 	vec4 albedo = baseColorFactor;
 	if (bOverrideBaseColor != 1)
 	{
-		albedo = texture(baseColorMap, texCoordsFrag).rgba;
+		albedo = SampleMaterialTexture(BaseColorTexture, texCoordsFrag).rgba;
 		albedo.xyz = pow(albedo.xyz, vec3(2.2));
 	}
 	
 	vec3 emissive = emissiveFactor;
 	if (bOverrideEmissive != 1)
 	{
-		vec4 emissiveColor = texture(emissiveMap, texCoordsFrag).rgba;
+		vec4 emissiveColor = SampleMaterialTexture(EmissiveTexture, texCoordsFrag).rgba;
 		emissive = pow(emissiveColor.rgb, vec3(2.2));
 		if (emissiveColor.a < 1.0)
 		{
@@ -103,7 +85,7 @@ vec4 LambertianDiffuse()
 	vec3 normal = worldNormalFrag;
 	if (bUseNormalMap == 1)
 	{
-		normal = texture(normalMap, texCoordsFrag).rgb;
+		normal = SampleMaterialTexture(NormalTexture, texCoordsFrag).rgb;
 		normal = normalize(normal * 2.0 - 1.0);
 		normal = normalize(tbnFrag * normal);
 	}
@@ -117,6 +99,7 @@ vec4 LambertianDiffuse()
 
 void main()
 {
+	LoadMaterial();
 	vec4 color = LambertianDiffuse();
 	if (color.a < 0.1)
 	{
@@ -1,13 +1,10 @@
 #version 450 core
-layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec2 aTexcoord;
-layout(location = 2) in vec3 aNormal;
-layout(location = 3) in vec3 aTangent;
+#include "DrawData.glsl"
+#include "VertexInput.glsl"
 
-uniform mat4 worldMatrix;
-uniform mat4 shadowViewMat;
-uniform mat4 shadowProjMat;
+#include "Constants.glsl"
 
+flat out uint materialIndexGeom;
 out vec3 worldPosGeom;
 out vec4 shadowPosGeom;
 out vec2 texCoordsGeom;
@@ -16,14 +13,16 @@ out mat3 tbnGeom;
 
 void main()
 {
-	vec4 worldPosition = worldMatrix * vec4(aPos, 1.0);
+	mat4 worldMatrix = draws[aDrawIndex].WorldMatrix;
+	materialIndexGeom = draws[aDrawIndex].MaterialIndex;
+	vec4 worldPosition = worldMatrix * vec4(GetLocalPosition(), 1.0);
 	worldPosGeom = worldPosition.xyz;
 	texCoordsGeom = aTexcoord;
 
-	vec3 normal = normalize(mat3(transpose(inverse(worldMatrix))) * aNormal.xyz);
+	vec3 normal = normalize(mat3(transpose(inverse(worldMatrix))) * GetLocalNormal());
 	worldNormalGeom = normal;
 
-	vec3 tangent = normalize(worldMatrix * vec4(aTangent, 0.0)).xyz;
+	vec3 tangent = normalize(worldMatrix * vec4(GetLocalTangent(), 0.0)).xyz;
 	tangent = normalize(tangent - dot(tangent, normal) * normal);
 	vec3 bitangent = normalize(cross(normal, tangent).xyz);
 
@@ -50,17 +50,22 @@ public:
 			(vertex.z > Max.z ? vertex.z : Max.z) };
 	}
 
+	/* Conservative bounds of transformed box; extent is projected onto each axis instead of transforming 8 corners */
 	void Transform(const glm::mat4& transformation)
 	{
-		Min = glm::vec3(transformation * glm::vec4(Min, 1.0));
-		Max = glm::vec3(transformation * glm::vec4(Max, 1.0));
+		*this = Transformed(transformation);
 	}
 
 	AABB Transformed(const glm::mat4& transformation) const
 	{
-		AABB newAABB = (*this);
-		newAABB.Transform(transformation);
-		return newAABB;
+		const glm::vec3 center = glm::vec3(transformation * glm::vec4((Min + Max) * 0.5f, 1.0f));
+		const glm::vec3 localExtent = (Max - Min) * 0.5f;
+		const glm::vec3 extent =
+			glm::abs(glm::vec3(transformation[0])) * localExtent.x +
+			glm::abs(glm::vec3(transformation[1])) * localExtent.y +
+			glm::abs(glm::vec3(transformation[2])) * localExtent.z;
+
+		return AABB(center - extent, center + extent);
 	}
 
 public:
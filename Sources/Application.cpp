@@ -1,16 +1,22 @@
 #include "Application.h"
+#include "JobSystem.h"
 #include "Renderer.h"
 #include "Scene.h"
+#include "TextureStreamer.h"
 #include "Viewport.h"
 
 #include <chrono>
 #include <iostream>
 
+/* Time main thread spends on queued jobs each frame */
+constexpr float MainThreadJobBudget = 4.0f; // ms
+
 Application::Application(const std::string& title, unsigned int width, unsigned int height, bool bFullscreen) :
 	m_bIsRunning(false),
 	m_title(title),
 	m_scene(nullptr),
 	m_renderer(nullptr),
+	m_jobSystem(nullptr),
 	m_windowWidth(width),
 	m_windowHeight(height),
    m_bFullScreen(bFullscreen)
@@ -24,10 +30,20 @@ Application::~Application()
 		delete m_renderer;
 		m_renderer = nullptr;
 	}
+
+	if (m_jobSystem != nullptr)
+	{
+		TextureStreamer::Shutdown();
+		delete m_jobSystem;
+		m_jobSystem = nullptr;
+	}
 }
 
 bool Application::InitBase()
 {
+	m_jobSystem = new JobSystem();
+	std::cout << "Job System : " << m_jobSystem->GetWorkerCount() << " workers" << std::endl;
+
 	m_renderer = new Renderer();
 
 	if (!m_renderer->Init(m_windowWidth, m_windowHeight))
@@ -36,6 +52,8 @@ bool Application::InitBase()
 		return false;
 	}
 
+	TextureStreamer::Init(m_jobSystem);
+
 	return true;
 }
 
@@ -118,11 +136,15 @@ int Application::Run()
 		auto begin = std::chrono::system_clock::now();
 		glfwPollEvents();
 
+		/* GL work queued by jobs; main thread owns the context */
+		m_jobSystem->ProcessMainThreadJobs(MainThreadJobBudget);
+
 		Update(deltaTime);
 
 		if (m_scene != nullptr)
 		{
 			m_scene->Update(deltaTime);
+			m_scene->UpdateBVH();
 			m_renderer->Render(m_scene);
 			m_scene->ResolveDirty();
 		}
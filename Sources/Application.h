@@ -4,6 +4,7 @@
 
 class Scene;
 class Renderer;
+class JobSystem;
 struct GLFWwindow;
 class Viewport;
 class Application
@@ -20,6 +21,7 @@ public:
 	void SetScene(Scene* scene) { m_scene = scene; }
 	Scene* GetScene() const { return m_scene; }
 	Renderer* GetRenderer() const { return m_renderer; }
+	JobSystem* GetJobSystem() const { return m_jobSystem; }
 	GLFWwindow* GetWindow() const { return m_window; }
 
 	unsigned int GetWidth() const { return m_windowWidth; }
@@ -48,6 +50,7 @@ private:
 
 	Scene* m_scene;
 	Renderer* m_renderer;
+	JobSystem* m_jobSystem;
 
 	unsigned int m_windowWidth;
 	unsigned int m_windowHeight;
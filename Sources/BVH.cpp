@@ -0,0 +1,403 @@
+#include "BVH.h"
+#include "Frustum.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+constexpr uint32_t BVHBinCount = 16;
+constexpr uint32_t BVHMaxLeafSize = 4;
+constexpr uint32_t BVHInvalidNode = std::numeric_limits<uint32_t>::max();
+/* Traversal cost relative to one primitive(bounds) test */
+constexpr float BVHTraversalCost = 1.0f;
+
+void BVH::Build(const std::vector<BVHPrimitive>& primitives)
+{
+	Clear();
+	if (primitives.empty())
+	{
+		return;
+	}
+
+	m_primitives = primitives;
+	m_primIndices.resize(primitives.size());
+	m_primLeaves.resize(primitives.size());
+	m_primitiveBounds.Resize(primitives.size());
+	for (uint32_t idx = 0; idx < primitives.size(); ++idx)
+	{
+		m_primIndices[idx] = idx;
+		m_primitiveBounds.Set(idx, primitives[idx].Bounds);
+	}
+
+	m_nodes.reserve(primitives.size() * 2);
+	Node root;
+	root.First = 0;
+	root.Count = static_cast<uint32_t>(primitives.size());
+	root.Parent = BVHInvalidNode;
+	m_nodes.push_back(root);
+	UpdateNodeBounds(0);
+	Subdivide(0);
+}
+
+void BVH::Clear()
+{
+	m_primitives.clear();
+	m_nodes.clear();
+	m_primIndices.clear();
+	m_primLeaves.clear();
+	m_primitiveBounds.Resize(0);
+}
+
+void BVH::UpdateNodeBounds(uint32_t nodeIdx)
+{
+	Node& node = m_nodes[nodeIdx];
+	node.Bounds = AABB();
+	for (uint32_t idx = 0; idx < node.Count; ++idx)
+	{
+		node.Bounds.Combine(m_primitives[m_primIndices[node.First + idx]].Bounds);
+	}
+}
+
+float BVH::SurfaceArea(const AABB& bounds)
+{
+	const glm::vec3 extent = glm::max(bounds.Max - bounds.Min, glm::vec3(0.0f));
+	return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+}
+
+void BVH::Subdivide(uint32_t nodeIdx)
+{
+	const uint32_t first = m_nodes[nodeIdx].First;
+	const uint32_t count = m_nodes[nodeIdx].Count;
+
+	auto makeLeaf = [&]()
+	{
+		for (uint32_t idx = 0; idx < count; ++idx)
+		{
+			m_primLeaves[m_primIndices[first + idx]] = nodeIdx;
+		}
+	};
+
+	if (count <= 1)
+	{
+		makeLeaf();
+		return;
+	}
+
+	// Bin by centroids, since mesh bounds of a scene overlap a lot
+	AABB centroidBounds;
+	for (uint32_t idx = 0; idx < count; ++idx)
+	{
+		const AABB& bounds = m_primitives[m_primIndices[first + idx]].Bounds;
+		const glm::vec3 centroid = (bounds.Min + bounds.Max) * 0.5f;
+		centroidBounds.UpdateMin(centroid);
+		centroidBounds.UpdateMax(centroid);
+	}
+
+	struct Bin
+	{
+		AABB Bounds;
+		uint32_t Count = 0;
+	};
+
+	float bestCost = std::numeric_limits<float>::max();
+	int bestAxis = -1;
+	uint32_t bestSplit = 0;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		const float axisMin = centroidBounds.Min[axis];
+		const float axisExtent = centroidBounds.Max[axis] - axisMin;
+		if (axisExtent <= 0.0f)
+		{
+			continue;
+		}
+
+		std::array<Bin, BVHBinCount> bins;
+		const float binScale = static_cast<float>(BVHBinCount) / axisExtent;
+		for (uint32_t idx = 0; idx < count; ++idx)
+		{
+			const AABB& bounds = m_primitives[m_primIndices[first + idx]].Bounds;
+			const float centroid = (bounds.Min[axis] + bounds.Max[axis]) * 0.5f;
+			const uint32_t binIdx = std::min(BVHBinCount - 1, static_cast<uint32_t>((centroid - axisMin) * binScale));
+			bins[binIdx].Bounds.Combine(bounds);
+			++bins[binIdx].Count;
+		}
+
+		// Sweep from both sides; cost of splitting after bin n = A(left) * N(left) + A(right) * N(right)
+		std::array<float, BVHBinCount - 1> leftArea;
+		std::array<uint32_t, BVHBinCount - 1> leftCount;
+		AABB leftBounds;
+		uint32_t leftSum = 0;
+		for (uint32_t split = 0; split < BVHBinCount - 1; ++split)
+		{
+			leftSum += bins[split].Count;
+			if (bins[split].Count > 0)
+			{
+				leftBounds.Combine(bins[split].Bounds);
+			}
+
+			leftArea[split] = (leftSum > 0) ? SurfaceArea(leftBounds) : 0.0f;
+			leftCount[split] = leftSum;
+		}
+
+		AABB rightBounds;
+		uint32_t rightSum = 0;
+		for (uint32_t split = BVHBinCount - 1; split > 0; --split)
+		{
+			rightSum += bins[split].Count;
+			if (bins[split].Count > 0)
+			{
+				rightBounds.Combine(bins[split].Bounds);
+			}
+
+			if (leftCount[split - 1] == 0 || rightSum == 0)
+			{
+				continue;
+			}
+
+			const float cost = leftArea[split - 1] * leftCount[split - 1] + SurfaceArea(rightBounds) * rightSum;
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = split;
+			}
+		}
+	}
+
+	// Relative to parent area; leaf costs one test per primitive
+	const float parentArea = std::max(SurfaceArea(m_nodes[nodeIdx].Bounds), std::numeric_limits<float>::min());
+	const float splitCost = BVHTraversalCost + bestCost / parentArea;
+	if (bestAxis < 0 || (count <= BVHMaxLeafSize && splitCost >= static_cast<float>(count)))
+	{
+		makeLeaf();
+		return;
+	}
+
+	const float axisMin = centroidBounds.Min[bestAxis];
+	const float binScale = static_cast<float>(BVHBinCount) / (centroidBounds.Max[bestAxis] - axisMin);
+	auto* const begin = m_primIndices.data() + first;
+	auto* const middle = std::partition(begin, begin + count, [&](uint32_t primIdx)
+	{
+		const AABB& bounds = m_primitives[primIdx].Bounds;
+		const float centroid = (bounds.Min[bestAxis] + bounds.Max[bestAxis]) * 0.5f;
+		return std::min(BVHBinCount - 1, static_cast<uint32_t>((centroid - axisMin) * binScale)) < bestSplit;
+	});
+
+	const uint32_t leftCount = static_cast<uint32_t>(middle - begin);
+	if (leftCount == 0 || leftCount == count)
+	{
+		makeLeaf();
+		return;
+	}
+
+	const uint32_t leftIdx = static_cast<uint32_t>(m_nodes.size());
+	Node left;
+	left.First = first;
+	left.Count = leftCount;
+	left.Parent = nodeIdx;
+	Node right;
+	right.First = first + leftCount;
+	right.Count = count - leftCount;
+	right.Parent = nodeIdx;
+	m_nodes.push_back(left);
+	m_nodes.push_back(right);
+
+	m_nodes[nodeIdx].First = leftIdx;
+	m_nodes[nodeIdx].Count = 0;
+
+	UpdateNodeBounds(leftIdx);
+	UpdateNodeBounds(leftIdx + 1);
+	Subdivide(leftIdx);
+	Subdivide(leftIdx + 1);
+}
+
+void BVH::Refit(uint32_t primitive, const AABB& bounds)
+{
+	if (primitive >= m_primitives.size())
+	{
+		return;
+	}
+
+	m_primitives[primitive].Bounds = bounds;
+	m_primitiveBounds.Set(primitive, bounds);
+	for (uint32_t nodeIdx = m_primLeaves[primitive]; nodeIdx != BVHInvalidNode; nodeIdx = m_nodes[nodeIdx].Parent)
+	{
+		Node& node = m_nodes[nodeIdx];
+		AABB newBounds;
+		if (node.Count > 0)
+		{
+			for (uint32_t idx = 0; idx < node.Count; ++idx)
+			{
+				newBounds.Combine(m_primitives[m_primIndices[node.First + idx]].Bounds);
+			}
+		}
+		else
+		{
+			newBounds = m_nodes[node.First].Bounds.Combined(m_nodes[node.First + 1].Bounds);
+		}
+
+		// Ancestors above already enclose these bounds
+		if (newBounds.Min == node.Bounds.Min && newBounds.Max == node.Bounds.Max)
+		{
+			break;
+		}
+
+		node.Bounds = newBounds;
+	}
+}
+
+void BVH::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& result) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	std::vector<uint32_t> stack;
+	stack.push_back(0);
+	while (!stack.empty())
+	{
+		const Node& node = m_nodes[stack.back()];
+		stack.pop_back();
+		if (!frustum.IsVisible(node.Bounds))
+		{
+			continue;
+		}
+
+		if (node.Count > 0)
+		{
+			for (uint32_t idx = 0; idx < node.Count; ++idx)
+			{
+				const uint32_t primIdx = m_primIndices[node.First + idx];
+				if (node.Count == 1 || frustum.IsVisible(m_primitives[primIdx].Bounds))
+				{
+					result.push_back(primIdx);
+				}
+			}
+		}
+		else
+		{
+			stack.push_back(node.First + 1);
+			stack.push_back(node.First);
+		}
+	}
+}
+
+void BVH::QueryOverlap(const AABB& bounds, std::vector<uint32_t>& result) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	auto overlaps = [](const AABB& lhs, const AABB& rhs)
+	{
+		return glm::all(glm::lessThanEqual(lhs.Min, rhs.Max)) && glm::all(glm::lessThanEqual(rhs.Min, lhs.Max));
+	};
+
+	std::vector<uint32_t> stack;
+	stack.push_back(0);
+	while (!stack.empty())
+	{
+		const Node& node = m_nodes[stack.back()];
+		stack.pop_back();
+		if (!overlaps(node.Bounds, bounds))
+		{
+			continue;
+		}
+
+		if (node.Count > 0)
+		{
+			for (uint32_t idx = 0; idx < node.Count; ++idx)
+			{
+				const uint32_t primIdx = m_primIndices[node.First + idx];
+				if (overlaps(m_primitives[primIdx].Bounds, bounds))
+				{
+					result.push_back(primIdx);
+				}
+			}
+		}
+		else
+		{
+			stack.push_back(node.First + 1);
+			stack.push_back(node.First);
+		}
+	}
+}
+
+bool BVH::IntersectRay(const AABB& bounds, const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance, float& distance)
+{
+	// Slab test
+	const glm::vec3 t0 = (bounds.Min - origin) * invDirection;
+	const glm::vec3 t1 = (bounds.Max - origin) * invDirection;
+	const glm::vec3 tNear = glm::min(t0, t1);
+	const glm::vec3 tFar = glm::max(t0, t1);
+	const float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+	const float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+	distance = enter;
+	return enter <= exit;
+}
+
+bool BVH::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, BVHRayHit& hit) const
+{
+	if (m_nodes.empty())
+	{
+		return false;
+	}
+
+	const glm::vec3 invDirection = 1.0f / direction;
+	bool bHit = false;
+	float nearest = maxDistance;
+
+	float distance = 0.0f;
+	std::vector<uint32_t> stack;
+	if (IntersectRay(m_nodes[0].Bounds, origin, invDirection, nearest, distance))
+	{
+		stack.push_back(0);
+	}
+
+	while (!stack.empty())
+	{
+		const Node& node = m_nodes[stack.back()];
+		stack.pop_back();
+		if (!IntersectRay(node.Bounds, origin, invDirection, nearest, distance))
+		{
+			continue;
+		}
+
+		if (node.Count > 0)
+		{
+			for (uint32_t idx = 0; idx < node.Count; ++idx)
+			{
+				const uint32_t primIdx = m_primIndices[node.First + idx];
+				if (IntersectRay(m_primitives[primIdx].Bounds, origin, invDirection, nearest, distance))
+				{
+					bHit = true;
+					nearest = distance;
+					hit.Primitive = primIdx;
+					hit.Distance = distance;
+				}
+			}
+		}
+		else
+		{
+			// Visit nearer child first, so farther one is likely rejected by shortened ray
+			float leftDistance = 0.0f;
+			float rightDistance = 0.0f;
+			const bool bLeft = IntersectRay(m_nodes[node.First].Bounds, origin, invDirection, nearest, leftDistance);
+			const bool bRight = IntersectRay(m_nodes[node.First + 1].Bounds, origin, invDirection, nearest, rightDistance);
+			if (bLeft && bRight)
+			{
+				stack.push_back((leftDistance < rightDistance) ? node.First + 1 : node.First);
+				stack.push_back((leftDistance < rightDistance) ? node.First : node.First + 1);
+			}
+			else if (bLeft || bRight)
+			{
+				stack.push_back(bLeft ? node.First : node.First + 1);
+			}
+		}
+	}
+
+	return bHit;
+}
+
@@ -0,0 +1,77 @@
+#pragma once
+#include "AABB.h"
+#include "FrustumCuller.h"
+
+#include <cstdint>
+#include <vector>
+
+class Model;
+class Mesh;
+class Frustum;
+
+/* Mesh of a model, bounded in world space */
+struct BVHPrimitive
+{
+	Model* Owner = nullptr;
+	Mesh* PrimMesh = nullptr;
+	AABB Bounds;
+};
+
+struct BVHRayHit
+{
+	uint32_t Primitive = 0;
+	/* Distance along ray where it enters bounds of primitive */
+	float Distance = 0.0f;
+};
+
+/*
+* Bounding volume hierarchy over world space bounds of scene meshes.
+* Built top-down with binned surface area heuristic; moved primitives are refitted in place,
+* walking up only from their own leaves. Primitive indices never change after build.
+**/
+class BVH
+{
+public:
+	void Build(const std::vector<BVHPrimitive>& primitives);
+	void Clear();
+
+	/* Updates bounds of primitive and every ancestor whose bounds changed */
+	void Refit(uint32_t primitive, const AABB& bounds);
+
+	/* Appends primitives whose bounds intersect with query */
+	void QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& result) const;
+	void QueryOverlap(const AABB& bounds, std::vector<uint32_t>& result) const;
+	/* Nearest primitive whose bounds are hit by ray; false if nothing is hit within maxDistance */
+	bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, BVHRayHit& hit) const;
+
+	const BVHPrimitive& GetPrimitive(uint32_t idx) const { return m_primitives[idx]; }
+	/* Bounds of every primitive in SoA layout, indexed by primitive; for flat SIMD culling */
+	const AABBSoA& GetPrimitiveBounds() const { return m_primitiveBounds; }
+	size_t GetPrimitiveCount() const { return m_primitives.size(); }
+	size_t GetNodeCount() const { return m_nodes.size(); }
+
+
+private:
+	/* Leaf if Count > 0 : m_primIndices[First, First+Count), otherwise children are First and First+1 */
+	struct Node
+	{
+		AABB Bounds;
+		uint32_t First = 0;
+		uint32_t Count = 0;
+		uint32_t Parent = 0;
+	};
+
+	void Subdivide(uint32_t nodeIdx);
+	void UpdateNodeBounds(uint32_t nodeIdx);
+	static float SurfaceArea(const AABB& bounds);
+	static bool IntersectRay(const AABB& bounds, const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance, float& distance);
+
+private:
+	std::vector<BVHPrimitive> m_primitives;
+	AABBSoA m_primitiveBounds;
+	std::vector<Node> m_nodes;
+	std::vector<uint32_t> m_primIndices;
+	/* Leaf node which holds each primitive */
+	std::vector<uint32_t> m_primLeaves;
+
+};
@@ -30,6 +30,14 @@ glm::mat4 Camera::GetViewMatrix() const
 }
 
 glm::mat4 Camera::GetProjMatrix() const
+{
+	glm::mat4 proj = GetUnjitteredProjMatrix();
+	proj[2][0] -= m_jitter.x;
+	proj[2][1] -= m_jitter.y;
+	return proj;
+}
+
+glm::mat4 Camera::GetUnjitteredProjMatrix() const
 {
 	float width = static_cast<float>(m_viewport->GetWidth());
 	float height = static_cast<float>(m_viewport->GetHeight());
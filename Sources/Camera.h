@@ -1,6 +1,7 @@
 #pragma once
 #include "Object.h"
 
+#include "glm/vec2.hpp"
 #include "glm/vec3.hpp"
 
 constexpr float DEFAULT_FOV = 45.0f;
@@ -30,6 +31,11 @@ public:
 
 	glm::mat4 GetViewMatrix() const;
 	glm::mat4 GetProjMatrix() const;
+	glm::mat4 GetUnjitteredProjMatrix() const;
+
+	// Sub-pixel offset in NDC which applied to projection matrix(for temporal upscaling)
+	void SetJitter(const glm::vec2& jitter) { m_jitter = jitter; }
+	glm::vec2 GetJitter() const { return m_jitter; }
 
 	void SetLookAt(const glm::vec3& newLookPos) { m_lookAt = newLookPos; }
 	glm::vec3 GetLookAt() const { return m_lookAt; }
@@ -41,6 +47,7 @@ private:
 
 	glm::vec3 m_lookAt;
 	glm::vec3 m_clearColor;
+	glm::vec2 m_jitter = glm::vec2(0.0f);
 
 	Viewport* m_viewport;
 
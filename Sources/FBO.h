@@ -1,21 +1,21 @@
 ﻿#pragma once
 #include "Rendering.h"
+#include "GLStateCache.h"
 
 class FBO
 {
 public:
-   FBO(unsigned int width, unsigned int height, GLenum magFilter = GL_NEAREST, GLenum minFilter = GL_NEAREST, GLint internalFormat = GL_RGB16F, GLint format = GL_FLOAT, GLint wrap = GL_REPEAT) :
+   FBO(unsigned int width, unsigned int height, GLenum magFilter = GL_NEAREST, GLenum minFilter = GL_NEAREST, GLint internalFormat = GL_RGB16F, GLint format = GL_FLOAT, GLint wrap = GL_REPEAT, bool bSampleableDepth = false) :
    m_width(width),
    m_height(height)
    {
-      GLint prevFB = 0;
-      glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFB);
+      const GLuint prevFB = GLStateCache::GetBoundFramebuffer(GL_DRAW_FRAMEBUFFER);
 
       glGenFramebuffers(1, &m_fbo);
-      glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+      GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, m_fbo);
 
       glGenTextures(1, &m_colorBuffer);
-      glBindTexture(GL_TEXTURE_2D, m_colorBuffer);
+      GLStateCache::BindTexture(GL_TEXTURE_2D, 0, m_colorBuffer);
 
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
@@ -25,55 +25,81 @@ public:
       glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, GL_RGBA, format, nullptr);
       glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorBuffer, 0);
 
-      glGenRenderbuffers(1, &m_rbo);
-      glBindRenderbuffer(GL_RENDERBUFFER, m_rbo);
-      glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
-      glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_rbo);
+      if (bSampleableDepth)
+      {
+         // Depth-Stencil format to keep compatible with default framebuffer on depth blit
+         glGenTextures(1, &m_depthBuffer);
+         GLStateCache::BindTexture(GL_TEXTURE_2D, 0, m_depthBuffer);
+
+         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+         glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, width, height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
+         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_depthBuffer, 0);
+      }
+      else
+      {
+         glGenRenderbuffers(1, &m_rbo);
+         glBindRenderbuffer(GL_RENDERBUFFER, m_rbo);
+         glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+         glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_rbo);
+      }
 
       glBindRenderbuffer(GL_RENDERBUFFER, 0);
-      glBindFramebuffer(GL_FRAMEBUFFER, prevFB);
+      GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, prevFB);
    }
 
    ~FBO()
    {
+      GLStateCache::OnTextureDeleted(m_colorBuffer);
+      GLStateCache::OnTextureDeleted(m_depthBuffer);
+      GLStateCache::OnFramebufferDeleted(m_fbo);
       glDeleteTextures(1, &m_colorBuffer);
+      glDeleteTextures(1, &m_depthBuffer);
+      glDeleteRenderbuffers(1, &m_rbo);
       glDeleteFramebuffers(1, &m_fbo);
    }
 
    void Clear()
    {
-      GLint prevFB = 0;
-      glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFB);
+      const GLuint prevFB = GLStateCache::GetBoundFramebuffer(GL_DRAW_FRAMEBUFFER);
 
-      glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+      GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, m_fbo);
       glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-      glBindFramebuffer(GL_FRAMEBUFFER, prevFB);
+      GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, prevFB);
    }
 
    void Bind()
    {
-      glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+      GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, m_fbo);
       glDrawBuffer(GL_COLOR_ATTACHMENT0);
    }
 
    void Unbind()
    {
-      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+      GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
    }
 
    void BindAsTexture(unsigned int slot)
    {
-      glActiveTexture(GL_TEXTURE0 + slot);
-      glBindTexture(GL_TEXTURE_2D, m_colorBuffer);
+      GLStateCache::BindTexture(GL_TEXTURE_2D, slot, m_colorBuffer);
    }
 
    void UnbindAsTexture(unsigned int slot)
    {
-      glActiveTexture(GL_TEXTURE0 + slot);
-      glBindTexture(GL_TEXTURE_2D, 0);
+      GLStateCache::BindTexture(GL_TEXTURE_2D, slot, 0);
+   }
+
+   void BindDepthAsTexture(unsigned int slot)
+   {
+      GLStateCache::BindTexture(GL_TEXTURE_2D, slot, m_depthBuffer);
    }
 
    unsigned int GetID() const { return m_fbo; }
+   /* 0 unless constructed with sampleable depth */
+   unsigned int GetDepthTexture() const { return m_depthBuffer; }
 
    unsigned int GetWidth() const { return m_width; }
    unsigned int GetHeight() const { return m_height; }
@@ -84,5 +110,6 @@ private:
    unsigned int m_fbo = 0;
    unsigned int m_colorBuffer = 0;
    unsigned int m_rbo = 0;
+   unsigned int m_depthBuffer = 0;
 
 };
@@ -45,7 +45,7 @@ public:
       m_points[7] = Intersection<Right, Top, Far>(crosses);
    }
 
-   bool IsVisible(const AABB& b)
+   bool IsVisible(const AABB& b) const
    {
       for (int idx = 0; idx < Count; ++idx)
       {
@@ -73,6 +73,9 @@ public:
       return true;
    }
 
+   /* Left, Right, Bottom, Top, Near, Far; xyz is inward normal(not normalized) */
+   const std::array<glm::vec4, 6>& GetPlanes() const { return m_planes; }
+
    static void NormalizePlane(glm::vec4& p)
    {
       const float mag = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
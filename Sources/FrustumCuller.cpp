@@ -0,0 +1,343 @@
+#include "FrustumCuller.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SIMD_TARGET(isa)
+#else
+#include <cpuid.h>
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+void AABBSoA::Resize(size_t count)
+{
+	MinX.resize(count);
+	MinY.resize(count);
+	MinZ.resize(count);
+	MaxX.resize(count);
+	MaxY.resize(count);
+	MaxZ.resize(count);
+}
+
+void AABBSoA::Set(size_t idx, const AABB& bounds)
+{
+	MinX[idx] = bounds.Min.x;
+	MinY[idx] = bounds.Min.y;
+	MinZ[idx] = bounds.Min.z;
+	MaxX[idx] = bounds.Max.x;
+	MaxY[idx] = bounds.Max.y;
+	MaxZ[idx] = bounds.Max.z;
+}
+
+static void CPUID(int leaf, int subLeaf, int registers[4])
+{
+#if defined(_MSC_VER)
+	__cpuidex(registers, leaf, subLeaf);
+#else
+	unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+	__cpuid_count(leaf, subLeaf, eax, ebx, ecx, edx);
+	registers[0] = static_cast<int>(eax);
+	registers[1] = static_cast<int>(ebx);
+	registers[2] = static_cast<int>(ecx);
+	registers[3] = static_cast<int>(edx);
+#endif
+}
+
+static uint64_t XGetBV()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	uint32_t low = 0, high = 0;
+	__asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+	return (static_cast<uint64_t>(high) << 32) | low;
+#endif
+}
+
+static size_t CullRange(const std::array<glm::vec4, 6>& planes, const AABBSoA& boxes, size_t begin, size_t end, uint32_t* visibleIndices)
+{
+	size_t numVisible = 0;
+	for (size_t idx = begin; idx < end; ++idx)
+	{
+		bool bVisible = true;
+		for (const glm::vec4& plane : planes)
+		{
+			const float distance =
+				std::max(plane.x * boxes.MinX[idx], plane.x * boxes.MaxX[idx]) +
+				std::max(plane.y * boxes.MinY[idx], plane.y * boxes.MaxY[idx]) +
+				std::max(plane.z * boxes.MinZ[idx], plane.z * boxes.MaxZ[idx]) + plane.w;
+			if (distance < 0.0f)
+			{
+				bVisible = false;
+				break;
+			}
+		}
+
+		if (bVisible)
+		{
+			visibleIndices[numVisible++] = static_cast<uint32_t>(idx);
+		}
+	}
+
+	return numVisible;
+}
+
+/* Appends base + index of every set bit */
+static size_t CompactMask(uint32_t mask, size_t base, uint32_t* visibleIndices)
+{
+	size_t numVisible = 0;
+	while (mask != 0)
+	{
+		visibleIndices[numVisible++] = static_cast<uint32_t>(base + std::countr_zero(mask));
+		mask &= mask - 1;
+	}
+
+	return numVisible;
+}
+
+static size_t CullSSE(const std::array<glm::vec4, 6>& planes, const AABBSoA& boxes, uint32_t* visibleIndices)
+{
+	const size_t count = boxes.Size();
+	const size_t simdCount = count & ~size_t(3);
+	size_t numVisible = 0;
+	for (size_t idx = 0; idx < simdCount; idx += 4)
+	{
+		const __m128 minX = _mm_loadu_ps(&boxes.MinX[idx]);
+		const __m128 minY = _mm_loadu_ps(&boxes.MinY[idx]);
+		const __m128 minZ = _mm_loadu_ps(&boxes.MinZ[idx]);
+		const __m128 maxX = _mm_loadu_ps(&boxes.MaxX[idx]);
+		const __m128 maxY = _mm_loadu_ps(&boxes.MaxY[idx]);
+		const __m128 maxZ = _mm_loadu_ps(&boxes.MaxZ[idx]);
+
+		__m128 outside = _mm_setzero_ps();
+		for (const glm::vec4& plane : planes)
+		{
+			const __m128 nx = _mm_set1_ps(plane.x);
+			const __m128 ny = _mm_set1_ps(plane.y);
+			const __m128 nz = _mm_set1_ps(plane.z);
+			__m128 distance = _mm_set1_ps(plane.w);
+			distance = _mm_add_ps(distance, _mm_max_ps(_mm_mul_ps(nx, minX), _mm_mul_ps(nx, maxX)));
+			distance = _mm_add_ps(distance, _mm_max_ps(_mm_mul_ps(ny, minY), _mm_mul_ps(ny, maxY)));
+			distance = _mm_add_ps(distance, _mm_max_ps(_mm_mul_ps(nz, minZ), _mm_mul_ps(nz, maxZ)));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+		}
+
+		const uint32_t visibleMask = ~static_cast<uint32_t>(_mm_movemask_ps(outside)) & 0xF;
+		numVisible += CompactMask(visibleMask, idx, visibleIndices + numVisible);
+	}
+
+	return numVisible + CullRange(planes, boxes, simdCount, count, visibleIndices + numVisible);
+}
+
+SIMD_TARGET("avx2")
+static size_t CullAVX2(const std::array<glm::vec4, 6>& planes, const AABBSoA& boxes, uint32_t* visibleIndices)
+{
+	const size_t count = boxes.Size();
+	const size_t simdCount = count & ~size_t(7);
+	size_t numVisible = 0;
+	for (size_t idx = 0; idx < simdCount; idx += 8)
+	{
+		const __m256 minX = _mm256_loadu_ps(&boxes.MinX[idx]);
+		const __m256 minY = _mm256_loadu_ps(&boxes.MinY[idx]);
+		const __m256 minZ = _mm256_loadu_ps(&boxes.MinZ[idx]);
+		const __m256 maxX = _mm256_loadu_ps(&boxes.MaxX[idx]);
+		const __m256 maxY = _mm256_loadu_ps(&boxes.MaxY[idx]);
+		const __m256 maxZ = _mm256_loadu_ps(&boxes.MaxZ[idx]);
+
+		__m256 outside = _mm256_setzero_ps();
+		for (const glm::vec4& plane : planes)
+		{
+			const __m256 nx = _mm256_set1_ps(plane.x);
+			const __m256 ny = _mm256_set1_ps(plane.y);
+			const __m256 nz = _mm256_set1_ps(plane.z);
+			__m256 distance = _mm256_set1_ps(plane.w);
+			distance = _mm256_add_ps(distance, _mm256_max_ps(_mm256_mul_ps(nx, minX), _mm256_mul_ps(nx, maxX)));
+			distance = _mm256_add_ps(distance, _mm256_max_ps(_mm256_mul_ps(ny, minY), _mm256_mul_ps(ny, maxY)));
+			distance = _mm256_add_ps(distance, _mm256_max_ps(_mm256_mul_ps(nz, minZ), _mm256_mul_ps(nz, maxZ)));
+			outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_LT_OQ));
+		}
+
+		const uint32_t visibleMask = ~static_cast<uint32_t>(_mm256_movemask_ps(outside)) & 0xFF;
+		numVisible += CompactMask(visibleMask, idx, visibleIndices + numVisible);
+	}
+
+	return numVisible + CullRange(planes, boxes, simdCount, count, visibleIndices + numVisible);
+}
+
+SIMD_TARGET("avx512f")
+static size_t CullAVX512(const std::array<glm::vec4, 6>& planes, const AABBSoA& boxes, uint32_t* visibleIndices)
+{
+	const size_t count = boxes.Size();
+	const size_t simdCount = count & ~size_t(15);
+	size_t numVisible = 0;
+	for (size_t idx = 0; idx < simdCount; idx += 16)
+	{
+		const __m512 minX = _mm512_loadu_ps(&boxes.MinX[idx]);
+		const __m512 minY = _mm512_loadu_ps(&boxes.MinY[idx]);
+		const __m512 minZ = _mm512_loadu_ps(&boxes.MinZ[idx]);
+		const __m512 maxX = _mm512_loadu_ps(&boxes.MaxX[idx]);
+		const __m512 maxY = _mm512_loadu_ps(&boxes.MaxY[idx]);
+		const __m512 maxZ = _mm512_loadu_ps(&boxes.MaxZ[idx]);
+
+		__mmask16 visible = 0xFFFF;
+		for (const glm::vec4& plane : planes)
+		{
+			const __m512 nx = _mm512_set1_ps(plane.x);
+			const __m512 ny = _mm512_set1_ps(plane.y);
+			const __m512 nz = _mm512_set1_ps(plane.z);
+			__m512 distance = _mm512_set1_ps(plane.w);
+			distance = _mm512_add_ps(distance, _mm512_max_ps(_mm512_mul_ps(nx, minX), _mm512_mul_ps(nx, maxX)));
+			distance = _mm512_add_ps(distance, _mm512_max_ps(_mm512_mul_ps(ny, minY), _mm512_mul_ps(ny, maxY)));
+			distance = _mm512_add_ps(distance, _mm512_max_ps(_mm512_mul_ps(nz, minZ), _mm512_mul_ps(nz, maxZ)));
+			visible = _mm512_mask_cmp_ps_mask(visible, distance, _mm512_setzero_ps(), _CMP_GE_OQ);
+		}
+
+		numVisible += CompactMask(static_cast<uint32_t>(visible), idx, visibleIndices + numVisible);
+	}
+
+	return numVisible + CullRange(planes, boxes, simdCount, count, visibleIndices + numVisible);
+}
+
+size_t FrustumCuller::Cull(const std::array<glm::vec4, 6>& planes, const AABBSoA& boxes, uint32_t* visibleIndices)
+{
+	static const ESIMDLevel level = GetSupportedLevel();
+	return Cull(planes, boxes, visibleIndices, level);
+}
+
+size_t FrustumCuller::Cull(const std::array<glm::vec4, 6>& planes, const AABBSoA& boxes, uint32_t* visibleIndices, ESIMDLevel level)
+{
+	switch (level)
+	{
+	case ESIMDLevel::AVX512:
+		return CullAVX512(planes, boxes, visibleIndices);
+
+	case ESIMDLevel::AVX2:
+		return CullAVX2(planes, boxes, visibleIndices);
+
+	case ESIMDLevel::SSE:
+		return CullSSE(planes, boxes, visibleIndices);
+
+	case ESIMDLevel::Scalar:
+	default:
+		return CullRange(planes, boxes, 0, boxes.Size(), visibleIndices);
+	}
+}
+
+ESIMDLevel FrustumCuller::GetSupportedLevel()
+{
+	int registers[4] = { 0, 0, 0, 0 };
+	CPUID(0, 0, registers);
+	const int maxLeaf = registers[0];
+
+	CPUID(1, 0, registers);
+	const bool bOSXSave = (registers[2] & (1 << 27)) != 0;
+	const bool bAVX = (registers[2] & (1 << 28)) != 0;
+	if (!bOSXSave || !bAVX || maxLeaf < 7)
+	{
+		// SSE2 is part of x64 baseline
+		return ESIMDLevel::SSE;
+	}
+
+	// OS has to save wider registers on context switch too
+	const uint64_t xcr0 = XGetBV();
+	const bool bOSAVX = (xcr0 & 0x6) == 0x6;
+	const bool bOSAVX512 = (xcr0 & 0xE6) == 0xE6;
+
+	CPUID(7, 0, registers);
+	const bool bAVX2 = (registers[1] & (1 << 5)) != 0;
+	const bool bAVX512F = (registers[1] & (1 << 16)) != 0;
+
+	if (bAVX512F && bOSAVX512)
+	{
+		return ESIMDLevel::AVX512;
+	}
+	else if (bAVX2 && bOSAVX)
+	{
+		return ESIMDLevel::AVX2;
+	}
+
+	return ESIMDLevel::SSE;
+}
+
+const char* FrustumCuller::ToString(ESIMDLevel level)
+{
+	switch (level)
+	{
+	case ESIMDLevel::AVX512:
+		return "AVX-512";
+
+	case ESIMDLevel::AVX2:
+		return "AVX2";
+
+	case ESIMDLevel::SSE:
+		return "SSE";
+
+	case ESIMDLevel::Scalar:
+	default:
+		return "Scalar";
+	}
+}
+
+void FrustumCuller::RunBenchmark(size_t boxCount, unsigned int iterations)
+{
+	// Boxes scattered around origin; roughly half of them inside of the frustum
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> extent(0.1f, 5.0f);
+
+	AABBSoA boxes;
+	boxes.Resize(boxCount);
+	for (size_t idx = 0; idx < boxCount; ++idx)
+	{
+		const glm::vec3 center(position(random), position(random), position(random));
+		const glm::vec3 halfSize(extent(random), extent(random), extent(random));
+		boxes.Set(idx, AABB(center - halfSize, center + halfSize));
+	}
+
+	// Planes of symmetric 90 degree frustum looking down -z, near 0.1, far 100
+	const float invSqrt2 = 0.70710678f;
+	const std::array<glm::vec4, 6> planes = {
+		glm::vec4(invSqrt2, 0.0f, -invSqrt2, 0.0f),
+		glm::vec4(-invSqrt2, 0.0f, -invSqrt2, 0.0f),
+		glm::vec4(0.0f, invSqrt2, -invSqrt2, 0.0f),
+		glm::vec4(0.0f, -invSqrt2, -invSqrt2, 0.0f),
+		glm::vec4(0.0f, 0.0f, -1.0f, -0.1f),
+		glm::vec4(0.0f, 0.0f, 1.0f, 100.0f) };
+
+	std::vector<uint32_t> reference(boxCount);
+	std::vector<uint32_t> visible(boxCount);
+	const size_t referenceCount = Cull(planes, boxes, reference.data(), ESIMDLevel::Scalar);
+
+	std::cout << "----   Frustum Culling Benchmark   ----" << std::endl;
+	std::cout << "Boxes : " << boxCount << ", Visible : " << referenceCount << ", Iterations : " << iterations << std::endl;
+	const ESIMDLevel supported = GetSupportedLevel();
+	for (const ESIMDLevel level : { ESIMDLevel::Scalar, ESIMDLevel::SSE, ESIMDLevel::AVX2, ESIMDLevel::AVX512 })
+	{
+		if (level > supported)
+		{
+			std::cout << ToString(level) << " : Not supported" << std::endl;
+			continue;
+		}
+
+		size_t count = 0;
+		const auto begin = std::chrono::high_resolution_clock::now();
+		for (unsigned int iteration = 0; iteration < iterations; ++iteration)
+		{
+			count = Cull(planes, boxes, visible.data(), level);
+		}
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		const double elapsed = std::chrono::duration<double, std::nano>(end - begin).count();
+		const bool bMatched = count == referenceCount && std::equal(visible.begin(), visible.begin() + count, reference.begin());
+		std::cout << ToString(level) << " : " << (static_cast<double>(boxCount) * iterations / elapsed) << " boxes/ns"
+			<< (bMatched ? "" : " (MISMATCH with scalar)") << std::endl;
+	}
+
+	std::cout << std::endl;
+}
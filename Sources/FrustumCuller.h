@@ -0,0 +1,50 @@
+#pragma once
+#include "AABB.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/* Bounds in structure of arrays layout, so several boxes are loaded into one SIMD register per component */
+struct AABBSoA
+{
+	std::vector<float> MinX;
+	std::vector<float> MinY;
+	std::vector<float> MinZ;
+	std::vector<float> MaxX;
+	std::vector<float> MaxY;
+	std::vector<float> MaxZ;
+
+	void Resize(size_t count);
+	void Set(size_t idx, const AABB& bounds);
+	size_t Size() const { return MinX.size(); }
+};
+
+enum class ESIMDLevel
+{
+	Scalar,
+	SSE,	// 4 boxes per iteration
+	AVX2,	// 8
+	AVX512	// 16
+};
+
+/*
+* Frustum vs box test over SoA bounds; one SIMD lane per box.
+* Each plane is tested with the p-vertex only : max(n.x * min.x, n.x * max.x) + ... + d < 0 means outside,
+* which is the corner farthest along the normal without any branch.
+* Kernel is chosen at runtime from what CPU and OS support.
+**/
+class FrustumCuller
+{
+public:
+	/* Writes indices of boxes which are not outside of any plane; returns number of written indices */
+	static size_t Cull(const std::array<glm::vec4, 6>& planes, const AABBSoA& boxes, uint32_t* visibleIndices);
+	static size_t Cull(const std::array<glm::vec4, 6>& planes, const AABBSoA& boxes, uint32_t* visibleIndices, ESIMDLevel level);
+
+	static ESIMDLevel GetSupportedLevel();
+	static const char* ToString(ESIMDLevel level);
+
+	/* Prints throughput(boxes/ns) of every supported kernel over random boxes, and checks them against scalar */
+	static void RunBenchmark(size_t boxCount = 1 << 20, unsigned int iterations = 20);
+
+};
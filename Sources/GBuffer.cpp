@@ -1,4 +1,5 @@
 #include "GBuffer.h"
+#include "GLStateCache.h"
 
 GBuffer::GBuffer(unsigned int width, unsigned int height) :
 	m_width(width),
@@ -16,37 +17,37 @@ GBuffer::GBuffer(unsigned int width, unsigned int height) :
 bool GBuffer::Init()
 {
 	glGenFramebuffers(1, &m_gBuffer);
-	glBindFramebuffer(GL_FRAMEBUFFER, m_gBuffer);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, m_gBuffer);
 
 	glGenTextures(1, &m_pos);
-	glBindTexture(GL_TEXTURE_2D, m_pos);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0, m_pos);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, m_width, m_height, 0, GL_RGB, GL_FLOAT, nullptr);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_pos, 0);
 
 	glGenTextures(1, &m_normal);
-	glBindTexture(GL_TEXTURE_2D, m_normal);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0, m_normal);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, m_width, m_height, 0, GL_RGB, GL_FLOAT, nullptr);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, m_normal, 0);
 
 	glGenTextures(1, &m_albedo);
-	glBindTexture(GL_TEXTURE_2D, m_albedo);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0, m_albedo);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0, GL_RGB, GL_FLOAT, nullptr);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, m_albedo, 0);
 
 	glGenTextures(1, &m_metallicRoughness);
-	glBindTexture(GL_TEXTURE_2D, m_metallicRoughness);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0, m_metallicRoughness);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RG, m_width, m_height, 0, GL_RG, GL_FLOAT, nullptr);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT3, GL_TEXTURE_2D, m_metallicRoughness, 0);
 	glGenTextures(1, &m_emissiveAO);
-	glBindTexture(GL_TEXTURE_2D, m_emissiveAO);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0, m_emissiveAO);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0, GL_RGBA, GL_FLOAT, nullptr);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -54,15 +55,15 @@ bool GBuffer::Init()
 
 	glGenRenderbuffers(1, &m_depth);
 	glBindRenderbuffer(GL_RENDERBUFFER, m_depth);
-	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, m_width, m_height);
-	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depth);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_width, m_height);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth);
 
 	return true;
 }
 
 void GBuffer::BindFrameBuffer()
 {
-	glBindFramebuffer(GL_FRAMEBUFFER, m_gBuffer);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, m_gBuffer);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	unsigned int attachments[5] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3, GL_COLOR_ATTACHMENT4 };
@@ -71,33 +72,23 @@ void GBuffer::BindFrameBuffer()
 
 void GBuffer::UnbindFrameBuffer()
 {
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void GBuffer::BindTextures()
 {
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, m_pos);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, m_normal);
-	glActiveTexture(GL_TEXTURE2);
-	glBindTexture(GL_TEXTURE_2D, m_albedo);
-	glActiveTexture(GL_TEXTURE3);
-	glBindTexture(GL_TEXTURE_2D, m_metallicRoughness);
-	glActiveTexture(GL_TEXTURE4);
-	glBindTexture(GL_TEXTURE_2D, m_emissiveAO);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0, m_pos);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 1, m_normal);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 2, m_albedo);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 3, m_metallicRoughness);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 4, m_emissiveAO);
 }
 
 void GBuffer::UnbindTextures()
 {
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glActiveTexture(GL_TEXTURE2);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glActiveTexture(GL_TEXTURE3);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glActiveTexture(GL_TEXTURE4);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 1, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 2, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 3, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 4, 0);
 }
@@ -15,6 +15,8 @@ public:
 	void BindTextures();
 	void UnbindTextures();
 
+	unsigned int GetID() const { return m_gBuffer; }
+
 private:
 	unsigned int m_width;
 	unsigned int m_height;
@@ -0,0 +1,296 @@
+#include "GLStateCache.h"
+
+GLuint GLStateCache::s_program = UnknownGLState;
+GLuint GLStateCache::s_vao = UnknownGLState;
+GLuint GLStateCache::s_activeTexture = UnknownGLState;
+std::array<std::array<GLuint, 3>, MaxTrackedTextureUnits> GLStateCache::s_textures;
+GLuint GLStateCache::s_readFramebuffer = UnknownGLState;
+GLuint GLStateCache::s_drawFramebuffer = UnknownGLState;
+std::array<GLint, 4> GLStateCache::s_viewport = { 0, 0, 0, 0 };
+bool GLStateCache::s_bViewportKnown = false;
+std::unordered_map<GLenum, bool> GLStateCache::s_caps;
+GLuint GLStateCache::s_cullFace = UnknownGLState;
+GLuint GLStateCache::s_frontFace = UnknownGLState;
+GLuint GLStateCache::s_depthFunc = UnknownGLState;
+GLuint GLStateCache::s_depthMask = UnknownGLState;
+GLuint GLStateCache::s_colorMask = UnknownGLState;
+
+unsigned int GLStateCache::s_issuedCalls = 0;
+unsigned int GLStateCache::s_filteredCalls = 0;
+unsigned int GLStateCache::s_lastFrameIssuedCalls = 0;
+unsigned int GLStateCache::s_lastFrameFilteredCalls = 0;
+
+bool GLStateCache::Update(GLuint& shadowed, GLuint value)
+{
+	if (shadowed == value)
+	{
+		++s_filteredCalls;
+		return false;
+	}
+
+	shadowed = value;
+	++s_issuedCalls;
+	return true;
+}
+
+int GLStateCache::TextureTargetIndex(GLenum target)
+{
+	switch (target)
+	{
+	case GL_TEXTURE_2D:
+		return 0;
+
+	case GL_TEXTURE_3D:
+		return 1;
+
+	case GL_TEXTURE_2D_ARRAY:
+		return 2;
+
+	default:
+		return -1;
+	}
+}
+
+void GLStateCache::UseProgram(GLuint program)
+{
+	if (Update(s_program, program))
+	{
+		glUseProgram(program);
+	}
+}
+
+void GLStateCache::BindVertexArray(GLuint vao)
+{
+	if (Update(s_vao, vao))
+	{
+		glBindVertexArray(vao);
+	}
+}
+
+void GLStateCache::ActiveTexture(unsigned int slot)
+{
+	if (Update(s_activeTexture, slot))
+	{
+		glActiveTexture(GL_TEXTURE0 + slot);
+	}
+}
+
+void GLStateCache::BindTexture(GLenum target, unsigned int slot, GLuint texture)
+{
+	const int targetIdx = TextureTargetIndex(target);
+	if (targetIdx < 0 || slot >= MaxTrackedTextureUnits)
+	{
+		ActiveTexture(slot);
+		glBindTexture(target, texture);
+		++s_issuedCalls;
+		return;
+	}
+
+	if (s_textures[slot][targetIdx] == texture)
+	{
+		++s_filteredCalls;
+		return;
+	}
+
+	ActiveTexture(slot);
+	Update(s_textures[slot][targetIdx], texture);
+	glBindTexture(target, texture);
+}
+
+void GLStateCache::BindFramebuffer(GLenum target, GLuint fbo)
+{
+	switch (target)
+	{
+	case GL_READ_FRAMEBUFFER:
+		if (Update(s_readFramebuffer, fbo))
+		{
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+		}
+		break;
+
+	case GL_DRAW_FRAMEBUFFER:
+		if (Update(s_drawFramebuffer, fbo))
+		{
+			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+		}
+		break;
+
+	default:
+		if (s_readFramebuffer == fbo && s_drawFramebuffer == fbo)
+		{
+			++s_filteredCalls;
+		}
+		else
+		{
+			s_readFramebuffer = fbo;
+			s_drawFramebuffer = fbo;
+			++s_issuedCalls;
+			glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		}
+		break;
+	}
+}
+
+void GLStateCache::Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	const std::array<GLint, 4> viewport = { x, y, width, height };
+	if (s_bViewportKnown && s_viewport == viewport)
+	{
+		++s_filteredCalls;
+		return;
+	}
+
+	s_viewport = viewport;
+	s_bViewportKnown = true;
+	++s_issuedCalls;
+	glViewport(x, y, width, height);
+}
+
+void GLStateCache::SetEnabled(GLenum cap, bool bEnable)
+{
+	if (const auto found = s_caps.find(cap); found != s_caps.end() && found->second == bEnable)
+	{
+		++s_filteredCalls;
+		return;
+	}
+
+	s_caps[cap] = bEnable;
+	++s_issuedCalls;
+	if (bEnable)
+	{
+		glEnable(cap);
+	}
+	else
+	{
+		glDisable(cap);
+	}
+}
+
+void GLStateCache::CullFace(GLenum mode)
+{
+	if (Update(s_cullFace, mode))
+	{
+		glCullFace(mode);
+	}
+}
+
+void GLStateCache::FrontFace(GLenum mode)
+{
+	if (Update(s_frontFace, mode))
+	{
+		glFrontFace(mode);
+	}
+}
+
+void GLStateCache::DepthFunc(GLenum func)
+{
+	if (Update(s_depthFunc, func))
+	{
+		glDepthFunc(func);
+	}
+}
+
+void GLStateCache::DepthMask(GLboolean bWrite)
+{
+	if (Update(s_depthMask, bWrite))
+	{
+		glDepthMask(bWrite);
+	}
+}
+
+void GLStateCache::ColorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a)
+{
+	const GLuint packed = (r ? 0x1 : 0x0) | (g ? 0x2 : 0x0) | (b ? 0x4 : 0x0) | (a ? 0x8 : 0x0);
+	if (Update(s_colorMask, packed))
+	{
+		glColorMask(r, g, b, a);
+	}
+}
+
+GLuint GLStateCache::GetProgram()
+{
+	if (s_program == UnknownGLState)
+	{
+		GLint program = 0;
+		glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+		s_program = static_cast<GLuint>(program);
+	}
+
+	return s_program;
+}
+
+GLuint GLStateCache::GetBoundFramebuffer(GLenum target)
+{
+	GLuint& shadowed = (target == GL_READ_FRAMEBUFFER) ? s_readFramebuffer : s_drawFramebuffer;
+	if (shadowed == UnknownGLState)
+	{
+		GLint bound = 0;
+		glGetIntegerv((target == GL_READ_FRAMEBUFFER) ? GL_READ_FRAMEBUFFER_BINDING : GL_DRAW_FRAMEBUFFER_BINDING, &bound);
+		shadowed = static_cast<GLuint>(bound);
+	}
+
+	return shadowed;
+}
+
+void GLStateCache::OnTextureDeleted(GLuint texture)
+{
+	for (auto& unit : s_textures)
+	{
+		for (auto& bound : unit)
+		{
+			if (bound == texture)
+			{
+				bound = 0;
+			}
+		}
+	}
+}
+
+void GLStateCache::OnFramebufferDeleted(GLuint fbo)
+{
+	if (s_readFramebuffer == fbo)
+	{
+		s_readFramebuffer = 0;
+	}
+
+	if (s_drawFramebuffer == fbo)
+	{
+		s_drawFramebuffer = 0;
+	}
+}
+
+void GLStateCache::OnProgramDeleted(GLuint program)
+{
+	if (s_program == program)
+	{
+		s_program = UnknownGLState;
+	}
+}
+
+void GLStateCache::Invalidate()
+{
+	s_program = UnknownGLState;
+	s_vao = UnknownGLState;
+	s_activeTexture = UnknownGLState;
+	for (auto& unit : s_textures)
+	{
+		unit.fill(UnknownGLState);
+	}
+	s_readFramebuffer = UnknownGLState;
+	s_drawFramebuffer = UnknownGLState;
+	s_bViewportKnown = false;
+	s_caps.clear();
+	s_cullFace = UnknownGLState;
+	s_frontFace = UnknownGLState;
+	s_depthFunc = UnknownGLState;
+	s_depthMask = UnknownGLState;
+	s_colorMask = UnknownGLState;
+}
+
+void GLStateCache::EndFrame()
+{
+	s_lastFrameIssuedCalls = s_issuedCalls;
+	s_lastFrameFilteredCalls = s_filteredCalls;
+	s_issuedCalls = 0;
+	s_filteredCalls = 0;
+}
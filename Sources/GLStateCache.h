@@ -0,0 +1,77 @@
+#pragma once
+#include "Rendering.h"
+#include <array>
+#include <unordered_map>
+
+constexpr unsigned int MaxTrackedTextureUnits = 32;
+constexpr GLuint UnknownGLState = 0xFFFFFFFF;
+
+/*
+* Shadowed copy of GL context states.
+* Every wrapper binds through here, so only actual state changes reach the driver.
+* Any code which changes these states with raw gl calls must call Invalidate().
+**/
+class GLStateCache
+{
+public:
+	static void UseProgram(GLuint program);
+	static void BindVertexArray(GLuint vao);
+	static void BindTexture(GLenum target, unsigned int slot, GLuint texture);
+	static void BindFramebuffer(GLenum target, GLuint fbo);
+	static void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+	static void SetEnabled(GLenum cap, bool bEnable);
+	static void Enable(GLenum cap) { SetEnabled(cap, true); }
+	static void Disable(GLenum cap) { SetEnabled(cap, false); }
+
+	static void CullFace(GLenum mode);
+	static void FrontFace(GLenum mode);
+	static void DepthFunc(GLenum func);
+	static void DepthMask(GLboolean bWrite);
+	static void ColorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a);
+
+	static GLuint GetProgram();
+	static GLuint GetBoundFramebuffer(GLenum target);
+
+	/* Deleted names are unbound by GL itself and may be reused by glGen*, so shadowed copies have to forget them */
+	static void OnTextureDeleted(GLuint texture);
+	static void OnFramebufferDeleted(GLuint fbo);
+	/* Deleted program stays current until next glUseProgram, but its name may be reused by glCreateProgram */
+	static void OnProgramDeleted(GLuint program);
+
+	/* Forget every shadowed state; next call of each state always reaches the driver */
+	static void Invalidate();
+
+	/* Moves counters of current frame to last frame */
+	static void EndFrame();
+	static unsigned int GetLastFrameIssuedCalls() { return s_lastFrameIssuedCalls; }
+	static unsigned int GetLastFrameFilteredCalls() { return s_lastFrameFilteredCalls; }
+
+private:
+	/* Returns true if state has to be changed */
+	static bool Update(GLuint& shadowed, GLuint value);
+	static int TextureTargetIndex(GLenum target);
+	static void ActiveTexture(unsigned int slot);
+
+private:
+	static GLuint s_program;
+	static GLuint s_vao;
+	static GLuint s_activeTexture;
+	static std::array<std::array<GLuint, 3>, MaxTrackedTextureUnits> s_textures;
+	static GLuint s_readFramebuffer;
+	static GLuint s_drawFramebuffer;
+	static std::array<GLint, 4> s_viewport;
+	static bool s_bViewportKnown;
+	static std::unordered_map<GLenum, bool> s_caps;
+	static GLuint s_cullFace;
+	static GLuint s_frontFace;
+	static GLuint s_depthFunc;
+	static GLuint s_depthMask;
+	static GLuint s_colorMask;
+
+	static unsigned int s_issuedCalls;
+	static unsigned int s_filteredCalls;
+	static unsigned int s_lastFrameIssuedCalls;
+	static unsigned int s_lastFrameFilteredCalls;
+
+};
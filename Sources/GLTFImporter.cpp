@@ -0,0 +1,936 @@
+#include "GLTFImporter.h"
+#include "MappedFile.h"
+#include "Material.h"
+#include "MeshoptDecoder.h"
+#include "tinygltf/json.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <span>
+
+using json = nlohmann::json;
+
+/* Values defined by glTF 2.0 spec */
+constexpr int64_t GLTFByte = 5120;
+constexpr int64_t GLTFUnsignedByte = 5121;
+constexpr int64_t GLTFShort = 5122;
+constexpr int64_t GLTFUnsignedShort = 5123;
+constexpr int64_t GLTFUnsignedInt = 5125;
+constexpr int64_t GLTFFloat = 5126;
+constexpr int64_t GLTFTriangles = 4;
+constexpr uint32_t GLBMagic = 0x46546C67; // 'glTF'
+constexpr uint32_t GLBChunkJSON = 0x4E4F534A; // 'JSON'
+constexpr uint32_t GLBChunkBIN = 0x004E4942; // 'BIN\0'
+constexpr size_t GLBHeaderSize = 12;
+/* Node hierarchy is a tree by spec; deeper one is treated as cyclic */
+constexpr int MaxNodeDepth = 256;
+/* Upper bound of single decoded buffer view; larger one is treated as corrupted */
+constexpr uint64_t MaxDecodedViewSize = 1ull << 31;
+
+/* Extensions which are decoded on import, so files requiring them are still handled */
+static const char* SupportedRequiredExtensions[] = { "EXT_meshopt_compression", "KHR_mesh_quantization", "KHR_texture_transform" };
+
+/* Contents of buffer view; either range of mapped buffer or decoded copy */
+struct GLTFBufferView
+{
+	std::span<const uint8_t> Data;
+	/* Null if contents were decoded */
+	std::shared_ptr<const MappedFile> File;
+	bool bValid = false;
+};
+
+struct GLTFDocument
+{
+	json Root;
+	std::string FolderPath;
+	/* Mapped file and contents of each buffer; meshopt fallback buffers are empty */
+	std::vector<std::shared_ptr<const MappedFile>> BufferFiles;
+	/* Paths of external buffer files */
+	std::vector<std::string> BufferPaths;
+	std::vector<std::span<const uint8_t>> Buffers;
+	std::vector<GLTFBufferView> Views;
+	std::vector<std::vector<uint8_t>> DecodedViews;
+};
+
+/* Elements of accessor inside of buffer view */
+struct GLTFAccessorView
+{
+	const uint8_t* Data = nullptr;
+	size_t Count = 0;
+	size_t Stride = 0;
+	int64_t ComponentType = 0;
+	size_t Components = 0;
+	bool bNormalized = false;
+	std::shared_ptr<const MappedFile> File;
+};
+
+static const json* FindMember(const json& object, const char* key)
+{
+	if (!object.is_object())
+	{
+		return nullptr;
+	}
+
+	const auto found = object.find(key);
+	return (found != object.end()) ? &(*found) : nullptr;
+}
+
+static const json* GetElement(const json& object, const char* arrayKey, int64_t idx)
+{
+	const json* array = FindMember(object, arrayKey);
+	if (array == nullptr || !array->is_array() || idx < 0 || static_cast<size_t>(idx) >= array->size())
+	{
+		return nullptr;
+	}
+
+	return &(*array)[static_cast<size_t>(idx)];
+}
+
+static int64_t GetInt(const json& object, const char* key, int64_t defaultValue)
+{
+	const json* member = FindMember(object, key);
+	return (member != nullptr && member->is_number_integer()) ? member->get<int64_t>() : defaultValue;
+}
+
+static float GetFloat(const json& object, const char* key, float defaultValue)
+{
+	const json* member = FindMember(object, key);
+	return (member != nullptr && member->is_number()) ? member->get<float>() : defaultValue;
+}
+
+static std::string GetString(const json& object, const char* key)
+{
+	const json* member = FindMember(object, key);
+	return (member != nullptr && member->is_string()) ? member->get<std::string>() : std::string();
+}
+
+static bool GetBool(const json& object, const char* key, bool defaultValue)
+{
+	const json* member = FindMember(object, key);
+	return (member != nullptr && member->is_boolean()) ? member->get<bool>() : defaultValue;
+}
+
+static bool GetFloats(const json& object, const char* key, float* outValues, size_t count)
+{
+	const json* member = FindMember(object, key);
+	if (member == nullptr || !member->is_array() || member->size() != count)
+	{
+		return false;
+	}
+
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		if (!(*member)[idx].is_number())
+		{
+			return false;
+		}
+
+		outValues[idx] = (*member)[idx].get<float>();
+	}
+
+	return true;
+}
+
+static std::string DecodeURI(const std::string& uri)
+{
+	std::string decoded;
+	decoded.reserve(uri.size());
+	for (size_t idx = 0; idx < uri.size(); ++idx)
+	{
+		if (uri[idx] == '%' && idx + 2 < uri.size() &&
+			std::isxdigit(static_cast<unsigned char>(uri[idx + 1])) && std::isxdigit(static_cast<unsigned char>(uri[idx + 2])))
+		{
+			decoded.push_back(static_cast<char>(std::stoi(uri.substr(idx + 1, 2), nullptr, 16)));
+			idx += 2;
+		}
+		else
+		{
+			decoded.push_back(uri[idx]);
+		}
+	}
+
+	return decoded;
+}
+
+static size_t ComponentsOf(const std::string& type)
+{
+	if (type == "SCALAR") return 1;
+	if (type == "VEC2") return 2;
+	if (type == "VEC3") return 3;
+	if (type == "VEC4") return 4;
+	if (type == "MAT4") return 16;
+	return 0;
+}
+
+static size_t ComponentSize(int64_t componentType)
+{
+	switch (componentType)
+	{
+	case GLTFByte:
+	case GLTFUnsignedByte:
+		return 1;
+	case GLTFShort:
+	case GLTFUnsignedShort:
+		return 2;
+	case GLTFUnsignedInt:
+	case GLTFFloat:
+		return 4;
+	default:
+		return 0;
+	}
+}
+
+static std::span<const uint8_t> GetBufferRange(const GLTFDocument& doc, const json& object)
+{
+	const int64_t bufferIdx = GetInt(object, "buffer", -1);
+	if (bufferIdx < 0 || static_cast<size_t>(bufferIdx) >= doc.Buffers.size())
+	{
+		return { };
+	}
+
+	const std::span<const uint8_t>& buffer = doc.Buffers[static_cast<size_t>(bufferIdx)];
+	const uint64_t offset = static_cast<uint64_t>(GetInt(object, "byteOffset", 0));
+	const uint64_t length = static_cast<uint64_t>(GetInt(object, "byteLength", 0));
+	if (offset > buffer.size() || length > buffer.size() - offset)
+	{
+		return { };
+	}
+
+	return buffer.subspan(static_cast<size_t>(offset), static_cast<size_t>(length));
+}
+
+/* Views which cannot be resolved only fail import when an accessor reads them; malformed compressed data fails right away */
+static bool ResolveBufferView(GLTFDocument& doc, const json& bufferView, GLTFBufferView& outView)
+{
+	const json* extensions = FindMember(bufferView, "extensions");
+	const json* meshopt = (extensions != nullptr) ? FindMember(*extensions, "EXT_meshopt_compression") : nullptr;
+	if (meshopt == nullptr)
+	{
+		const int64_t bufferIdx = GetInt(bufferView, "buffer", -1);
+		outView.Data = GetBufferRange(doc, bufferView);
+		outView.bValid = !outView.Data.empty();
+		outView.File = outView.bValid ? doc.BufferFiles[static_cast<size_t>(bufferIdx)] : nullptr;
+		return true;
+	}
+
+	const std::span<const uint8_t> source = GetBufferRange(doc, *meshopt);
+	const int64_t count = GetInt(*meshopt, "count", -1);
+	const int64_t byteStride = GetInt(*meshopt, "byteStride", -1);
+	if (source.empty() || count < 0 || byteStride <= 0 ||
+		static_cast<uint64_t>(count) * static_cast<uint64_t>(byteStride) > MaxDecodedViewSize)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> decoded(static_cast<size_t>(count * byteStride));
+	const std::string mode = GetString(*meshopt, "mode");
+	const std::string filter = GetString(*meshopt, "filter");
+	bool bDecoded = false;
+	if (mode == "ATTRIBUTES")
+	{
+		EMeshoptFilter filterType = EMeshoptFilter::None;
+		if (filter == "OCTAHEDRAL") filterType = EMeshoptFilter::Octahedral;
+		else if (filter == "QUATERNION") filterType = EMeshoptFilter::Quaternion;
+		else if (filter == "EXPONENTIAL") filterType = EMeshoptFilter::Exponential;
+		else if (!filter.empty() && filter != "NONE") return false;
+
+		bDecoded = MeshoptDecoder::DecodeVertexBuffer(decoded.data(), static_cast<size_t>(count), static_cast<size_t>(byteStride), source.data(), source.size()) &&
+			MeshoptDecoder::ApplyFilter(filterType, decoded.data(), static_cast<size_t>(count), static_cast<size_t>(byteStride));
+	}
+	else if (mode == "TRIANGLES")
+	{
+		bDecoded = MeshoptDecoder::DecodeIndexBuffer(decoded.data(), static_cast<size_t>(count), static_cast<size_t>(byteStride), source.data(), source.size());
+	}
+	else if (mode == "INDICES")
+	{
+		bDecoded = MeshoptDecoder::DecodeIndexSequence(decoded.data(), static_cast<size_t>(count), static_cast<size_t>(byteStride), source.data(), source.size());
+	}
+
+	if (!bDecoded)
+	{
+		return false;
+	}
+
+	// Moving vector keeps its storage, so span stays valid while DecodedViews grows
+	outView.Data = std::span<const uint8_t>(decoded.data(), decoded.size());
+	outView.File = nullptr;
+	outView.bValid = true;
+	doc.DecodedViews.push_back(std::move(decoded));
+	return true;
+}
+
+static bool LoadDocument(const std::string& filePath, GLTFDocument& doc)
+{
+	auto file = std::make_shared<const MappedFile>(filePath);
+	if (!file->IsValid())
+	{
+		std::cout << "GLTFImporter : Failed to open " << filePath << std::endl;
+		return false;
+	}
+
+	const uint8_t* data = file->GetData();
+	const size_t size = file->GetSize();
+	std::span<const uint8_t> jsonChunk(data, size);
+	std::span<const uint8_t> binChunk;
+
+	uint32_t magic = 0;
+	std::memcpy(&magic, data, std::min<size_t>(size, sizeof(uint32_t)));
+	if (magic == GLBMagic)
+	{
+		// Header(magic, version, length) followed by chunks of (length, type, data)
+		jsonChunk = { };
+		size_t offset = GLBHeaderSize;
+		while (offset + 8 <= size)
+		{
+			uint32_t chunkLength = 0;
+			uint32_t chunkType = 0;
+			std::memcpy(&chunkLength, data + offset, sizeof(uint32_t));
+			std::memcpy(&chunkType, data + offset + 4, sizeof(uint32_t));
+			offset += 8;
+			if (chunkLength > size - offset)
+			{
+				break;
+			}
+
+			if (chunkType == GLBChunkJSON && jsonChunk.empty())
+			{
+				jsonChunk = std::span<const uint8_t>(data + offset, chunkLength);
+			}
+			else if (chunkType == GLBChunkBIN && binChunk.empty())
+			{
+				binChunk = std::span<const uint8_t>(data + offset, chunkLength);
+			}
+
+			offset += chunkLength;
+		}
+	}
+
+	const char* jsonBegin = reinterpret_cast<const char*>(jsonChunk.data());
+	doc.Root = json::parse(jsonBegin, jsonBegin + jsonChunk.size(), nullptr, false);
+	if (doc.Root.is_discarded() || !doc.Root.is_object())
+	{
+		std::cout << "GLTFImporter : Failed to parse " << filePath << std::endl;
+		return false;
+	}
+
+	if (const json* required = FindMember(doc.Root, "extensionsRequired"); required != nullptr && required->is_array())
+	{
+		for (const json& extension : *required)
+		{
+			const auto supported = std::find_if(std::begin(SupportedRequiredExtensions), std::end(SupportedRequiredExtensions),
+				[&extension](const char* name) { return extension.is_string() && extension.get<std::string>() == name; });
+			if (supported == std::end(SupportedRequiredExtensions))
+			{
+				std::cout << "GLTFImporter : " << filePath << " requires unsupported extension " << extension.dump() << std::endl;
+				return false;
+			}
+		}
+	}
+
+	const std::filesystem::path parentPath = std::filesystem::path(filePath).parent_path();
+	doc.FolderPath = parentPath.empty() ? std::string() : parentPath.generic_string() + "/";
+
+	if (const json* buffers = FindMember(doc.Root, "buffers"); buffers != nullptr && buffers->is_array())
+	{
+		for (const json& buffer : *buffers)
+		{
+			// Fallback of EXT_meshopt_compression is only read by loaders which do not decode it
+			const json* meshoptBuffer = FindMember(buffer, "extensions");
+			meshoptBuffer = (meshoptBuffer != nullptr) ? FindMember(*meshoptBuffer, "EXT_meshopt_compression") : nullptr;
+			if (meshoptBuffer != nullptr && GetBool(*meshoptBuffer, "fallback", false))
+			{
+				doc.BufferFiles.push_back(nullptr);
+				doc.Buffers.push_back({ });
+				continue;
+			}
+
+			// Buffer without uri is BIN chunk of .glb
+			const std::string uri = GetString(buffer, "uri");
+			std::shared_ptr<const MappedFile> bufferFile = file;
+			std::span<const uint8_t> contents = binChunk;
+			if (!uri.empty())
+			{
+				if (uri.starts_with("data:"))
+				{
+					std::cout << "GLTFImporter : Embedded buffer of " << filePath << " is not supported" << std::endl;
+					return false;
+				}
+
+				const std::string bufferPath = doc.FolderPath + DecodeURI(uri);
+				bufferFile = std::make_shared<const MappedFile>(bufferPath);
+				if (!bufferFile->IsValid())
+				{
+					std::cout << "GLTFImporter : Failed to open buffer " << uri << " of " << filePath << std::endl;
+					return false;
+				}
+
+				doc.BufferPaths.push_back(bufferPath);
+
+				contents = std::span<const uint8_t>(bufferFile->GetData(), bufferFile->GetSize());
+			}
+
+			const int64_t byteLength = GetInt(buffer, "byteLength", -1);
+			if (byteLength < 0 || contents.size() < static_cast<size_t>(byteLength))
+			{
+				std::cout << "GLTFImporter : Buffer " << doc.Buffers.size() << " of " << filePath << " is smaller than its byteLength" << std::endl;
+				return false;
+			}
+
+			doc.BufferFiles.push_back(std::move(bufferFile));
+			doc.Buffers.push_back(contents.first(static_cast<size_t>(byteLength)));
+		}
+	}
+
+	if (const json* bufferViews = FindMember(doc.Root, "bufferViews"); bufferViews != nullptr && bufferViews->is_array())
+	{
+		doc.Views.resize(bufferViews->size());
+		for (size_t viewIdx = 0; viewIdx < bufferViews->size(); ++viewIdx)
+		{
+			if (!ResolveBufferView(doc, (*bufferViews)[viewIdx], doc.Views[viewIdx]))
+			{
+				std::cout << "GLTFImporter : Failed to decode buffer view " << viewIdx << " of " << filePath << std::endl;
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+static bool GetAccessorView(const GLTFDocument& doc, int64_t accessorIdx, GLTFAccessorView& outView)
+{
+	const json* accessor = GetElement(doc.Root, "accessors", accessorIdx);
+	if (accessor == nullptr || FindMember(*accessor, "sparse") != nullptr)
+	{
+		return false;
+	}
+
+	const int64_t viewIdx = GetInt(*accessor, "bufferView", -1);
+	const json* bufferView = GetElement(doc.Root, "bufferViews", viewIdx);
+	if (bufferView == nullptr || static_cast<size_t>(viewIdx) >= doc.Views.size() || !doc.Views[static_cast<size_t>(viewIdx)].bValid)
+	{
+		return false;
+	}
+
+	const GLTFBufferView& view = doc.Views[static_cast<size_t>(viewIdx)];
+	outView.ComponentType = GetInt(*accessor, "componentType", 0);
+	outView.Components = ComponentsOf(GetString(*accessor, "type"));
+	outView.Count = static_cast<size_t>(std::max<int64_t>(GetInt(*accessor, "count", 0), 0));
+	outView.bNormalized = GetBool(*accessor, "normalized", false);
+	outView.File = view.File;
+
+	const size_t elementSize = ComponentSize(outView.ComponentType) * outView.Components;
+	const int64_t byteStride = GetInt(*bufferView, "byteStride", 0);
+	if (elementSize == 0 || byteStride < 0)
+	{
+		return false;
+	}
+
+	// Every element has to be inside of its buffer view; view was checked against its buffer on load
+	outView.Stride = (byteStride > 0) ? static_cast<size_t>(byteStride) : elementSize;
+	const uint64_t viewLength = view.Data.size();
+	const uint64_t accessorOffset = static_cast<uint64_t>(GetInt(*accessor, "byteOffset", 0));
+	if (outView.Count > 0 && (accessorOffset > viewLength || outView.Stride * (outView.Count - 1) + elementSize > viewLength - accessorOffset))
+	{
+		return false;
+	}
+
+	outView.Data = view.Data.data() + accessorOffset;
+	return true;
+}
+
+/* Float or 8/16-bit integer components(KHR_mesh_quantization) */
+static bool GetAttribute(const GLTFDocument& doc, const json& attributes, const char* name, size_t minComponents, size_t count, GLTFAccessorView& outView)
+{
+	return GetAccessorView(doc, GetInt(attributes, name, -1), outView) &&
+		outView.ComponentType != GLTFUnsignedInt && outView.Components >= minComponents && outView.Count == count;
+}
+
+template <typename T>
+static T ReadComponent(const uint8_t* data)
+{
+	T value;
+	std::memcpy(&value, data, sizeof(T));
+	return value;
+}
+
+/* Integer components are converted as is, or mapped into [0, 1]/[-1, 1] if normalized */
+static glm::vec4 ReadElement(const GLTFAccessorView& view, size_t idx)
+{
+	float values[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	const uint8_t* element = view.Data + view.Stride * idx;
+	const size_t componentSize = ComponentSize(view.ComponentType);
+	for (size_t component = 0; component < std::min<size_t>(view.Components, 4); ++component)
+	{
+		const uint8_t* data = element + componentSize * component;
+		switch (view.ComponentType)
+		{
+		case GLTFFloat:
+			values[component] = ReadComponent<float>(data);
+			break;
+		case GLTFByte:
+			values[component] = view.bNormalized ? std::max(ReadComponent<int8_t>(data) / 127.0f, -1.0f) : ReadComponent<int8_t>(data);
+			break;
+		case GLTFUnsignedByte:
+			values[component] = view.bNormalized ? (ReadComponent<uint8_t>(data) / 255.0f) : ReadComponent<uint8_t>(data);
+			break;
+		case GLTFShort:
+			values[component] = view.bNormalized ? std::max(ReadComponent<int16_t>(data) / 32767.0f, -1.0f) : ReadComponent<int16_t>(data);
+			break;
+		case GLTFUnsignedShort:
+			values[component] = view.bNormalized ? (ReadComponent<uint16_t>(data) / 65535.0f) : ReadComponent<uint16_t>(data);
+			break;
+		}
+	}
+
+	return glm::vec4(values[0], values[1], values[2], values[3]);
+}
+
+static glm::vec3 SafeNormalize(const glm::vec3& vector)
+{
+	const float length = glm::length(vector);
+	return (length > 0.0f) ? (vector / length) : vector;
+}
+
+static void CalcNormals(MeshImportData& mesh)
+{
+	auto& vertices = mesh.Vertices;
+	const auto indices = mesh.GetIndices();
+	for (auto& vertex : vertices)
+	{
+		vertex.Normal = glm::vec3(0.0f);
+	}
+
+	// Area weighted sum of face normals
+	for (size_t idx = 0; idx + 2 < indices.size(); idx += 3)
+	{
+		auto& v0 = vertices[indices[idx]];
+		auto& v1 = vertices[indices[idx + 1]];
+		auto& v2 = vertices[indices[idx + 2]];
+		const glm::vec3 faceNormal = glm::cross(v1.Position - v0.Position, v2.Position - v0.Position);
+		v0.Normal += faceNormal;
+		v1.Normal += faceNormal;
+		v2.Normal += faceNormal;
+	}
+
+	for (auto& vertex : vertices)
+	{
+		vertex.Normal = SafeNormalize(vertex.Normal);
+	}
+}
+
+static void CalcTangents(MeshImportData& mesh)
+{
+	auto& vertices = mesh.Vertices;
+	const auto indices = mesh.GetIndices();
+	for (auto& vertex : vertices)
+	{
+		vertex.Tangent = glm::vec3(0.0f);
+	}
+
+	for (size_t idx = 0; idx + 2 < indices.size(); idx += 3)
+	{
+		auto& v0 = vertices[indices[idx]];
+		auto& v1 = vertices[indices[idx + 1]];
+		auto& v2 = vertices[indices[idx + 2]];
+		const glm::vec3 edge0 = v1.Position - v0.Position;
+		const glm::vec3 edge1 = v2.Position - v0.Position;
+		const glm::vec2 deltaUV0 = v1.TexCoord - v0.TexCoord;
+		const glm::vec2 deltaUV1 = v2.TexCoord - v0.TexCoord;
+		const float det = deltaUV0.x * deltaUV1.y - deltaUV1.x * deltaUV0.y;
+		if (det == 0.0f)
+		{
+			continue;
+		}
+
+		const glm::vec3 tangent = (edge0 * deltaUV1.y - edge1 * deltaUV0.y) / det;
+		v0.Tangent += tangent;
+		v1.Tangent += tangent;
+		v2.Tangent += tangent;
+	}
+
+	// Orthogonalize against normal(Gram-Schmidt)
+	for (auto& vertex : vertices)
+	{
+		vertex.Tangent = SafeNormalize(vertex.Tangent - vertex.Normal * glm::dot(vertex.Normal, vertex.Tangent));
+	}
+}
+
+static bool ImportPrimitive(const GLTFDocument& doc, const json& primitive, const glm::mat4& worldMatrix, const glm::mat3& texCoordTransform, const ModelLoadParams& params, MeshImportData& outMesh)
+{
+	const json* attributes = FindMember(primitive, "attributes");
+	if (GetInt(primitive, "mode", GLTFTriangles) != GLTFTriangles || attributes == nullptr)
+	{
+		return false;
+	}
+
+	GLTFAccessorView positions;
+	if (!GetAccessorView(doc, GetInt(*attributes, "POSITION", -1), positions) || positions.ComponentType == GLTFUnsignedInt || positions.Components != 3)
+	{
+		return false;
+	}
+
+	// Optional attributes; one which exists but cannot be read fails whole primitive
+	const size_t vertexCount = positions.Count;
+	GLTFAccessorView texCoords;
+	GLTFAccessorView normals;
+	GLTFAccessorView tangents;
+	const bool bHasTexCoords = FindMember(*attributes, "TEXCOORD_0") != nullptr;
+	const bool bHasNormals = FindMember(*attributes, "NORMAL") != nullptr;
+	const bool bHasTangents = FindMember(*attributes, "TANGENT") != nullptr;
+	if ((bHasTexCoords && !GetAttribute(doc, *attributes, "TEXCOORD_0", 2, vertexCount, texCoords)) ||
+		(bHasNormals && !GetAttribute(doc, *attributes, "NORMAL", 3, vertexCount, normals)) ||
+		(bHasTangents && !GetAttribute(doc, *attributes, "TANGENT", 3, vertexCount, tangents)))
+	{
+		return false;
+	}
+
+	/* Indices */
+	const int64_t indicesIdx = GetInt(primitive, "indices", -1);
+	if (indicesIdx >= 0)
+	{
+		GLTFAccessorView indices;
+		if (!GetAccessorView(doc, indicesIdx, indices) || indices.Components != 1 || (indices.Count % 3) != 0)
+		{
+			return false;
+		}
+
+		const bool bAligned = (reinterpret_cast<uintptr_t>(indices.Data) % alignof(unsigned int)) == 0;
+		if (indices.File != nullptr && indices.ComponentType == GLTFUnsignedInt && indices.Stride == sizeof(unsigned int) && bAligned && !params.ConvertToLeftHanded)
+		{
+			// Same layout as index buffer; uploaded straight out of the mapping
+			outMesh.Mapping = indices.File;
+			outMesh.MappedIndices = std::span<const unsigned int>(reinterpret_cast<const unsigned int*>(indices.Data), indices.Count);
+		}
+		else
+		{
+			outMesh.Indices.resize(indices.Count);
+			for (size_t idx = 0; idx < indices.Count; ++idx)
+			{
+				const uint8_t* element = indices.Data + indices.Stride * idx;
+				switch (indices.ComponentType)
+				{
+				case GLTFUnsignedByte:
+					outMesh.Indices[idx] = *element;
+					break;
+				case GLTFUnsignedShort:
+				{
+					uint16_t index = 0;
+					std::memcpy(&index, element, sizeof(uint16_t));
+					outMesh.Indices[idx] = index;
+					break;
+				}
+				case GLTFUnsignedInt:
+					std::memcpy(&outMesh.Indices[idx], element, sizeof(uint32_t));
+					break;
+				default:
+					return false;
+				}
+			}
+		}
+	}
+	else
+	{
+		if ((vertexCount % 3) != 0)
+		{
+			return false;
+		}
+
+		outMesh.Indices.resize(vertexCount);
+		for (size_t idx = 0; idx < vertexCount; ++idx)
+		{
+			outMesh.Indices[idx] = static_cast<unsigned int>(idx);
+		}
+	}
+
+	// Index out of range would make GPU read vertices of other meshes
+	for (const unsigned int index : outMesh.GetIndices())
+	{
+		if (index >= vertexCount)
+		{
+			return false;
+		}
+	}
+
+	if (params.ConvertToLeftHanded)
+	{
+		// Mirroring z flips winding; same as aiProcess_FlipWindingOrder
+		for (size_t idx = 0; idx + 2 < outMesh.Indices.size(); idx += 3)
+		{
+			std::swap(outMesh.Indices[idx], outMesh.Indices[idx + 2]);
+		}
+	}
+
+	/* Vertices */
+	// Without PreTransformVertices vertices stay in mesh space, same as Assimp path.
+	// Quantized positions are the exception; their dequantization scale and offset are part of node transform.
+	const bool bQuantizedPositions = positions.ComponentType != GLTFFloat;
+	const glm::mat4 transform = (params.PreTransformVertices || bQuantizedPositions) ? worldMatrix : glm::mat4(1.0f);
+	const bool bTransform = transform != glm::mat4(1.0f);
+	const glm::mat3 tangentMatrix = glm::mat3(transform);
+	const glm::mat3 normalMatrix = glm::transpose(glm::inverse(tangentMatrix));
+	const glm::vec3 mirror = params.ConvertToLeftHanded ? glm::vec3(1.0f, 1.0f, -1.0f) : glm::vec3(1.0f);
+
+	outMesh.Vertices.resize(vertexCount);
+	for (size_t idx = 0; idx < vertexCount; ++idx)
+	{
+		auto& vertex = outMesh.Vertices[idx];
+		vertex.Position = mirror * glm::vec3(transform * glm::vec4(glm::vec3(ReadElement(positions, idx)), 1.0f));
+		outMesh.BoundingBox.UpdateMin(vertex.Position);
+		outMesh.BoundingBox.UpdateMax(vertex.Position);
+
+		if (bHasTexCoords)
+		{
+			// Assimp flips glTF texcoords to bottom-left origin and ConvertToLeftHanded flips them back; textures are loaded top row first
+			const glm::vec2 texCoord = glm::vec2(texCoordTransform * glm::vec3(glm::vec2(ReadElement(texCoords, idx)), 1.0f));
+			vertex.TexCoord = params.ConvertToLeftHanded ? texCoord : glm::vec2(texCoord.x, 1.0f - texCoord.y);
+		}
+
+		if (bHasNormals)
+		{
+			// Quantized normals are not unit length after dequantization
+			const glm::vec3 normal = glm::vec3(ReadElement(normals, idx));
+			vertex.Normal = mirror * SafeNormalize(bTransform ? (normalMatrix * normal) : normal);
+		}
+
+		if (bHasTangents)
+		{
+			const glm::vec3 tangent = glm::vec3(ReadElement(tangents, idx));
+			vertex.Tangent = mirror * SafeNormalize(bTransform ? (tangentMatrix * tangent) : tangent);
+		}
+	}
+
+	if (!bHasNormals && params.GenSmoothNormals)
+	{
+		CalcNormals(outMesh);
+	}
+
+	if (!bHasTangents && bHasTexCoords && params.CalcTangentSpace)
+	{
+		CalcTangents(outMesh);
+	}
+
+	return true;
+}
+
+/*
+* KHR_texture_transform of material, which quantized texture coordinates use for dequantization.
+* Every texture of a material shares single texture coordinate set, so transform of first texture found is applied to it.
+**/
+static glm::mat3 GetTexCoordTransform(const GLTFDocument& doc, int64_t materialIdx)
+{
+	const json* material = GetElement(doc.Root, "materials", materialIdx);
+	if (material == nullptr)
+	{
+		return glm::mat3(1.0f);
+	}
+
+	const json* pbr = FindMember(*material, "pbrMetallicRoughness");
+	const json* textureInfos[] = {
+		(pbr != nullptr) ? FindMember(*pbr, "baseColorTexture") : nullptr,
+		(pbr != nullptr) ? FindMember(*pbr, "metallicRoughnessTexture") : nullptr,
+		FindMember(*material, "normalTexture"),
+		FindMember(*material, "occlusionTexture"),
+		FindMember(*material, "emissiveTexture") };
+
+	for (const json* textureInfo : textureInfos)
+	{
+		const json* extensions = (textureInfo != nullptr) ? FindMember(*textureInfo, "extensions") : nullptr;
+		const json* textureTransform = (extensions != nullptr) ? FindMember(*extensions, "KHR_texture_transform") : nullptr;
+		if (textureTransform == nullptr || GetInt(*textureTransform, "texCoord", 0) != 0)
+		{
+			continue;
+		}
+
+		float offset[2] = { 0.0f, 0.0f };
+		float scale[2] = { 1.0f, 1.0f };
+		GetFloats(*textureTransform, "offset", offset, 2);
+		GetFloats(*textureTransform, "scale", scale, 2);
+		const float rotation = GetFloat(*textureTransform, "rotation", 0.0f);
+
+		// Translation * Rotation * Scale of spec, column major
+		const float cosTheta = std::cos(rotation);
+		const float sinTheta = std::sin(rotation);
+		return glm::mat3(
+			cosTheta * scale[0], -sinTheta * scale[0], 0.0f,
+			sinTheta * scale[1], cosTheta * scale[1], 0.0f,
+			offset[0], offset[1], 1.0f);
+	}
+
+	return glm::mat3(1.0f);
+}
+
+static void ResolveMaterial(const GLTFDocument& doc, int64_t materialIdx, MeshImportData& outMesh)
+{
+	// Default material of spec if primitive has no material
+	outMesh.Factors.bValid = true;
+	const json* material = GetElement(doc.Root, "materials", materialIdx);
+	if (material == nullptr)
+	{
+		return;
+	}
+
+	const auto resolveTexture = [&](const json* textureInfo, EMaterialTexture slot)
+	{
+		if (textureInfo == nullptr)
+		{
+			return;
+		}
+
+		const json* texture = GetElement(doc.Root, "textures", GetInt(*textureInfo, "index", -1));
+		const json* image = (texture != nullptr) ? GetElement(doc.Root, "images", GetInt(*texture, "source", -1)) : nullptr;
+		const std::string uri = (image != nullptr) ? GetString(*image, "uri") : std::string();
+
+		// Images inside of buffers or data URIs are left to placeholder
+		if (!uri.empty() && !uri.starts_with("data:"))
+		{
+			outMesh.TexturePaths[slot] = doc.FolderPath + DecodeURI(uri);
+		}
+	};
+
+	if (const json* pbr = FindMember(*material, "pbrMetallicRoughness"); pbr != nullptr)
+	{
+		float baseColor[4];
+		if (GetFloats(*pbr, "baseColorFactor", baseColor, 4))
+		{
+			outMesh.Factors.BaseColor = glm::vec4(baseColor[0], baseColor[1], baseColor[2], baseColor[3]);
+		}
+
+		outMesh.Factors.Metallic = GetFloat(*pbr, "metallicFactor", 1.0f);
+		outMesh.Factors.Roughness = GetFloat(*pbr, "roughnessFactor", 1.0f);
+		resolveTexture(FindMember(*pbr, "baseColorTexture"), EMaterialTexture::BaseColor);
+		resolveTexture(FindMember(*pbr, "metallicRoughnessTexture"), EMaterialTexture::MetallicRoughness);
+	}
+
+	float emissive[3];
+	if (GetFloats(*material, "emissiveFactor", emissive, 3))
+	{
+		outMesh.Factors.Emissive = glm::vec3(emissive[0], emissive[1], emissive[2]);
+	}
+
+	resolveTexture(FindMember(*material, "normalTexture"), EMaterialTexture::Normal);
+	resolveTexture(FindMember(*material, "occlusionTexture"), EMaterialTexture::AO);
+	resolveTexture(FindMember(*material, "emissiveTexture"), EMaterialTexture::Emissive);
+}
+
+static bool ImportNode(const GLTFDocument& doc, int64_t nodeIdx, const glm::mat4& parentMatrix, const ModelLoadParams& params, int depth, std::vector<MeshImportData>& outMeshes)
+{
+	const json* node = GetElement(doc.Root, "nodes", nodeIdx);
+	if (node == nullptr || depth > MaxNodeDepth)
+	{
+		return false;
+	}
+
+	glm::mat4 localMatrix(1.0f);
+	float values[16];
+	if (GetFloats(*node, "matrix", values, 16))
+	{
+		localMatrix = glm::make_mat4(values);
+	}
+	else
+	{
+		if (GetFloats(*node, "translation", values, 3))
+		{
+			localMatrix = glm::translate(localMatrix, glm::vec3(values[0], values[1], values[2]));
+		}
+
+		if (GetFloats(*node, "rotation", values, 4))
+		{
+			localMatrix = localMatrix * glm::mat4_cast(glm::quat(values[3], values[0], values[1], values[2]));
+		}
+
+		if (GetFloats(*node, "scale", values, 3))
+		{
+			localMatrix = glm::scale(localMatrix, glm::vec3(values[0], values[1], values[2]));
+		}
+	}
+
+	const glm::mat4 worldMatrix = parentMatrix * localMatrix;
+	if (const json* mesh = GetElement(doc.Root, "meshes", GetInt(*node, "mesh", -1)); mesh != nullptr)
+	{
+		const json* primitives = FindMember(*mesh, "primitives");
+		if (primitives == nullptr || !primitives->is_array())
+		{
+			return false;
+		}
+
+		const std::string meshName = GetString(*mesh, "name");
+		for (size_t primIdx = 0; primIdx < primitives->size(); ++primIdx)
+		{
+			const json& primitive = (*primitives)[primIdx];
+			MeshImportData& data = outMeshes.emplace_back();
+			data.Name = (primitives->size() > 1) ? (meshName + "-" + std::to_string(primIdx)) : meshName;
+
+			const int64_t materialIdx = GetInt(primitive, "material", -1);
+			if (!ImportPrimitive(doc, primitive, worldMatrix, GetTexCoordTransform(doc, materialIdx), params, data))
+			{
+				return false;
+			}
+
+			ResolveMaterial(doc, materialIdx, data);
+		}
+	}
+
+	if (const json* children = FindMember(*node, "children"); children != nullptr && children->is_array())
+	{
+		for (const json& child : *children)
+		{
+			if (!child.is_number_integer() || !ImportNode(doc, child.get<int64_t>(), worldMatrix, params, depth + 1, outMeshes))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool GLTFImporter::IsGLTF(const std::string& filePath)
+{
+	std::string extension = std::filesystem::path(filePath).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+	return extension == ".gltf" || extension == ".glb";
+}
+
+bool GLTFImporter::Import(const std::string& filePath, const ModelLoadParams& params, std::vector<MeshImportData>& outMeshes, std::vector<std::string>* outDependencies)
+{
+	GLTFDocument doc;
+	if (!LoadDocument(filePath, doc))
+	{
+		return false;
+	}
+
+	const json* scene = GetElement(doc.Root, "scenes", GetInt(doc.Root, "scene", 0));
+	const json* rootNodes = (scene != nullptr) ? FindMember(*scene, "nodes") : nullptr;
+	if (rootNodes == nullptr || !rootNodes->is_array())
+	{
+		std::cout << "GLTFImporter : " << filePath << " has no scene" << std::endl;
+		return false;
+	}
+
+	std::vector<MeshImportData> meshes;
+	for (const json& rootNode : *rootNodes)
+	{
+		if (!rootNode.is_number_integer() || !ImportNode(doc, rootNode.get<int64_t>(), glm::mat4(1.0f), params, 0, meshes))
+		{
+			std::cout << "GLTFImporter : Unsupported content in " << filePath << std::endl;
+			return false;
+		}
+	}
+
+	outMeshes.insert(outMeshes.end(), std::make_move_iterator(meshes.begin()), std::make_move_iterator(meshes.end()));
+	if (outDependencies != nullptr)
+	{
+		outDependencies->insert(outDependencies->end(), doc.BufferPaths.begin(), doc.BufferPaths.end());
+	}
+
+	return true;
+}
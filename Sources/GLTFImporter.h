@@ -0,0 +1,25 @@
+#pragma once
+#include "Model.h"
+
+#include <string>
+#include <vector>
+
+/*
+* Native glTF 2.0(.gltf + .bin, .glb) import, without Assimp.
+* Buffers are mapped and accessors are read straight out of the mapping; 32-bit indices are handed over as spans into it.
+* Materials map from pbrMetallicRoughness; texture paths and factors of each primitive come along with its geometry.
+* Buffer views compressed by EXT_meshopt_compression are decoded on load, and KHR_mesh_quantization attributes are dequantized.
+* Returns false for content it does not handle(other required extensions, sparse accessors, data URIs, non triangle list primitives),
+* so caller can fall back to Assimp.
+**/
+class GLTFImporter
+{
+public:
+	static bool IsGLTF(const std::string& filePath);
+	/*
+	* Appends one mesh per primitive only if whole file was imported; safe to call from worker threads.
+	* Paths of external buffer files(.bin) which were read are appended to outDependencies if it is given.
+	**/
+	static bool Import(const std::string& filePath, const ModelLoadParams& params, std::vector<MeshImportData>& outMeshes, std::vector<std::string>* outDependencies = nullptr);
+
+};
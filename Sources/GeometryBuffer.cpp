@@ -0,0 +1,297 @@
+#include "GeometryBuffer.h"
+#include "GLStateCache.h"
+#include "StagingRingBuffer.h"
+
+#include <glm/packing.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <numeric>
+
+constexpr GLuint InitialVertexCapacity = 1 << 18;
+constexpr GLuint InitialIndexCapacity = 1 << 20;
+constexpr GLsizeiptr StagingSegmentSize = 8 << 20;
+
+EVertexFormat GeometryBuffer::s_vertexFormat = EVertexFormat::Float;
+std::vector<VertexPacked> GeometryBuffer::s_packedVertices;
+
+GLuint GeometryBuffer::s_vao = 0;
+GLuint GeometryBuffer::s_vbo = 0;
+GLuint GeometryBuffer::s_ebo = 0;
+GLuint GeometryBuffer::s_drawIndexBuffer = 0;
+StagingRingBuffer* GeometryBuffer::s_staging = nullptr;
+
+GLuint GeometryBuffer::s_vertexCapacity = 0;
+GLuint GeometryBuffer::s_indexCapacity = 0;
+GLuint GeometryBuffer::s_usedVertices = 0;
+GLuint GeometryBuffer::s_usedIndices = 0;
+std::vector<GeometryBuffer::Range> GeometryBuffer::s_freeVertexRanges;
+std::vector<GeometryBuffer::Range> GeometryBuffer::s_freeIndexRanges;
+
+size_t GeometryBuffer::s_allocatedVertices = 0;
+size_t GeometryBuffer::s_allocatedIndices = 0;
+
+/* Octahedral projection of unit vector, in [-1, 1] */
+static glm::vec2 EncodeOctahedral(const glm::vec3& vector)
+{
+	const float sum = glm::abs(vector.x) + glm::abs(vector.y) + glm::abs(vector.z);
+	if (sum == 0.0f)
+	{
+		return glm::vec2(0.0f);
+	}
+
+	const glm::vec3 projected = vector / sum;
+	if (projected.z >= 0.0f)
+	{
+		return glm::vec2(projected);
+	}
+
+	// Fold lower hemisphere over the diagonals
+	return glm::vec2(
+		(1.0f - glm::abs(projected.y)) * (projected.x >= 0.0f ? 1.0f : -1.0f),
+		(1.0f - glm::abs(projected.x)) * (projected.y >= 0.0f ? 1.0f : -1.0f));
+}
+
+void GeometryBuffer::SetVertexFormat(EVertexFormat format)
+{
+	if (s_vao != 0 && format != s_vertexFormat)
+	{
+		std::cout << "GeometryBuffer : Vertex format cannot be changed after first allocation" << std::endl;
+		return;
+	}
+
+	s_vertexFormat = format;
+}
+
+GLuint GeometryBuffer::GetVertexStride()
+{
+	return (s_vertexFormat == EVertexFormat::Packed) ? sizeof(VertexPacked) : sizeof(VertexPosTexNT);
+}
+
+std::vector<std::string> GeometryBuffer::GetShaderDefines()
+{
+	if (s_vertexFormat == EVertexFormat::Packed)
+	{
+		return { "PACKED_VERTEX" };
+	}
+
+	return { };
+}
+
+void GeometryBuffer::Init()
+{
+	if (s_vao != 0)
+	{
+		return;
+	}
+
+	glCreateVertexArrays(1, &s_vao);
+
+	if (s_vertexFormat == EVertexFormat::Packed)
+	{
+		glVertexArrayAttribFormat(s_vao, 0, 3, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(VertexPacked, Position));
+		glVertexArrayAttribFormat(s_vao, 1, 2, GL_HALF_FLOAT, GL_FALSE, offsetof(VertexPacked, TexCoord));
+		glVertexArrayAttribFormat(s_vao, 2, 2, GL_SHORT, GL_TRUE, offsetof(VertexPacked, Normal));
+		glVertexArrayAttribFormat(s_vao, 3, 2, GL_SHORT, GL_TRUE, offsetof(VertexPacked, Tangent));
+	}
+	else
+	{
+		glVertexArrayAttribFormat(s_vao, 0, 3, GL_FLOAT, GL_FALSE, offsetof(VertexPosTexNT, Position));
+		glVertexArrayAttribFormat(s_vao, 1, 2, GL_FLOAT, GL_FALSE, offsetof(VertexPosTexNT, TexCoord));
+		glVertexArrayAttribFormat(s_vao, 2, 3, GL_FLOAT, GL_FALSE, offsetof(VertexPosTexNT, Normal));
+		glVertexArrayAttribFormat(s_vao, 3, 3, GL_FLOAT, GL_FALSE, offsetof(VertexPosTexNT, Tangent));
+	}
+
+	for (GLuint attrib = 0; attrib < 4; ++attrib)
+	{
+		glVertexArrayAttribBinding(s_vao, attrib, 0);
+		glEnableVertexArrayAttrib(s_vao, attrib);
+	}
+
+	// Per draw index : instance rate attribute, so baseInstance of each command selects its own draw data
+	std::vector<GLuint> drawIndices(MaxDrawsPerSubmit);
+	std::iota(drawIndices.begin(), drawIndices.end(), 0);
+	glCreateBuffers(1, &s_drawIndexBuffer);
+	glNamedBufferStorage(s_drawIndexBuffer, sizeof(GLuint) * drawIndices.size(), drawIndices.data(), 0);
+
+	glVertexArrayAttribIFormat(s_vao, DrawIndexAttribLocation, 1, GL_UNSIGNED_INT, 0);
+	glVertexArrayAttribBinding(s_vao, DrawIndexAttribLocation, 1);
+	glEnableVertexArrayAttrib(s_vao, DrawIndexAttribLocation);
+	glVertexArrayVertexBuffer(s_vao, 1, s_drawIndexBuffer, 0, sizeof(GLuint));
+	glVertexArrayBindingDivisor(s_vao, 1, 1);
+
+	Reserve(s_vbo, s_vertexCapacity, InitialVertexCapacity, GetVertexStride());
+	Reserve(s_ebo, s_indexCapacity, InitialIndexCapacity, sizeof(GLuint));
+
+	s_staging = new StagingRingBuffer(StagingSegmentSize);
+}
+
+void GeometryBuffer::Reserve(GLuint& buffer, GLuint& capacity, GLuint required, GLuint elementSize)
+{
+	if (required <= capacity)
+	{
+		return;
+	}
+
+	const GLuint newCapacity = std::max(required, capacity * 2);
+	GLuint newBuffer = 0;
+	glCreateBuffers(1, &newBuffer);
+	glNamedBufferData(newBuffer, static_cast<GLsizeiptr>(newCapacity) * elementSize, nullptr, GL_STATIC_DRAW);
+	if (buffer != 0)
+	{
+		glCopyNamedBufferSubData(buffer, newBuffer, 0, 0, static_cast<GLsizeiptr>(capacity) * elementSize);
+		glDeleteBuffers(1, &buffer);
+	}
+
+	buffer = newBuffer;
+	capacity = newCapacity;
+
+	glVertexArrayVertexBuffer(s_vao, 0, s_vbo, 0, GetVertexStride());
+	glVertexArrayElementBuffer(s_vao, s_ebo);
+}
+
+GLuint GeometryBuffer::AllocateRange(std::vector<Range>& freeRanges, GLuint& used, GLuint size)
+{
+	for (auto itr = freeRanges.begin(); itr != freeRanges.end(); ++itr)
+	{
+		if (itr->Size >= size)
+		{
+			const GLuint offset = itr->Offset;
+			itr->Offset += size;
+			itr->Size -= size;
+			if (itr->Size == 0)
+			{
+				freeRanges.erase(itr);
+			}
+
+			return offset;
+		}
+	}
+
+	const GLuint offset = used;
+	used += size;
+	return offset;
+}
+
+void GeometryBuffer::FreeRange(std::vector<Range>& freeRanges, GLuint& used, GLuint offset, GLuint size)
+{
+	auto itr = std::lower_bound(freeRanges.begin(), freeRanges.end(), offset,
+		[](const Range& range, GLuint value) { return range.Offset < value; });
+	itr = freeRanges.insert(itr, Range{ offset, size });
+
+	// Coalesce with next, then previous
+	if (auto next = itr + 1; next != freeRanges.end() && itr->Offset + itr->Size == next->Offset)
+	{
+		itr->Size += next->Size;
+		freeRanges.erase(next);
+	}
+
+	if (itr != freeRanges.begin())
+	{
+		if (auto prev = itr - 1; prev->Offset + prev->Size == itr->Offset)
+		{
+			prev->Size += itr->Size;
+			itr = freeRanges.erase(itr) - 1;
+		}
+	}
+
+	// Give tail back to bump allocator
+	if (itr->Offset + itr->Size == used)
+	{
+		used = itr->Offset;
+		freeRanges.erase(itr);
+	}
+}
+
+VertexPacked GeometryBuffer::PackVertex(const VertexPosTexNT& vertex, const glm::vec3& offset, const glm::vec3& invScale)
+{
+	VertexPacked packed;
+	const glm::vec3 position = glm::clamp((vertex.Position - offset) * invScale, 0.0f, 1.0f) * 65535.0f + 0.5f;
+	packed.Position[0] = static_cast<uint16_t>(position.x);
+	packed.Position[1] = static_cast<uint16_t>(position.y);
+	packed.Position[2] = static_cast<uint16_t>(position.z);
+	packed.Padding = 0;
+
+	packed.TexCoord = glm::packHalf2x16(vertex.TexCoord);
+	packed.Normal = glm::packSnorm2x16(EncodeOctahedral(vertex.Normal));
+	packed.Tangent = glm::packSnorm2x16(EncodeOctahedral(vertex.Tangent));
+	return packed;
+}
+
+GeometryAllocation GeometryBuffer::Allocate(std::span<const VertexPosTexNT> vertices, std::span<const unsigned int> indices)
+{
+	Init();
+
+	GeometryAllocation allocation;
+	if (vertices.empty() || indices.empty())
+	{
+		return allocation;
+	}
+
+	allocation.VertexCount = static_cast<GLuint>(vertices.size());
+	allocation.IndexCount = static_cast<GLuint>(indices.size());
+	allocation.BaseVertex = static_cast<GLint>(AllocateRange(s_freeVertexRanges, s_usedVertices, allocation.VertexCount));
+	allocation.FirstIndex = AllocateRange(s_freeIndexRanges, s_usedIndices, allocation.IndexCount);
+
+	const GLuint stride = GetVertexStride();
+	Reserve(s_vbo, s_vertexCapacity, s_usedVertices, stride);
+	Reserve(s_ebo, s_indexCapacity, s_usedIndices, sizeof(GLuint));
+
+	if (s_vertexFormat == EVertexFormat::Packed)
+	{
+		// Positions are quantized in bounds of this mesh; shaders dequantize with offset and scale of DrawData
+		glm::vec3 boundsMin = vertices[0].Position;
+		glm::vec3 boundsMax = vertices[0].Position;
+		for (const auto& vertex : vertices)
+		{
+			boundsMin = glm::min(boundsMin, vertex.Position);
+			boundsMax = glm::max(boundsMax, vertex.Position);
+		}
+
+		const glm::vec3 extent = boundsMax - boundsMin;
+		const glm::vec3 invScale = glm::vec3(
+			(extent.x > 0.0f) ? (1.0f / extent.x) : 0.0f,
+			(extent.y > 0.0f) ? (1.0f / extent.y) : 0.0f,
+			(extent.z > 0.0f) ? (1.0f / extent.z) : 0.0f);
+		allocation.PositionOffset = boundsMin;
+		allocation.PositionScale = extent;
+
+		s_packedVertices.resize(vertices.size());
+		for (size_t idx = 0; idx < vertices.size(); ++idx)
+		{
+			s_packedVertices[idx] = PackVertex(vertices[idx], boundsMin, invScale);
+		}
+
+		s_staging->Upload(s_vbo, static_cast<GLintptr>(stride) * allocation.BaseVertex, s_packedVertices.data(), sizeof(VertexPacked) * s_packedVertices.size());
+	}
+	else
+	{
+		s_staging->Upload(s_vbo, static_cast<GLintptr>(stride) * allocation.BaseVertex, vertices.data(), vertices.size_bytes());
+	}
+
+	s_staging->Upload(s_ebo, sizeof(GLuint) * allocation.FirstIndex, indices.data(), indices.size_bytes());
+
+	s_allocatedVertices += allocation.VertexCount;
+	s_allocatedIndices += allocation.IndexCount;
+	return allocation;
+}
+
+void GeometryBuffer::Free(const GeometryAllocation& allocation)
+{
+	if (allocation.VertexCount == 0 || allocation.IndexCount == 0)
+	{
+		return;
+	}
+
+	FreeRange(s_freeVertexRanges, s_usedVertices, static_cast<GLuint>(allocation.BaseVertex), allocation.VertexCount);
+	FreeRange(s_freeIndexRanges, s_usedIndices, allocation.FirstIndex, allocation.IndexCount);
+
+	s_allocatedVertices -= allocation.VertexCount;
+	s_allocatedIndices -= allocation.IndexCount;
+}
+
+void GeometryBuffer::Bind()
+{
+	Init();
+	GLStateCache::BindVertexArray(s_vao);
+}
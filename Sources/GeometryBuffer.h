@@ -0,0 +1,104 @@
+#pragma once
+#include "Rendering.h"
+#include "Vertex.h"
+#include <span>
+#include <string>
+#include <vector>
+
+class StagingRingBuffer;
+
+/* Location of per draw index attribute; fed by baseInstance of each indirect command */
+constexpr GLuint DrawIndexAttribLocation = 4;
+/* Maximum draws of single multi draw call */
+constexpr unsigned int MaxDrawsPerSubmit = 65536;
+
+/* Layout defined by GL spec for indirect draws */
+struct DrawElementsIndirectCommand
+{
+	GLuint Count = 0;
+	GLuint InstanceCount = 0;
+	GLuint FirstIndex = 0;
+	GLint BaseVertex = 0;
+	GLuint BaseInstance = 0;
+};
+
+enum class EVertexFormat
+{
+	/* VertexPosTexNT as is, 44 bytes */
+	Float,
+	/* VertexPacked, 20 bytes; decoded by vertex shaders */
+	Packed
+};
+
+struct GeometryAllocation
+{
+	GLint BaseVertex = 0;
+	GLuint VertexCount = 0;
+	GLuint FirstIndex = 0;
+	GLuint IndexCount = 0;
+	/* Local position = PositionOffset + stored position * PositionScale; identity for float format */
+	glm::vec3 PositionOffset = glm::vec3(0.0f);
+	glm::vec3 PositionScale = glm::vec3(1.0f);
+};
+
+/*
+* Every static mesh suballocates its vertices and indices from one shared vertex/index buffer pair.
+* All of them are drawn through a single VAO, so a pass can be submitted with glMultiDrawElementsIndirect.
+* Buffers grow on demand; freed ranges are recycled by first-fit.
+* Uploads go through a persistently mapped staging ring instead of synchronous glNamedBufferSubData.
+* Vertex format is fixed for whole buffer; with packed format, vertices are quantized on upload.
+**/
+class GeometryBuffer
+{
+public:
+	/* Has to be set before first allocation and before shaders are created with GetShaderDefines */
+	static void SetVertexFormat(EVertexFormat format);
+	static EVertexFormat GetVertexFormat() { return s_vertexFormat; }
+	static GLuint GetVertexStride();
+	/* Defines which select vertex layout in VertexInput.glsl */
+	static std::vector<std::string> GetShaderDefines();
+
+	/* Spans may point straight into mapped file; data is copied once, into staging ring */
+	static GeometryAllocation Allocate(std::span<const VertexPosTexNT> vertices, std::span<const unsigned int> indices);
+	static void Free(const GeometryAllocation& allocation);
+
+	static void Bind();
+	static GLuint GetVAO() { return s_vao; }
+
+	static size_t GetAllocatedVertices() { return s_allocatedVertices; }
+	static size_t GetAllocatedIndices() { return s_allocatedIndices; }
+
+private:
+	struct Range
+	{
+		GLuint Offset = 0;
+		GLuint Size = 0;
+	};
+
+	static void Init();
+	static void Reserve(GLuint& buffer, GLuint& capacity, GLuint required, GLuint elementSize);
+	static GLuint AllocateRange(std::vector<Range>& freeRanges, GLuint& used, GLuint size);
+	static VertexPacked PackVertex(const VertexPosTexNT& vertex, const glm::vec3& offset, const glm::vec3& invScale);
+	static void FreeRange(std::vector<Range>& freeRanges, GLuint& used, GLuint offset, GLuint size);
+
+private:
+	static EVertexFormat s_vertexFormat;
+	static std::vector<VertexPacked> s_packedVertices;
+
+	static GLuint s_vao;
+	static GLuint s_vbo;
+	static GLuint s_ebo;
+	static GLuint s_drawIndexBuffer;
+	static StagingRingBuffer* s_staging;
+
+	static GLuint s_vertexCapacity;
+	static GLuint s_indexCapacity;
+	static GLuint s_usedVertices;
+	static GLuint s_usedIndices;
+	static std::vector<Range> s_freeVertexRanges;
+	static std::vector<Range> s_freeIndexRanges;
+
+	static size_t s_allocatedVertices;
+	static size_t s_allocatedIndices;
+
+};
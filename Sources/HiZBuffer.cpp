@@ -0,0 +1,69 @@
+#include "HiZBuffer.h"
+#include "Shader.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+
+constexpr unsigned int HiZGroupSize = 8;
+
+HiZBuffer::HiZBuffer(unsigned int width, unsigned int height) :
+	m_width(width),
+	m_height(height)
+{
+	for (unsigned int size = std::max(width, height); size > 0; size >>= 1)
+	{
+		++m_levels;
+	}
+
+	glCreateTextures(GL_TEXTURE_2D, 1, &m_texture);
+	glTextureStorage2D(m_texture, m_levels, GL_R32F, width, height);
+	glTextureParameteri(m_texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTextureParameteri(m_texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTextureParameteri(m_texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(m_texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	m_buildPass = new Shader("Resources/Shaders/HiZBuildCS.comp");
+}
+
+HiZBuffer::~HiZBuffer()
+{
+	GLStateCache::OnTextureDeleted(m_texture);
+	glDeleteTextures(1, &m_texture);
+	delete m_buildPass;
+}
+
+void HiZBuffer::Build(GLuint depthTexture)
+{
+	m_buildPass->Bind();
+	m_buildPass->SetInt("srcDepth", 0);
+
+	unsigned int srcWidth = m_width;
+	unsigned int srcHeight = m_height;
+	for (unsigned int level = 0; level < m_levels; ++level)
+	{
+		// Level 0 copies depth buffer, others reduce previous level of pyramid itself
+		const unsigned int dstWidth = std::max(m_width >> level, 1u);
+		const unsigned int dstHeight = std::max(m_height >> level, 1u);
+		GLStateCache::BindTexture(GL_TEXTURE_2D, 0, (level == 0) ? depthTexture : m_texture);
+		glBindImageTexture(0, m_texture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+		m_buildPass->SetInt("srcLevel", (level == 0) ? 0 : static_cast<int>(level - 1));
+		m_buildPass->SetInt("bCopy", (level == 0) ? 1 : 0);
+		m_buildPass->SetVec2f("srcSize", glm::vec2(srcWidth, srcHeight));
+		m_buildPass->SetVec2f("dstSize", glm::vec2(dstWidth, dstHeight));
+		m_buildPass->Dispatch((dstWidth + HiZGroupSize - 1) / HiZGroupSize, (dstHeight + HiZGroupSize - 1) / HiZGroupSize, 1);
+
+		// Next level reads this level through texture fetch
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+		srcWidth = dstWidth;
+		srcHeight = dstHeight;
+	}
+
+	glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0, 0);
+}
+
+void HiZBuffer::Bind(unsigned int slot)
+{
+	GLStateCache::BindTexture(GL_TEXTURE_2D, slot, m_texture);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "Rendering.h"
+
+class Shader;
+
+/* Texture unit of depth pyramid while GPU culling pass reads it */
+constexpr unsigned int HiZTextureUnit = 8;
+
+/*
+* Depth pyramid; each texel of level n holds farthest depth of texels it covers in level n-1.
+* Built by compute shader from depth buffer right after it is written(ex. depth prepass).
+* Box which is nearer than every depth it covers on the pyramid is occluded.
+**/
+class HiZBuffer
+{
+public:
+	HiZBuffer(unsigned int width, unsigned int height);
+	~HiZBuffer();
+
+	/* depthTexture : Sampleable depth texture of same size with level 0 */
+	void Build(GLuint depthTexture);
+	void Bind(unsigned int slot);
+
+	unsigned int GetWidth() const { return m_width; }
+	unsigned int GetHeight() const { return m_height; }
+	unsigned int GetLevels() const { return m_levels; }
+
+private:
+	unsigned int m_width = 0;
+	unsigned int m_height = 0;
+	unsigned int m_levels = 0;
+	GLuint m_texture = 0;
+	Shader* m_buildPass = nullptr;
+
+};
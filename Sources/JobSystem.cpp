@@ -0,0 +1,340 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+/* Worker index of current thread, valid only for the system which owns it */
+static thread_local const JobSystem* t_owner = nullptr;
+static thread_local int t_workerIdx = -1;
+
+JobSystem::JobSystem(unsigned int numWorkers) :
+	m_mainThreadId(std::this_thread::get_id())
+{
+	if (numWorkers == 0)
+	{
+		numWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	}
+
+	for (unsigned int idx = 0; idx < numWorkers; ++idx)
+	{
+		m_workers.push_back(new Worker());
+	}
+
+	// Every deque must exist before any worker starts stealing
+	for (unsigned int idx = 0; idx < numWorkers; ++idx)
+	{
+		m_workers[idx]->Thread = std::thread(&JobSystem::WorkerLoop, this, idx);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_bRunning = false;
+	}
+	m_wakeCondition.notify_all();
+
+	for (Worker* worker : m_workers)
+	{
+		worker->Thread.join();
+		delete worker;
+	}
+
+	m_workers.clear();
+}
+
+void JobSystem::Run(Job job, JobCounter* counter)
+{
+	if (counter != nullptr)
+	{
+		counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+		Push([job = std::move(job), counter]()
+		{
+			job();
+			counter->m_pending.fetch_sub(1, std::memory_order_release);
+		});
+	}
+	else
+	{
+		Push(std::move(job));
+	}
+}
+
+void JobSystem::ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body, JobCounter* counter)
+{
+	grainSize = std::max<size_t>(grainSize, 1);
+
+	JobCounter localCounter;
+	JobCounter* const groupCounter = (counter != nullptr) ? counter : &localCounter;
+
+	// Shared by every range instead of copying body into each job
+	const auto sharedBody = std::make_shared<std::function<void(size_t, size_t)>>(body);
+	for (size_t begin = 0; begin < count; begin += grainSize)
+	{
+		const size_t end = std::min(begin + grainSize, count);
+		Run([sharedBody, begin, end]() { (*sharedBody)(begin, end); }, groupCounter);
+	}
+
+	if (counter == nullptr)
+	{
+		Wait(localCounter);
+	}
+}
+
+void JobSystem::Wait(const JobCounter& counter)
+{
+	while (!counter.IsDone())
+	{
+		if (IsMainThread())
+		{
+			ProcessMainThreadJobs();
+		}
+
+		if (!TryExecute())
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::RunOnMainThread(Job job, JobCounter* counter)
+{
+	if (counter != nullptr)
+	{
+		counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+	if (counter != nullptr)
+	{
+		m_mainThreadJobs.push_back([job = std::move(job), counter]()
+		{
+			job();
+			counter->m_pending.fetch_sub(1, std::memory_order_release);
+		});
+	}
+	else
+	{
+		m_mainThreadJobs.push_back(std::move(job));
+	}
+}
+
+void JobSystem::ProcessMainThreadJobs(float budgetMs)
+{
+	if (!IsMainThread())
+	{
+		return;
+	}
+
+	const auto begin = std::chrono::high_resolution_clock::now();
+	while (true)
+	{
+		Job job;
+		{
+			std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+			if (m_mainThreadJobs.empty())
+			{
+				return;
+			}
+
+			job = std::move(m_mainThreadJobs.front());
+			m_mainThreadJobs.pop_front();
+		}
+
+		// Lock is released while running, so job may queue more main thread jobs
+		job();
+
+		if (budgetMs >= 0.0f)
+		{
+			const std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - begin;
+			if (elapsed.count() >= budgetMs)
+			{
+				return;
+			}
+		}
+	}
+}
+
+int JobSystem::GetCurrentWorker() const
+{
+	return (t_owner == this) ? t_workerIdx : -1;
+}
+
+void JobSystem::Push(Job job)
+{
+	if (m_workers.empty())
+	{
+		job();
+		return;
+	}
+
+	const int currentWorker = GetCurrentWorker();
+	const unsigned int queueIdx = (currentWorker >= 0) ?
+		static_cast<unsigned int>(currentWorker) :
+		m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+
+	{
+		std::lock_guard<std::mutex> lock(m_workers[queueIdx]->Mutex);
+		m_workers[queueIdx]->Jobs.push_back(std::move(job));
+	}
+
+	{
+		// Increment under sleep mutex, so worker which just checked the count cannot miss this wake up
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_queuedJobs.fetch_add(1, std::memory_order_relaxed);
+	}
+	m_wakeCondition.notify_one();
+}
+
+bool JobSystem::TryExecute()
+{
+	const size_t numWorkers = m_workers.size();
+	const int currentWorker = GetCurrentWorker();
+
+	Job job;
+	if (currentWorker >= 0)
+	{
+		Worker* worker = m_workers[currentWorker];
+		std::lock_guard<std::mutex> lock(worker->Mutex);
+		if (!worker->Jobs.empty())
+		{
+			job = std::move(worker->Jobs.back());
+			worker->Jobs.pop_back();
+		}
+	}
+
+	// Steal oldest job of others; it tends to be the largest piece of work
+	const size_t startIdx = (currentWorker >= 0) ? static_cast<size_t>(currentWorker) + 1 : m_nextQueue.load(std::memory_order_relaxed);
+	for (size_t offset = 0; !job && offset < numWorkers; ++offset)
+	{
+		Worker* victim = m_workers[(startIdx + offset) % numWorkers];
+		std::lock_guard<std::mutex> lock(victim->Mutex);
+		if (!victim->Jobs.empty())
+		{
+			job = std::move(victim->Jobs.front());
+			victim->Jobs.pop_front();
+		}
+	}
+
+	if (!job)
+	{
+		return false;
+	}
+
+	m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	job();
+	return true;
+}
+
+void JobSystem::WorkerLoop(unsigned int workerIdx)
+{
+	t_owner = this;
+	t_workerIdx = static_cast<int>(workerIdx);
+
+	while (m_bRunning.load(std::memory_order_relaxed))
+	{
+		if (!TryExecute())
+		{
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_wakeCondition.wait(lock, [this]()
+			{
+				return !m_bRunning.load(std::memory_order_relaxed) || m_queuedJobs.load(std::memory_order_relaxed) > 0;
+			});
+		}
+	}
+}
+
+void JobSystem::RunBenchmark()
+{
+	std::cout << "----   Job System   ----" << std::endl;
+
+	// Correctness; counters, nested jobs which wait on their children, main thread queue
+	{
+		JobSystem jobSystem;
+		constexpr size_t count = 1 << 20;
+		std::vector<uint32_t> values(count, 0);
+		jobSystem.ParallelFor(count, 4096, [&values](size_t begin, size_t end)
+		{
+			for (size_t idx = begin; idx < end; ++idx)
+			{
+				values[idx] = static_cast<uint32_t>(idx & 0xFF);
+			}
+		});
+
+		uint64_t sum = 0;
+		uint64_t expected = 0;
+		for (size_t idx = 0; idx < count; ++idx)
+		{
+			sum += values[idx];
+			expected += idx & 0xFF;
+		}
+
+		std::atomic<uint32_t> leafJobs = 0;
+		JobCounter parents;
+		for (int parent = 0; parent < 16; ++parent)
+		{
+			jobSystem.Run([&jobSystem, &leafJobs]()
+			{
+				JobCounter children;
+				for (int child = 0; child < 64; ++child)
+				{
+					jobSystem.Run([&leafJobs]() { leafJobs.fetch_add(1); }, &children);
+				}
+				jobSystem.Wait(children);
+			}, &parents);
+		}
+		jobSystem.Wait(parents);
+
+		bool bRanOnMainThread = false;
+		JobCounter mainThreadJobs;
+		jobSystem.Run([&jobSystem, &bRanOnMainThread, &mainThreadJobs]()
+		{
+			jobSystem.RunOnMainThread([&jobSystem, &bRanOnMainThread]() { bRanOnMainThread = jobSystem.IsMainThread(); }, &mainThreadJobs);
+		}, &mainThreadJobs);
+		jobSystem.Wait(mainThreadJobs);
+
+		const bool bPassed = (sum == expected) && (leafJobs.load() == 16 * 64) && bRanOnMainThread;
+		std::cout << "Self Test : " << (bPassed ? "Passed" : "FAILED") << " (Workers : " << jobSystem.GetWorkerCount() << ")" << std::endl;
+	}
+
+	// Scaling; compute bound parallel for, main thread helps while waiting
+	constexpr size_t count = 1 << 22;
+	std::vector<float> results(count);
+	auto body = [&results](size_t begin, size_t end)
+	{
+		for (size_t idx = begin; idx < end; ++idx)
+		{
+			float value = static_cast<float>(idx);
+			for (int iteration = 0; iteration < 16; ++iteration)
+			{
+				value = std::sqrt(value + 1.0f) * 1.0001f;
+			}
+			results[idx] = value;
+		}
+	};
+
+	const unsigned int maxWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	double baseTime = 0.0;
+	for (unsigned int numWorkers = 1; ; numWorkers = std::min(numWorkers * 2, maxWorkers))
+	{
+		JobSystem jobSystem(numWorkers);
+		const auto begin = std::chrono::high_resolution_clock::now();
+		jobSystem.ParallelFor(count, 16384, body);
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		const double elapsed = std::chrono::duration<double, std::milli>(end - begin).count();
+		baseTime = (numWorkers == 1) ? elapsed : baseTime;
+		std::cout << "Threads : " << (numWorkers + 1) << ", " << elapsed << " ms, Speedup : " << (baseTime / elapsed) << "x" << std::endl;
+
+		if (numWorkers == maxWorkers)
+		{
+			break;
+		}
+	}
+
+	std::cout << std::endl;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Number of unfinished jobs which were run with this counter; works as fence of the group */
+class JobCounter
+{
+public:
+	bool IsDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+	uint32_t GetPending() const { return m_pending.load(std::memory_order_acquire); }
+
+private:
+	friend class JobSystem;
+	std::atomic<uint32_t> m_pending = 0;
+
+};
+
+/*
+* Thread pool with one job deque per worker.
+* Worker pushes and pops its own deque at back(LIFO, cache warm), and steals from front of others when it runs dry.
+* Jobs from non-worker threads are spread over deques round robin.
+* Waiting thread runs jobs too instead of blocking, so jobs may wait on jobs they spawned.
+* GL calls are only valid on the thread which owns context; such work goes to main thread queue.
+**/
+class JobSystem
+{
+public:
+	using Job = std::function<void()>;
+
+	/* numWorkers 0 : Hardware threads - 1, since main thread also runs jobs while waiting */
+	explicit JobSystem(unsigned int numWorkers = 0);
+	~JobSystem();
+
+	void Run(Job job, JobCounter* counter = nullptr);
+	/*
+	* Splits [0, count) into ranges of grainSize and runs body(begin, end) for each of them.
+	* Without counter, returns after every range is done.
+	**/
+	void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body, JobCounter* counter = nullptr);
+	/* Runs other jobs(and main thread jobs, on main thread) until counter reaches zero */
+	void Wait(const JobCounter& counter);
+
+	/* Job is executed by ProcessMainThreadJobs of main thread, in queued order */
+	void RunOnMainThread(Job job, JobCounter* counter = nullptr);
+	/* Stops once budgetMs is spent, rest of jobs stay queued for next call; negative budget runs all */
+	void ProcessMainThreadJobs(float budgetMs = -1.0f);
+	bool IsMainThread() const { return std::this_thread::get_id() == m_mainThreadId; }
+
+	unsigned int GetWorkerCount() const { return static_cast<unsigned int>(m_workers.size()); }
+
+	/* Checks jobs, counters, nested waits and main thread queue, then prints parallel for scaling over worker counts */
+	static void RunBenchmark();
+
+private:
+	struct Worker
+	{
+		std::mutex Mutex;
+		std::deque<Job> Jobs;
+		std::thread Thread;
+	};
+
+	void WorkerLoop(unsigned int workerIdx);
+	void Push(Job job);
+	/* Pops from own deque(if worker), otherwise steals; false if every deque is empty */
+	bool TryExecute();
+	int GetCurrentWorker() const;
+
+private:
+	std::vector<Worker*> m_workers;
+	std::atomic<bool> m_bRunning = true;
+	std::atomic<uint32_t> m_queuedJobs = 0;
+	std::atomic<uint32_t> m_nextQueue = 0;
+
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wakeCondition;
+
+	std::mutex m_mainThreadMutex;
+	std::deque<Job> m_mainThreadJobs;
+	std::thread::id m_mainThreadId;
+
+};
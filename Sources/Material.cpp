@@ -1,9 +1,26 @@
 #include "Material.h"
 #include "Texture2D.h"
-#include "Shader.h"
+#include "MaterialTable.h"
 
 #include "GL/gl3w.h"
 
+unsigned int Material::s_nextID = 0;
+
+Material::Material() :
+	m_baseColor(nullptr),
+	m_metallicRoughness(nullptr),
+	m_emissive(nullptr),
+	m_ao(nullptr),
+	m_normal(nullptr),
+	m_baseColorFactor(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)),
+	m_metallicFactor(0.0f),
+	m_roughnessFactor(1.0f),
+	m_emissiveFactor(glm::vec3(0.0f, 0.0f, 0.0f)),
+	m_id(s_nextID++),
+	m_tableIndex(MaterialTable::Register(this))
+{
+}
+
 Material::Material(
 	Texture2D* baseColor,
 	glm::vec4 baseColorFactor,
@@ -22,121 +39,44 @@ Material::Material(
 	m_roughnessFactor(roughnessFactor),
 	m_ao(ao),
 	m_emissive(emissive),
-	m_emissiveFactor(emissiveFactor)
+	m_emissiveFactor(emissiveFactor),
+	m_id(s_nextID++),
+	m_tableIndex(MaterialTable::Register(this))
 {
 }
 
 Material::~Material()
 {
-	delete m_baseColor;
-	delete m_normal;
-	delete m_ao;
-	delete m_metallicRoughness;
-	delete m_emissive;
+	MaterialTable::Unregister(m_tableIndex);
+	Texture2D::Release(m_baseColor);
+	Texture2D::Release(m_normal);
+	Texture2D::Release(m_ao);
+	Texture2D::Release(m_metallicRoughness);
+	Texture2D::Release(m_emissive);
 }
 
-void Material::Bind(Shader* shader)
+void Material::ReplaceTexture(Texture2D*& slot, Texture2D* texture)
 {
-	if (shader != nullptr)
+	if (slot != texture)
 	{
-		if (m_baseColor != nullptr && !m_bForceBaseColorFactor)
-		{
-			m_baseColor->Bind(EMaterialTextureSlot::BaseColor);
-		}
-		else
-		{
-			shader->SetVec4f("baseColorFactor", m_baseColorFactor);
-		}
-		shader->SetInt("bOverrideBaseColor", m_bForceBaseColorFactor ? 1 : 0);
-		shader->SetInt("baseColorMap", EMaterialTextureSlot::BaseColor);
-
-		if (m_normal != nullptr)
-		{
-			m_normal->Bind(EMaterialTextureSlot::Normal);
-			shader->SetInt("bUseNormalMap", 1);
-		}
-		else
-		{
-			shader->SetInt("bUseNormalMap", 0);
-		}
-		shader->SetInt("normalMap", EMaterialTextureSlot::Normal);
-
-		if (m_metallicRoughness != nullptr && !m_bForceMetallicRoughnessFactor)
-		{
-			m_metallicRoughness->Bind(EMaterialTextureSlot::MetallicRoughness);
-		}
-		else
-		{
-			shader->SetFloat("metallicFactor", m_metallicFactor);
-			shader->SetFloat("roughnessFactor", m_roughnessFactor);
-		}
-		shader->SetInt("bOverrideMetallicRoughness", m_bForceMetallicRoughnessFactor ? 1 : 0);
-		shader->SetInt("metallicRoughnessMap", EMaterialTextureSlot::MetallicRoughness);
-
-		if (m_ao != nullptr)
-		{
-			m_ao->Bind(EMaterialTextureSlot::AO);
-		}
-
-		shader->SetInt("aoMap", EMaterialTextureSlot::AO);
-
-		if (m_emissive != nullptr && !m_bForceEmissiveFactor)
-		{
-			m_emissive->Bind(EMaterialTextureSlot::Emissive);
-		}
-		else
-		{
-			shader->SetVec3f("emissiveFactor", m_emissiveFactor);
-		}
-		shader->SetInt("bOverrideEmissive", m_bForceEmissiveFactor ? 1 : 0);
-		shader->SetInt("emissiveMap", EMaterialTextureSlot::Emissive);
-		shader->SetFloat("emissiveIntensity", m_emissiveIntensity);
-
-		if (bRefract)
-		{
-			shader->SetInt("isRefract", 1);
-		}
-		else
-		{
-			shader->SetInt("isRefract", 0);
-		}
-		shader->SetFloat("ior", IOR);
+		Texture2D::Release(slot);
+		slot = texture;
+		MarkDirty();
 	}
 }
 
-void Material::Unbind(Shader* shader)
+void Material::MarkDirty()
 {
-	if (shader != nullptr)
-	{
-		if (m_baseColor != nullptr)
-		{
-			m_baseColor->Unbind();
-		}
-
-		if (m_normal != nullptr)
-		{
-			m_normal->Unbind();
-		}
-
-		if (m_metallicRoughness != nullptr)
-		{
-			m_metallicRoughness->Unbind();
-		}
-
-		if (m_ao != nullptr)
-		{
-			m_ao->Unbind();
-		}
-
-		if (m_emissive != nullptr)
-		{
-			m_emissive->Unbind();
-		}
+	MaterialTable::MarkDirty(m_tableIndex);
+}
 
-		shader->SetVec4f("baseColorFactor", glm::vec4(0.0f));
-		shader->SetFloat("metallicFactor", 0.0f);
-		shader->SetFloat("roughnessFactor", 0.0f);
-		shader->SetVec3f("emissiveFactor", glm::vec3(0.0f));
-		shader->SetFloat("emissiveIntensity", 1.0f);
-	}
-}
\ No newline at end of file
+unsigned int Material::GetShaderFeatures() const
+{
+	unsigned int features = 0;
+	features |= m_bForceBaseColorFactor ? static_cast<unsigned int>(EMaterialFlag::OverrideBaseColor) : 0u;
+	features |= m_bForceMetallicRoughnessFactor ? static_cast<unsigned int>(EMaterialFlag::OverrideMetallicRoughness) : 0u;
+	features |= m_bForceEmissiveFactor ? static_cast<unsigned int>(EMaterialFlag::OverrideEmissive) : 0u;
+	features |= (m_normal != nullptr) ? static_cast<unsigned int>(EMaterialFlag::UseNormalMap) : 0u;
+	features |= m_bRefract ? static_cast<unsigned int>(EMaterialFlag::Refract) : 0u;
+	return features;
+}
@@ -15,22 +15,10 @@ enum EMaterialTexture
 using EMaterialTextureSlot = EMaterialTexture;
 
 class Texture2D;
-class Shader;
 class Material
 {
 public:
-	Material() :
-	m_baseColor(nullptr),
-	m_metallicRoughness(nullptr),
-	m_emissive(nullptr),
-	m_ao(nullptr),
-	m_normal(nullptr),
-	m_baseColorFactor(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)),
-	m_metallicFactor(0.0f),
-	m_roughnessFactor(1.0f),
-	m_emissiveFactor(glm::vec3(0.0f, 0.0f, 0.0f))
-	{
-	}
+	Material();
 
 	Material(
 		Texture2D* baseColor,
@@ -45,39 +33,52 @@ public:
 
 	~Material();
 
-	void Bind(Shader* shader);
-	void Unbind(Shader* shader);
-
-	void SetBaseColor(Texture2D* baseColor) { m_baseColor = baseColor; }
+	/* Texture setters take over one reference of texture and release the previous one; every setter marks its MaterialTable entry dirty */
+	void SetBaseColor(Texture2D* baseColor) { ReplaceTexture(m_baseColor, baseColor); }
 	Texture2D* GetBaseColor() const { return m_baseColor; }
 
-	void SetBaseColorFactor(const glm::vec4& factor) { m_baseColorFactor = factor; }
+	void SetBaseColorFactor(const glm::vec4& factor) { m_baseColorFactor = factor; MarkDirty(); }
 	glm::vec4 GetBaseColorFactor() const { return m_baseColorFactor; }
 
-	void SetNormal(Texture2D* normal) { m_normal = normal; }
+	void SetNormal(Texture2D* normal) { ReplaceTexture(m_normal, normal); }
 	Texture2D* GetNormal() const { return m_normal; }
 
-	void SetMetallicRoughness(Texture2D* metallicRoughness) { m_metallicRoughness = metallicRoughness; }
+	void SetMetallicRoughness(Texture2D* metallicRoughness) { ReplaceTexture(m_metallicRoughness, metallicRoughness); }
 	Texture2D* GetMetallicRoughness() const { return m_metallicRoughness; }
 
-	void SetMetallicFactor(float factor) { m_metallicFactor = factor; }
+	void SetMetallicFactor(float factor) { m_metallicFactor = factor; MarkDirty(); }
 	float GetMetallicFactor() const { return m_metallicFactor; }
 
-	void SetRoughnessFactor(float factor) { m_roughnessFactor = factor; }
+	void SetRoughnessFactor(float factor) { m_roughnessFactor = factor; MarkDirty(); }
 	float GetRoughnessFactor() const { return m_roughnessFactor; }
 
-	void SetAmbientOcclusion(Texture2D* ao) { m_ao = ao; }
+	void SetAmbientOcclusion(Texture2D* ao) { ReplaceTexture(m_ao, ao); }
 	Texture2D* GetAmbientOcclusion() const { return m_ao; }
 
-	void SetEmissive(Texture2D* emissive) { m_emissive = emissive; }
+	void SetEmissive(Texture2D* emissive) { ReplaceTexture(m_emissive, emissive); }
 	Texture2D* GetEmissive() const { return m_emissive; }
 
-	void SetEmissiveFactor(const glm::vec3& factor) { m_emissiveFactor = factor; }
+	void SetEmissiveFactor(const glm::vec3& factor) { m_emissiveFactor = factor; MarkDirty(); }
 	glm::vec3 GetEmissiveFactor() const { return m_emissiveFactor; }
 
-	void SetEmissiveIntensity(float factor) { m_emissiveIntensity = factor; }
+	void SetEmissiveIntensity(float factor) { m_emissiveIntensity = factor; MarkDirty(); }
 	float GetEmissiveIntensity() const { return m_emissiveIntensity; }
 
+	bool IsForcedFactor(EMaterialTexture type) const
+	{
+		switch (type)
+		{
+		case EMaterialTexture::BaseColor:
+			return m_bForceBaseColorFactor;
+		case EMaterialTexture::MetallicRoughness:
+			return m_bForceMetallicRoughnessFactor;
+		case EMaterialTexture::Emissive:
+			return m_bForceEmissiveFactor;
+		default:
+			return false;
+		}
+	}
+
 	void SetForceFactor(EMaterialTexture type, bool bForce)
 	{
 	   switch (type)
@@ -92,14 +93,29 @@ public:
 			m_bForceEmissiveFactor = bForce;
 			break;
 	   }
+
+	   MarkDirty();
 	}
 
+	void SetIOR(float ior) { m_ior = ior; MarkDirty(); }
+	float GetIOR() const { return m_ior; }
+
+	void SetRefract(bool bRefract) { m_bRefract = bRefract; MarkDirty(); }
+	bool IsRefract() const { return m_bRefract; }
+
 	void SetName(std::string_view name) { m_name = name; }
 	std::string_view GetName() const { return m_name; }
 
-public:
-	float IOR = 1.0f;
-	bool bRefract = false;
+	/* Unique per material instance, used as sort key of render queue */
+	unsigned int GetID() const { return m_id; }
+	/* Index of material in MaterialTable; each draw references its material through this */
+	unsigned int GetTableIndex() const { return m_tableIndex; }
+	/* EMaterialFlag bits of this material; selects material shader permutation */
+	unsigned int GetShaderFeatures() const;
+
+private:
+	void ReplaceTexture(Texture2D*& slot, Texture2D* texture);
+	void MarkDirty();
 
 private:
 	std::string m_name = "UnknownMaterial";
@@ -121,4 +137,11 @@ private:
 
 	Texture2D* m_normal;
 
+	float m_ior = 1.0f;
+	bool m_bRefract = false;
+
+	unsigned int m_id;
+	unsigned int m_tableIndex;
+	static unsigned int s_nextID;
+
 };
\ No newline at end of file
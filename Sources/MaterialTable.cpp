@@ -0,0 +1,323 @@
+#include "MaterialTable.h"
+#include "Material.h"
+#include "Texture2D.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+bool MaterialTable::s_bBindless = false;
+GLuint MaterialTable::s_buffer = 0;
+GLsizeiptr MaterialTable::s_bufferSize = 0;
+std::vector<Material*> MaterialTable::s_materials;
+std::vector<GLuint> MaterialTable::s_freeIndices;
+std::vector<MaterialGPUData> MaterialTable::s_packed;
+size_t MaterialTable::s_dirtyBegin = 0;
+size_t MaterialTable::s_dirtyEnd = 0;
+
+std::unordered_map<GLuint, GLuint64> MaterialTable::s_textureReferences;
+
+GLuint MaterialTable::s_textureArray = 0;
+GLuint MaterialTable::s_textureArrayLayers = 0;
+GLuint MaterialTable::s_usedTextureArrayLayers = 0;
+std::vector<GLuint> MaterialTable::s_freeTextureArrayLayers;
+GLuint MaterialTable::s_copyFramebuffers[2] = { 0, 0 };
+bool MaterialTable::s_bTextureArrayDirty = false;
+
+void MaterialTable::Init()
+{
+	if (s_buffer != 0)
+	{
+		return;
+	}
+
+	GLint numExtensions = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+	for (GLint idx = 0; idx < numExtensions; ++idx)
+	{
+		const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, idx));
+		if (extension != nullptr && std::strcmp(extension, "GL_ARB_bindless_texture") == 0)
+		{
+			s_bBindless = true;
+			break;
+		}
+	}
+
+	glCreateBuffers(1, &s_buffer);
+	if (s_bBindless)
+	{
+		std::cout << "MaterialTable : Using bindless textures" << std::endl;
+	}
+	else
+	{
+		glCreateFramebuffers(2, s_copyFramebuffers);
+		std::cout << "MaterialTable : ARB_bindless_texture is not supported, fallback to texture array" << std::endl;
+	}
+}
+
+GLuint MaterialTable::Register(Material* material)
+{
+	if (!s_freeIndices.empty())
+	{
+		const GLuint index = s_freeIndices.back();
+		s_freeIndices.pop_back();
+		s_materials[index] = material;
+		MarkDirty(index);
+		return index;
+	}
+
+	s_materials.push_back(material);
+	const GLuint index = static_cast<GLuint>(s_materials.size() - 1);
+	MarkDirty(index);
+	return index;
+}
+
+void MaterialTable::Unregister(GLuint index)
+{
+	if (index < s_materials.size())
+	{
+		s_materials[index] = nullptr;
+		s_freeIndices.push_back(index);
+		MarkDirty(index);
+	}
+}
+
+void MaterialTable::MarkDirty(GLuint index)
+{
+	if (s_dirtyBegin >= s_dirtyEnd)
+	{
+		s_dirtyBegin = index;
+		s_dirtyEnd = static_cast<size_t>(index) + 1;
+		return;
+	}
+
+	s_dirtyBegin = std::min<size_t>(s_dirtyBegin, index);
+	s_dirtyEnd = std::max<size_t>(s_dirtyEnd, static_cast<size_t>(index) + 1);
+}
+
+void MaterialTable::MarkAllDirty()
+{
+	s_dirtyBegin = 0;
+	s_dirtyEnd = s_materials.size();
+}
+
+std::vector<std::string> MaterialTable::GetFeatureDefines()
+{
+	// Ordered by bit of EMaterialFlag
+	return {
+		"MATERIAL_OVERRIDE_BASE_COLOR",
+		"MATERIAL_OVERRIDE_METALLIC_ROUGHNESS",
+		"MATERIAL_OVERRIDE_EMISSIVE",
+		"MATERIAL_USE_NORMAL_MAP",
+		"MATERIAL_REFRACT" };
+}
+
+std::vector<std::string> MaterialTable::GetShaderDefines()
+{
+	if (s_bBindless)
+	{
+		return { "BINDLESS_MATERIALS" };
+	}
+
+	return { };
+}
+
+void MaterialTable::ReserveTextureArray(GLuint layers)
+{
+	if (layers <= s_textureArrayLayers)
+	{
+		return;
+	}
+
+	const GLuint newLayers = std::max({ layers, s_textureArrayLayers * 2, 16u });
+	const GLsizei levels = static_cast<GLsizei>(std::log2(MaterialTextureArrayRes)) + 1;
+
+	GLuint newArray = 0;
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &newArray);
+	glTextureStorage3D(newArray, levels, GL_RGBA8, MaterialTextureArrayRes, MaterialTextureArrayRes, newLayers);
+	glTextureParameteri(newArray, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTextureParameteri(newArray, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTextureParameteri(newArray, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTextureParameteri(newArray, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	if (s_textureArray != 0)
+	{
+		glCopyImageSubData(
+			s_textureArray, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+			newArray, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+			MaterialTextureArrayRes, MaterialTextureArrayRes, s_textureArrayLayers);
+		GLStateCache::OnTextureDeleted(s_textureArray);
+		glDeleteTextures(1, &s_textureArray);
+	}
+
+	s_textureArray = newArray;
+	s_textureArrayLayers = newLayers;
+	s_bTextureArrayDirty = true;
+}
+
+void MaterialTable::CopyToTextureArray(GLuint texture, GLuint layer)
+{
+	GLint width = 0;
+	GLint height = 0;
+	glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_WIDTH, &width);
+	glGetTextureLevelParameteriv(texture, 0, GL_TEXTURE_HEIGHT, &height);
+
+	// Rescale into fixed resolution layer
+	glNamedFramebufferTexture(s_copyFramebuffers[0], GL_COLOR_ATTACHMENT0, texture, 0);
+	glNamedFramebufferTextureLayer(s_copyFramebuffers[1], GL_COLOR_ATTACHMENT0, s_textureArray, 0, layer);
+	glNamedFramebufferReadBuffer(s_copyFramebuffers[0], GL_COLOR_ATTACHMENT0);
+	glNamedFramebufferDrawBuffer(s_copyFramebuffers[1], GL_COLOR_ATTACHMENT0);
+	glBlitNamedFramebuffer(
+		s_copyFramebuffers[0], s_copyFramebuffers[1],
+		0, 0, width, height,
+		0, 0, MaterialTextureArrayRes, MaterialTextureArrayRes,
+		GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+	s_bTextureArrayDirty = true;
+}
+
+GLuint64 MaterialTable::GetTextureReference(GLuint texture)
+{
+	if (texture == 0)
+	{
+		return 0;
+	}
+
+	if (const auto found = s_textureReferences.find(texture); found != s_textureReferences.end())
+	{
+		return found->second;
+	}
+
+	GLuint64 reference = 0;
+	if (s_bBindless)
+	{
+		reference = glGetTextureHandleARB(texture);
+		glMakeTextureHandleResidentARB(reference);
+	}
+	else
+	{
+		GLuint layer = s_usedTextureArrayLayers;
+		if (!s_freeTextureArrayLayers.empty())
+		{
+			layer = s_freeTextureArrayLayers.back();
+			s_freeTextureArrayLayers.pop_back();
+		}
+		else
+		{
+			++s_usedTextureArrayLayers;
+		}
+
+		ReserveTextureArray(layer + 1);
+		CopyToTextureArray(texture, layer);
+		reference = layer + 1;
+	}
+
+	s_textureReferences[texture] = reference;
+	return reference;
+}
+
+void MaterialTable::ReleaseTextureReference(GLuint texture)
+{
+	const auto found = s_textureReferences.find(texture);
+	if (found == s_textureReferences.end())
+	{
+		return;
+	}
+
+	if (s_bBindless)
+	{
+		glMakeTextureHandleNonResidentARB(found->second);
+	}
+	else
+	{
+		s_freeTextureArrayLayers.push_back(static_cast<GLuint>(found->second - 1));
+	}
+
+	s_textureReferences.erase(found);
+}
+
+MaterialGPUData MaterialTable::Pack(const Material* material)
+{
+	MaterialGPUData data;
+	if (material == nullptr)
+	{
+		return data;
+	}
+
+	const bool bForceBaseColor = material->IsForcedFactor(EMaterialTexture::BaseColor);
+	const bool bForceMetallicRoughness = material->IsForcedFactor(EMaterialTexture::MetallicRoughness);
+	const bool bForceEmissive = material->IsForcedFactor(EMaterialTexture::Emissive);
+
+	// Factors are only effective when texture is not used, same as previous per draw uniform binding
+	const Texture2D* baseColor = bForceBaseColor ? nullptr : material->GetBaseColor();
+	const Texture2D* metallicRoughness = bForceMetallicRoughness ? nullptr : material->GetMetallicRoughness();
+	const Texture2D* emissive = bForceEmissive ? nullptr : material->GetEmissive();
+	const Texture2D* normal = material->GetNormal();
+	const Texture2D* ao = material->GetAmbientOcclusion();
+
+	data.BaseColorFactor = (baseColor == nullptr) ? material->GetBaseColorFactor() : glm::vec4(0.0f);
+	data.MetallicFactor = (metallicRoughness == nullptr) ? material->GetMetallicFactor() : 0.0f;
+	data.RoughnessFactor = (metallicRoughness == nullptr) ? material->GetRoughnessFactor() : 0.0f;
+	data.EmissiveFactor = glm::vec4((emissive == nullptr) ? material->GetEmissiveFactor() : glm::vec3(0.0f), material->GetEmissiveIntensity());
+	data.IOR = material->GetIOR();
+
+	data.Flags = material->GetShaderFeatures();
+
+	data.Textures[EMaterialTexture::BaseColor] = (baseColor != nullptr) ? GetTextureReference(baseColor->GetID()) : 0;
+	data.Textures[EMaterialTexture::Normal] = (normal != nullptr) ? GetTextureReference(normal->GetID()) : 0;
+	data.Textures[EMaterialTexture::MetallicRoughness] = (metallicRoughness != nullptr) ? GetTextureReference(metallicRoughness->GetID()) : 0;
+	data.Textures[EMaterialTexture::AO] = (ao != nullptr) ? GetTextureReference(ao->GetID()) : 0;
+	data.Textures[EMaterialTexture::Emissive] = (emissive != nullptr) ? GetTextureReference(emissive->GetID()) : 0;
+	return data;
+}
+
+void MaterialTable::Update()
+{
+	Init();
+
+	// Empty table still needs a valid buffer to bind
+	const size_t materialCount = std::max<size_t>(s_materials.size(), 1);
+	if (s_packed.size() < materialCount)
+	{
+		s_packed.resize(materialCount);
+	}
+
+	const size_t dirtyEnd = std::min(s_dirtyEnd, s_materials.size());
+	const size_t dirtyBegin = s_dirtyBegin;
+	for (size_t idx = dirtyBegin; idx < dirtyEnd; ++idx)
+	{
+		// Packing may add texture array layers, so mipmaps are regenerated below
+		s_packed[idx] = Pack(s_materials[idx]);
+	}
+
+	s_dirtyBegin = 0;
+	s_dirtyEnd = 0;
+
+	if (s_bTextureArrayDirty)
+	{
+		glGenerateTextureMipmap(s_textureArray);
+		s_bTextureArrayDirty = false;
+	}
+
+	const GLsizeiptr size = sizeof(MaterialGPUData) * s_packed.size();
+	if (size > s_bufferSize)
+	{
+		glNamedBufferData(s_buffer, size, s_packed.data(), GL_DYNAMIC_DRAW);
+		s_bufferSize = size;
+	}
+	else if (dirtyBegin < dirtyEnd)
+	{
+		glNamedBufferSubData(s_buffer, sizeof(MaterialGPUData) * dirtyBegin, sizeof(MaterialGPUData) * (dirtyEnd - dirtyBegin), s_packed.data() + dirtyBegin);
+	}
+}
+
+void MaterialTable::Bind()
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MaterialTableBinding, s_buffer);
+	if (!s_bBindless)
+	{
+		GLStateCache::BindTexture(GL_TEXTURE_2D_ARRAY, MaterialTextureArraySlot, s_textureArray);
+	}
+}
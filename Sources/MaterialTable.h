@@ -0,0 +1,101 @@
+#pragma once
+#include "Rendering.h"
+#include "glm/glm.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+class Material;
+
+/* SSBO binding point of material table */
+constexpr GLuint MaterialTableBinding = 1;
+/* Texture unit of material texture array, only used without bindless texture */
+constexpr unsigned int MaterialTextureArraySlot = 7;
+constexpr GLsizei MaterialTextureArrayRes = 512;
+
+enum EMaterialFlag : GLuint
+{
+	OverrideBaseColor = 1 << 0,
+	OverrideMetallicRoughness = 1 << 1,
+	OverrideEmissive = 1 << 2,
+	UseNormalMap = 1 << 3,
+	Refract = 1 << 4
+};
+
+/* Number of EMaterialFlag bits, which are also material shader permutation features */
+constexpr unsigned int MaterialFeatureCount = 5;
+
+/*
+* std430 layout of 'MaterialData' in shaders.
+* Textures : Bindless handle, or (layer + 1) of material texture array. Zero means no texture.
+**/
+struct MaterialGPUData
+{
+	glm::vec4 BaseColorFactor = glm::vec4(0.0f);
+	glm::vec4 EmissiveFactor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f); // w : Intensity
+	float MetallicFactor = 0.0f;
+	float RoughnessFactor = 0.0f;
+	float IOR = 1.0f;
+	GLuint Flags = 0;
+	GLuint64 Textures[5] = { 0, 0, 0, 0, 0 };
+	GLuint64 Padding = 0;
+};
+
+/*
+* Every material lives in a single SSBO, so a draw only carries its material index.
+* Textures are referenced by ARB_bindless_texture handles, or through a shared texture array where bindless is missing.
+**/
+class MaterialTable
+{
+public:
+	/* Must be called after GL context creation, before compiling material shaders */
+	static void Init();
+
+	static GLuint Register(Material* material);
+	static void Unregister(GLuint index);
+
+	/* Drops bindless handle or array layer of texture which is being deleted */
+	static void ReleaseTextureReference(GLuint texture);
+
+	/* Material at index is re-packed by next Update */
+	static void MarkDirty(GLuint index);
+	/* Every material is re-packed by next Update; texture references may have changed(ex. streamed texture became resident) */
+	static void MarkAllDirty();
+
+	/* Re-packs dirty range of materials into persistent array and uploads only that range */
+	static void Update();
+	static void Bind();
+
+	static bool IsBindless() { return s_bBindless; }
+	/* Defines which material shaders have to be compiled with */
+	static std::vector<std::string> GetShaderDefines();
+	/* Permutation define of each EMaterialFlag bit; resolved at compile time where 'MATERIAL_PERMUTATION' is defined */
+	static std::vector<std::string> GetFeatureDefines();
+
+private:
+	static MaterialGPUData Pack(const Material* material);
+	static GLuint64 GetTextureReference(GLuint texture);
+	static void CopyToTextureArray(GLuint texture, GLuint layer);
+	static void ReserveTextureArray(GLuint layers);
+
+private:
+	static bool s_bBindless;
+	static GLuint s_buffer;
+	static GLsizeiptr s_bufferSize;
+	static std::vector<Material*> s_materials;
+	static std::vector<GLuint> s_freeIndices;
+	static std::vector<MaterialGPUData> s_packed;
+	/* Dirty range [begin, end) of s_packed; empty if begin >= end */
+	static size_t s_dirtyBegin;
+	static size_t s_dirtyEnd;
+
+	static std::unordered_map<GLuint, GLuint64> s_textureReferences;
+
+	static GLuint s_textureArray;
+	static GLuint s_textureArrayLayers;
+	static GLuint s_usedTextureArrayLayers;
+	static std::vector<GLuint> s_freeTextureArrayLayers;
+	static GLuint s_copyFramebuffers[2];
+	static bool s_bTextureArrayDirty;
+
+};
@@ -1,49 +1,68 @@
 #include "Mesh.h"
 #include "Material.h"
-#include "Shader.h"
 #include "Rendering.h"
+#include "GLStateCache.h"
 
-Mesh::Mesh(std::vector<VertexPosTexNT> vertices, std::vector<unsigned int> indices, Material* material, AABB boundingBox) :
-m_material(material),
-m_vbo(0),
-m_vao(0),
-m_ebo(0),
-m_count(indices.size()),
+MeshGeometry::MeshGeometry(std::span<const VertexPosTexNT> vertices, std::span<const unsigned int> indices, AABB boundingBox) :
+m_allocation(GeometryBuffer::Allocate(vertices, indices)),
 m_boundingBox(boundingBox)
 {
-	glGenBuffers(1, &m_vbo);
-	glGenBuffers(1, &m_ebo);
-	glGenVertexArrays(1, &m_vao);
+}
 
-	glBindVertexArray(m_vao);
+MeshGeometry::~MeshGeometry()
+{
+	GeometryBuffer::Free(m_allocation);
+}
 
-	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(VertexPosTexNT) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexPosTexNT), reinterpret_cast<void*>(0));
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(VertexPosTexNT), reinterpret_cast<void*>(sizeof(VertexPosTexNT::Position)));
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(VertexPosTexNT), reinterpret_cast<void*>(sizeof(VertexPosTexNT::Position) + sizeof(VertexPosTexNT::TexCoord)));
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(VertexPosTexNT), reinterpret_cast<void*>(sizeof(VertexPosTexNT::Position) + sizeof(VertexPosTexNT::TexCoord) + sizeof(VertexPosTexNT::Tangent)));
-	glEnableVertexAttribArray(3);
+void MeshGeometry::Release(MeshGeometry* geometry)
+{
+	if (geometry != nullptr && --geometry->m_refCount == 0)
+	{
+		delete geometry;
+	}
+}
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indices.size(), indices.data(), GL_STATIC_DRAW);
+Mesh::Mesh(std::span<const VertexPosTexNT> vertices, std::span<const unsigned int> indices, Material* material, AABB boundingBox) :
+m_material(material),
+m_geometry(new MeshGeometry(vertices, indices, boundingBox))
+{
+}
 
-	glBindVertexArray(0);
+Mesh::Mesh(MeshGeometry* geometry, Material* material) :
+m_material(material),
+m_geometry(geometry)
+{
+	m_geometry->AddRef();
 }
 
-void Mesh::Render(Shader* shader, GLenum mode)
+Mesh::~Mesh()
 {
-	if (m_material != nullptr)
-	{
-		m_material->Bind(shader);
-		glBindVertexArray(m_vao);
+	MeshGeometry::Release(m_geometry);
+}
 
-		glDrawElements(mode, m_count, GL_UNSIGNED_INT, nullptr);
 
-		glBindVertexArray(0);
-		m_material->Unbind(shader);
-	}
+void Mesh::Draw(GLenum mode, GLuint drawIndex)
+{
+	const GeometryAllocation& allocation = m_geometry->GetAllocation();
+	GeometryBuffer::Bind();
+	glDrawElementsInstancedBaseVertexBaseInstance(
+		mode,
+		allocation.IndexCount,
+		GL_UNSIGNED_INT,
+		reinterpret_cast<void*>(sizeof(GLuint) * allocation.FirstIndex),
+		1,
+		allocation.BaseVertex,
+		drawIndex);
+}
+
+DrawElementsIndirectCommand Mesh::GetIndirectCommand(GLuint drawIndex) const
+{
+	const GeometryAllocation& allocation = m_geometry->GetAllocation();
+	DrawElementsIndirectCommand command;
+	command.Count = allocation.IndexCount;
+	command.InstanceCount = 1;
+	command.FirstIndex = allocation.FirstIndex;
+	command.BaseVertex = allocation.BaseVertex;
+	command.BaseInstance = drawIndex;
+	return command;
 }
\ No newline at end of file
@@ -1,28 +1,61 @@
 #pragma once
-#include <vector>
+#include <span>
 #include "Rendering.h"
 #include "AABB.h"
 #include "Vertex.h"
+#include "GeometryBuffer.h"
+
+/*
+* Immutable vertices and indices suballocated from GeometryBuffer.
+* Shared by every Mesh drawing it; created with one reference and freed by the last Release.
+**/
+class MeshGeometry
+{
+public:
+	MeshGeometry(std::span<const VertexPosTexNT> vertices, std::span<const unsigned int> indices, AABB boundingBox);
+
+	void AddRef() { ++m_refCount; }
+	static void Release(MeshGeometry* geometry);
+	unsigned int GetRefCount() const { return m_refCount; }
+
+	const GeometryAllocation& GetAllocation() const { return m_allocation; }
+	AABB GetBoundingBox() const { return m_boundingBox; }
+
+private:
+	~MeshGeometry();
+
+private:
+	GeometryAllocation m_allocation;
+	AABB m_boundingBox;
+	unsigned int m_refCount = 1;
+
+};
 
 class Material;
-class Shader;
 class Mesh
 {
 public:
-	Mesh(std::vector<VertexPosTexNT> vertices, std::vector<unsigned int> indices, Material* material, AABB boundingBox);
-	void Render(Shader* shader, GLenum mode = GL_TRIANGLES);
+	/* Uploads vertices and indices as its own geometry; nothing is kept on CPU */
+	Mesh(std::span<const VertexPosTexNT> vertices, std::span<const unsigned int> indices, Material* material, AABB boundingBox);
+	/* Draws shared geometry with its own material; takes one more reference of geometry */
+	Mesh(MeshGeometry* geometry, Material* material);
+	~Mesh();
+
+	/* Draws only geometry, draw data of drawIndex has to be bound by caller */
+	void Draw(GLenum mode = GL_TRIANGLES, GLuint drawIndex = 0);
+	DrawElementsIndirectCommand GetIndirectCommand(GLuint drawIndex) const;
+
+	Material* GetMaterial() const { return m_material; }
+
+	MeshGeometry* GetGeometry() const { return m_geometry; }
 
 	AABB GetBoundingBox() const
 	{
-		return m_boundingBox;
+		return m_geometry->GetBoundingBox();
 	}
 
 private:
 	Material*	 m_material;
-	unsigned int m_vbo;
-	unsigned int m_vao;
-	unsigned int m_ebo;
-	unsigned int m_count;
-	AABB m_boundingBox;
+	MeshGeometry* m_geometry;
 
 };
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "MeshBinaryCache.h"
+#include "MappedFile.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+constexpr uint32_t MeshCacheMagic = 0x4348534D; // 'MSHC'
+constexpr uint32_t MeshCacheVersion = 3;
+/* Every block starts on this boundary, so spans into mapping are properly aligned */
+constexpr uint64_t MeshCacheAlignment = 16;
+constexpr size_t MeshCacheStringCount = 6; // Name + texture paths
+
+struct MeshCacheHeader
+{
+	uint32_t Magic = MeshCacheMagic;
+	uint32_t Version = MeshCacheVersion;
+	uint32_t ParamBits = 0;
+	uint32_t VertexStride = sizeof(VertexPosTexNT);
+	uint64_t SourceSize = 0;
+	int64_t SourceWriteTime = 0;
+	uint32_t MeshCount = 0;
+	uint32_t DependencyCount = 0;
+	uint32_t Padding[2] = { 0, 0 };
+};
+
+/* Follows records; paths are stored back to back after the table */
+struct MeshCacheDependency
+{
+	uint64_t Size = 0;
+	int64_t WriteTime = 0;
+	uint64_t PathOffset = 0;
+	uint32_t PathLength = 0;
+	uint32_t Padding = 0;
+};
+
+struct MeshCacheRecord
+{
+	glm::vec3 BoundsMin = glm::vec3(0.0f);
+	uint32_t VertexCount = 0;
+	glm::vec3 BoundsMax = glm::vec3(0.0f);
+	uint32_t IndexCount = 0;
+	uint64_t VertexOffset = 0;
+	uint64_t IndexOffset = 0;
+	/* Name and texture paths, stored back to back without terminator */
+	uint64_t StringOffset = 0;
+	uint32_t StringLengths[MeshCacheStringCount] = { 0, 0, 0, 0, 0, 0 };
+	/* MaterialFactors */
+	glm::vec4 BaseColorFactor = glm::vec4(1.0f);
+	glm::vec3 EmissiveFactor = glm::vec3(0.0f);
+	float MetallicFactor = 1.0f;
+	float RoughnessFactor = 1.0f;
+	uint32_t bHasFactors = 0;
+	uint32_t Padding[2] = { 0, 0 };
+};
+
+static_assert(sizeof(MeshCacheHeader) % MeshCacheAlignment == 0, "Header must keep alignment of following blocks");
+static_assert(sizeof(MeshCacheRecord) % MeshCacheAlignment == 0, "Record must keep alignment of following blocks");
+static_assert(sizeof(MeshCacheDependency) % MeshCacheAlignment == 0, "Dependency must keep alignment of following blocks");
+
+static uint64_t AlignOffset(uint64_t offset)
+{
+	return (offset + MeshCacheAlignment - 1) & ~(MeshCacheAlignment - 1);
+}
+
+uint32_t MeshBinaryCache::EncodeParams(const ModelLoadParams& params)
+{
+	return (params.CalcTangentSpace ? 1u << 0 : 0) |
+		(params.ConvertToLeftHanded ? 1u << 1 : 0) |
+		(params.GenSmoothNormals ? 1u << 2 : 0) |
+		(params.GenUVs ? 1u << 3 : 0) |
+		(params.PreTransformVertices ? 1u << 4 : 0) |
+		(params.Triangulate ? 1u << 5 : 0);
+}
+
+std::string MeshBinaryCache::GetCachePath(const std::string& sourcePath, const ModelLoadParams& params)
+{
+	return sourcePath + "." + std::to_string(EncodeParams(params)) + ".meshcache";
+}
+
+bool MeshBinaryCache::QuerySource(const std::string& sourcePath, uint64_t& outSize, int64_t& outWriteTime)
+{
+	std::error_code error;
+	outSize = static_cast<uint64_t>(std::filesystem::file_size(sourcePath, error));
+	if (error)
+	{
+		return false;
+	}
+
+	outWriteTime = static_cast<int64_t>(std::filesystem::last_write_time(sourcePath, error).time_since_epoch().count());
+	return !error;
+}
+
+bool MeshBinaryCache::Load(const std::string& sourcePath, const ModelLoadParams& params, std::vector<MeshImportData>& outMeshes)
+{
+	uint64_t sourceSize = 0;
+	int64_t sourceWriteTime = 0;
+	if (!QuerySource(sourcePath, sourceSize, sourceWriteTime))
+	{
+		return false;
+	}
+
+	auto mapping = std::make_shared<const MappedFile>(GetCachePath(sourcePath, params));
+	if (!mapping->IsValid() || mapping->GetSize() < sizeof(MeshCacheHeader))
+	{
+		return false;
+	}
+
+	const uint8_t* data = mapping->GetData();
+	const uint64_t fileSize = mapping->GetSize();
+	MeshCacheHeader header;
+	std::memcpy(&header, data, sizeof(MeshCacheHeader));
+	if (header.Magic != MeshCacheMagic ||
+		header.Version != MeshCacheVersion ||
+		header.ParamBits != EncodeParams(params) ||
+		header.VertexStride != sizeof(VertexPosTexNT) ||
+		header.SourceSize != sourceSize ||
+		header.SourceWriteTime != sourceWriteTime)
+	{
+		return false;
+	}
+
+	const uint64_t dependencyTableOffset = sizeof(MeshCacheHeader) + sizeof(MeshCacheRecord) * static_cast<uint64_t>(header.MeshCount);
+	if (dependencyTableOffset + sizeof(MeshCacheDependency) * static_cast<uint64_t>(header.DependencyCount) > fileSize)
+	{
+		return false;
+	}
+
+	const auto dependencies = reinterpret_cast<const MeshCacheDependency*>(data + dependencyTableOffset);
+	for (uint32_t dependencyIdx = 0; dependencyIdx < header.DependencyCount; ++dependencyIdx)
+	{
+		const MeshCacheDependency& dependency = dependencies[dependencyIdx];
+		if (dependency.PathOffset + dependency.PathLength > fileSize)
+		{
+			std::cout << "MeshBinaryCache : Corrupted cache of " << sourcePath << std::endl;
+			return false;
+		}
+
+		const std::string dependencyPath(reinterpret_cast<const char*>(data + dependency.PathOffset), dependency.PathLength);
+		uint64_t dependencySize = 0;
+		int64_t dependencyWriteTime = 0;
+		if (!QuerySource(dependencyPath, dependencySize, dependencyWriteTime) ||
+			dependency.Size != dependencySize ||
+			dependency.WriteTime != dependencyWriteTime)
+		{
+			return false;
+		}
+	}
+
+	const auto records = reinterpret_cast<const MeshCacheRecord*>(data + sizeof(MeshCacheHeader));
+	std::vector<MeshImportData> meshes(header.MeshCount);
+	for (uint32_t meshIdx = 0; meshIdx < header.MeshCount; ++meshIdx)
+	{
+		// Offsets are validated, so truncated or corrupted dump is rejected instead of read out of bounds
+		const MeshCacheRecord& record = records[meshIdx];
+		const uint64_t vertexBytes = sizeof(VertexPosTexNT) * static_cast<uint64_t>(record.VertexCount);
+		const uint64_t indexBytes = sizeof(unsigned int) * static_cast<uint64_t>(record.IndexCount);
+		uint64_t stringBytes = 0;
+		for (const uint32_t length : record.StringLengths)
+		{
+			stringBytes += length;
+		}
+
+		if (record.VertexOffset % MeshCacheAlignment != 0 || record.VertexOffset + vertexBytes > fileSize ||
+			record.IndexOffset % MeshCacheAlignment != 0 || record.IndexOffset + indexBytes > fileSize ||
+			record.StringOffset + stringBytes > fileSize)
+		{
+			std::cout << "MeshBinaryCache : Corrupted cache of " << sourcePath << std::endl;
+			return false;
+		}
+
+		MeshImportData& mesh = meshes[meshIdx];
+		mesh.Mapping = mapping;
+		mesh.MappedVertices = std::span<const VertexPosTexNT>(reinterpret_cast<const VertexPosTexNT*>(data + record.VertexOffset), record.VertexCount);
+		mesh.MappedIndices = std::span<const unsigned int>(reinterpret_cast<const unsigned int*>(data + record.IndexOffset), record.IndexCount);
+		mesh.BoundingBox = AABB(record.BoundsMin, record.BoundsMax);
+		mesh.Factors.BaseColor = record.BaseColorFactor;
+		mesh.Factors.Emissive = record.EmissiveFactor;
+		mesh.Factors.Metallic = record.MetallicFactor;
+		mesh.Factors.Roughness = record.RoughnessFactor;
+		mesh.Factors.bValid = record.bHasFactors != 0;
+
+		const char* strings = reinterpret_cast<const char*>(data + record.StringOffset);
+		mesh.Name.assign(strings, record.StringLengths[0]);
+		strings += record.StringLengths[0];
+		for (size_t slot = 0; slot < 5; ++slot)
+		{
+			mesh.TexturePaths[slot].assign(strings, record.StringLengths[slot + 1]);
+			strings += record.StringLengths[slot + 1];
+		}
+	}
+
+	outMeshes.insert(outMeshes.end(), std::make_move_iterator(meshes.begin()), std::make_move_iterator(meshes.end()));
+	return true;
+}
+
+bool MeshBinaryCache::Save(const std::string& sourcePath, const ModelLoadParams& params, const std::vector<MeshImportData>& meshes, const std::vector<std::string>& dependencies)
+{
+	MeshCacheHeader header;
+	header.ParamBits = EncodeParams(params);
+	header.MeshCount = static_cast<uint32_t>(meshes.size());
+	header.DependencyCount = static_cast<uint32_t>(dependencies.size());
+	if (!QuerySource(sourcePath, header.SourceSize, header.SourceWriteTime))
+	{
+		return false;
+	}
+
+	// Layout : Header | Records | Dependencies | Dependency paths | (Vertices | Indices | Strings) of each mesh
+	std::vector<MeshCacheRecord> records(meshes.size());
+	std::vector<MeshCacheDependency> dependencyTable(dependencies.size());
+	uint64_t offset = sizeof(MeshCacheHeader) + sizeof(MeshCacheRecord) * records.size() + sizeof(MeshCacheDependency) * dependencyTable.size();
+	for (size_t dependencyIdx = 0; dependencyIdx < dependencies.size(); ++dependencyIdx)
+	{
+		MeshCacheDependency& dependency = dependencyTable[dependencyIdx];
+		if (!QuerySource(dependencies[dependencyIdx], dependency.Size, dependency.WriteTime))
+		{
+			return false;
+		}
+
+		dependency.PathOffset = offset;
+		dependency.PathLength = static_cast<uint32_t>(dependencies[dependencyIdx].size());
+		offset += dependency.PathLength;
+	}
+
+	for (size_t meshIdx = 0; meshIdx < meshes.size(); ++meshIdx)
+	{
+		const MeshImportData& mesh = meshes[meshIdx];
+		MeshCacheRecord& record = records[meshIdx];
+		record.BoundsMin = mesh.BoundingBox.Min;
+		record.BoundsMax = mesh.BoundingBox.Max;
+		record.BaseColorFactor = mesh.Factors.BaseColor;
+		record.EmissiveFactor = mesh.Factors.Emissive;
+		record.MetallicFactor = mesh.Factors.Metallic;
+		record.RoughnessFactor = mesh.Factors.Roughness;
+		record.bHasFactors = mesh.Factors.bValid ? 1 : 0;
+		record.VertexCount = static_cast<uint32_t>(mesh.GetVertices().size());
+		record.IndexCount = static_cast<uint32_t>(mesh.GetIndices().size());
+
+		record.VertexOffset = AlignOffset(offset);
+		record.IndexOffset = AlignOffset(record.VertexOffset + mesh.GetVertices().size_bytes());
+		record.StringOffset = record.IndexOffset + mesh.GetIndices().size_bytes();
+		offset = record.StringOffset;
+
+		record.StringLengths[0] = static_cast<uint32_t>(mesh.Name.size());
+		for (size_t slot = 0; slot < 5; ++slot)
+		{
+			record.StringLengths[slot + 1] = static_cast<uint32_t>(mesh.TexturePaths[slot].size());
+		}
+
+		for (const uint32_t length : record.StringLengths)
+		{
+			offset += length;
+		}
+	}
+
+	const std::string cachePath = GetCachePath(sourcePath, params);
+	const std::string tempPath = cachePath + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			std::cout << "MeshBinaryCache : Failed to write " << cachePath << std::endl;
+			return false;
+		}
+
+		const char zeros[MeshCacheAlignment] = { };
+		auto padTo = [&file, &zeros](uint64_t target)
+		{
+			const uint64_t current = static_cast<uint64_t>(file.tellp());
+			file.write(zeros, static_cast<std::streamsize>(target - current));
+		};
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(MeshCacheHeader));
+		file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(sizeof(MeshCacheRecord) * records.size()));
+		file.write(reinterpret_cast<const char*>(dependencyTable.data()), static_cast<std::streamsize>(sizeof(MeshCacheDependency) * dependencyTable.size()));
+		for (const auto& dependencyPath : dependencies)
+		{
+			file.write(dependencyPath.data(), static_cast<std::streamsize>(dependencyPath.size()));
+		}
+
+		for (size_t meshIdx = 0; meshIdx < meshes.size(); ++meshIdx)
+		{
+			const MeshImportData& mesh = meshes[meshIdx];
+			const MeshCacheRecord& record = records[meshIdx];
+			padTo(record.VertexOffset);
+			file.write(reinterpret_cast<const char*>(mesh.GetVertices().data()), static_cast<std::streamsize>(mesh.GetVertices().size_bytes()));
+			padTo(record.IndexOffset);
+			file.write(reinterpret_cast<const char*>(mesh.GetIndices().data()), static_cast<std::streamsize>(mesh.GetIndices().size_bytes()));
+
+			file.write(mesh.Name.data(), static_cast<std::streamsize>(mesh.Name.size()));
+			for (const auto& texturePath : mesh.TexturePaths)
+			{
+				file.write(texturePath.data(), static_cast<std::streamsize>(texturePath.size()));
+			}
+		}
+
+		if (!file.good())
+		{
+			std::cout << "MeshBinaryCache : Failed to write " << cachePath << std::endl;
+			file.close();
+			std::error_code error;
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempPath, cachePath, error);
+	if (error)
+	{
+		std::cout << "MeshBinaryCache : Failed to write " << cachePath << " (" << error.message() << ")" << std::endl;
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+
+	return true;
+}
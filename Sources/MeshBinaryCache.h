@@ -0,0 +1,32 @@
+#pragma once
+#include "Model.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+* Versioned binary dump of imported meshes, written next to source file.
+* Load maps the file and points vertex/index spans of each mesh into the mapping; nothing is parsed or copied.
+* Dump is ignored(and rewritten by next import) if version, import params, vertex layout or size/write time of source
+* or of any dependency(e.g. .bin buffers of .gltf) differs.
+**/
+class MeshBinaryCache
+{
+public:
+	/* Appends meshes to outMeshes only if whole dump is valid; safe to call from worker threads */
+	static bool Load(const std::string& sourcePath, const ModelLoadParams& params, std::vector<MeshImportData>& outMeshes);
+	/*
+	* Writes through temporary file, so concurrent or interrupted write never leaves partial dump behind.
+	* dependencies are other files which import read; their size and write time are validated along with source.
+	**/
+	static bool Save(const std::string& sourcePath, const ModelLoadParams& params, const std::vector<MeshImportData>& meshes, const std::vector<std::string>& dependencies = { });
+
+	/* "<source>.<param bits>.meshcache" */
+	static std::string GetCachePath(const std::string& sourcePath, const ModelLoadParams& params);
+
+private:
+	static uint32_t EncodeParams(const ModelLoadParams& params);
+	static bool QuerySource(const std::string& sourcePath, uint64_t& outSize, int64_t& outWriteTime);
+
+};
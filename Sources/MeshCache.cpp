@@ -0,0 +1,151 @@
+#include "MeshCache.h"
+#include "Mesh.h"
+#include "JobSystem.h"
+
+#include <filesystem>
+#include <iostream>
+
+std::unordered_map<std::string, ModelAsset*> MeshCache::s_assets;
+size_t MeshCache::s_hits = 0;
+size_t MeshCache::s_misses = 0;
+
+ModelAsset::ModelAsset(std::string key) :
+	m_key(std::move(key)),
+	m_loadCounter(std::make_shared<JobCounter>())
+{
+}
+
+ModelAsset::~ModelAsset()
+{
+	for (auto& mesh : m_meshes)
+	{
+		MeshGeometry::Release(mesh.Geometry);
+	}
+
+	m_meshes.clear();
+}
+
+void ModelAsset::Release(ModelAsset* asset)
+{
+	if (asset != nullptr && --asset->m_refCount == 0)
+	{
+		MeshCache::Remove(asset);
+		delete asset;
+	}
+}
+
+const ModelAsset::MeshEntry& ModelAsset::AddMesh(MeshImportData&& data)
+{
+	MeshEntry& entry = m_meshes.emplace_back();
+	entry.Name = std::move(data.Name);
+	entry.Geometry = new MeshGeometry(data.GetVertices(), data.GetIndices(), data.BoundingBox);
+	for (size_t slot = 0; slot < 5; ++slot)
+	{
+		entry.TexturePaths[slot] = std::move(data.TexturePaths[slot]);
+	}
+
+	entry.Factors = data.Factors;
+
+	m_vertexBytes += data.GetVertices().size_bytes() + data.GetIndices().size_bytes();
+
+	// CPU copy(or mapping of binary cache) is not needed once geometry is uploaded
+	data.Vertices = std::vector<VertexPosTexNT>();
+	data.Indices = std::vector<unsigned int>();
+	data.Mapping.reset();
+	data.MappedVertices = { };
+	data.MappedIndices = { };
+	return entry;
+}
+
+void ModelAsset::SetReady(bool bSucceeded)
+{
+	m_bReady = true;
+	m_bSucceeded = bSucceeded;
+
+	auto callbacks = std::move(m_callbacks);
+	m_callbacks.clear();
+	for (auto& callback : callbacks)
+	{
+		callback.second(bSucceeded);
+	}
+}
+
+void ModelAsset::OnReady(const void* owner, std::function<void(bool)> callback)
+{
+	if (m_bReady)
+	{
+		callback(m_bSucceeded);
+		return;
+	}
+
+	m_callbacks.emplace_back(owner, std::move(callback));
+}
+
+void ModelAsset::RemoveCallbacks(const void* owner)
+{
+	std::erase_if(m_callbacks, [owner](const auto& callback) { return callback.first == owner; });
+}
+
+std::string MeshCache::MakeKey(const std::string& filePath, const ModelLoadParams& params)
+{
+	std::error_code error;
+	std::filesystem::path path = std::filesystem::weakly_canonical(std::filesystem::path(filePath), error);
+	if (error)
+	{
+		path = std::filesystem::path(filePath).lexically_normal();
+	}
+
+	std::string key = path.generic_string();
+	key.append("|");
+	key.append(params.CalcTangentSpace ? "1" : "0");
+	key.append(params.ConvertToLeftHanded ? "1" : "0");
+	key.append(params.GenSmoothNormals ? "1" : "0");
+	key.append(params.GenUVs ? "1" : "0");
+	key.append(params.PreTransformVertices ? "1" : "0");
+	key.append(params.Triangulate ? "1" : "0");
+	return key;
+}
+
+ModelAsset* MeshCache::Acquire(const std::string& filePath, const ModelLoadParams& params, bool& bCreated)
+{
+	std::string key = MakeKey(filePath, params);
+	if (auto found = s_assets.find(key); found != s_assets.end())
+	{
+		bCreated = false;
+		++s_hits;
+		found->second->AddRef();
+		return found->second;
+	}
+
+	bCreated = true;
+	++s_misses;
+	ModelAsset* asset = new ModelAsset(key);
+	s_assets[std::move(key)] = asset;
+	return asset;
+}
+
+void MeshCache::Remove(ModelAsset* asset)
+{
+	if (auto found = s_assets.find(asset->m_key); found != s_assets.end() && found->second == asset)
+	{
+		s_assets.erase(found);
+	}
+}
+
+void MeshCache::PrintStats()
+{
+	// Every model beyond the first one of an asset would have uploaded same geometry again
+	size_t cachedBytes = 0;
+	size_t sharedBytes = 0;
+	for (const auto& asset : s_assets)
+	{
+		cachedBytes += asset.second->GetVertexBytes();
+		sharedBytes += (asset.second->m_refCount - 1) * asset.second->GetVertexBytes();
+	}
+
+	std::cout << "----   Mesh Cache   ----" << std::endl;
+	std::cout << "Cached Assets : " << s_assets.size() << " (" << (cachedBytes / (1024.0 * 1024.0)) << " MB)" << std::endl;
+	std::cout << "Hits : " << s_hits << ", Misses : " << s_misses << std::endl;
+	std::cout << "Saved : " << (sharedBytes / (1024.0 * 1024.0)) << " MB" << std::endl;
+	std::cout << std::endl;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "Model.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class JobCounter;
+class MeshGeometry;
+
+/*
+* Import result of one file, shared by every Model loaded from it.
+* Holds one reference of each geometry; models create their own materials from texture paths of each entry.
+**/
+class ModelAsset
+{
+public:
+	struct MeshEntry
+	{
+		std::string Name;
+		MeshGeometry* Geometry = nullptr;
+		std::string TexturePaths[5];
+		MaterialFactors Factors;
+	};
+
+	void AddRef() { ++m_refCount; }
+	static void Release(ModelAsset* asset);
+
+	/* Uploads geometry of imported mesh; GL thread only */
+	const MeshEntry& AddMesh(MeshImportData&& data);
+	const std::vector<MeshEntry>& GetMeshes() const { return m_meshes; }
+
+	/* Runs callbacks queued by OnReady */
+	void SetReady(bool bSucceeded);
+	bool IsReady() const { return m_bReady; }
+	bool IsSucceeded() const { return m_bSucceeded; }
+
+	/* Runs callback right away if ready, otherwise once SetReady is called; owner cancels it with RemoveCallbacks */
+	void OnReady(const void* owner, std::function<void(bool)> callback);
+	void RemoveCallbacks(const void* owner);
+
+	/* Counter of jobs importing this asset; shared with handles of every model waiting for it */
+	std::shared_ptr<JobCounter> GetLoadCounter() const { return m_loadCounter; }
+
+	size_t GetVertexBytes() const { return m_vertexBytes; }
+
+private:
+	friend class MeshCache;
+	ModelAsset(std::string key);
+	~ModelAsset();
+
+private:
+	std::string m_key;
+	std::vector<MeshEntry> m_meshes;
+	std::vector<std::pair<const void*, std::function<void(bool)>>> m_callbacks;
+	std::shared_ptr<JobCounter> m_loadCounter;
+	size_t m_vertexBytes = 0;
+	unsigned int m_refCount = 1;
+	bool m_bReady = false;
+	bool m_bSucceeded = false;
+
+};
+
+/*
+* Shares imported geometry between models loaded from same file with same import params.
+* Repeated props cost one import and one set of geometry; materials and transforms stay per model.
+**/
+class MeshCache
+{
+public:
+	/* Returns asset with one more reference; bCreated tells caller it has to import the asset and call SetReady */
+	static ModelAsset* Acquire(const std::string& filePath, const ModelLoadParams& params, bool& bCreated);
+
+	static size_t GetHits() { return s_hits; }
+	static size_t GetMisses() { return s_misses; }
+	static void PrintStats();
+
+private:
+	friend class ModelAsset;
+	static void Remove(ModelAsset* asset);
+	static std::string MakeKey(const std::string& filePath, const ModelLoadParams& params);
+
+private:
+	static std::unordered_map<std::string, ModelAsset*> s_assets;
+	static size_t s_hits;
+	static size_t s_misses;
+
+};
@@ -0,0 +1,544 @@
+/*
+* Decoders below are ported from meshoptimizer(vertexcodec.cpp, indexcodec.cpp, vertexfilter.cpp).
+* https://github.com/zeux/meshoptimizer
+*
+* MIT License
+*
+* Copyright (c) 2016-2021 Arseny Kapoulkine
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+**/
+#include "MeshoptDecoder.h"
+
+#include <cmath>
+#include <cstring>
+
+constexpr uint8_t VertexHeader = 0xa0;
+constexpr uint8_t IndexHeader = 0xe0;
+constexpr uint8_t SequenceHeader = 0xd0;
+
+constexpr size_t ByteGroupSize = 16;
+/* Most bytes single group can consume; 8 bytes of 4-bit values + 16 exceptions */
+constexpr size_t ByteGroupDecodeLimit = 24;
+constexpr size_t VertexBlockSizeBytes = 8192;
+constexpr size_t VertexBlockMaxSize = 256;
+constexpr size_t TailMaxSize = 32;
+constexpr size_t FifoSize = 16;
+
+static size_t GetVertexBlockSize(size_t vertexSize)
+{
+	size_t result = (VertexBlockSizeBytes / vertexSize) & ~(ByteGroupSize - 1);
+	return (result < VertexBlockMaxSize) ? result : VertexBlockMaxSize;
+}
+
+static uint8_t Unzigzag8(uint8_t encoded)
+{
+	return static_cast<uint8_t>(-(encoded & 1) ^ (encoded >> 1));
+}
+
+static uint32_t Unzigzag32(uint32_t encoded)
+{
+	return (encoded >> 1) ^ (0u - (encoded & 1));
+}
+
+/* Caller guarantees at least 5 readable bytes */
+static uint32_t DecodeVByte(const uint8_t*& data)
+{
+	uint8_t lead = *data++;
+	if (lead < 128)
+	{
+		return lead;
+	}
+
+	uint32_t result = lead & 127;
+	uint32_t shift = 7;
+	for (int idx = 0; idx < 4; ++idx)
+	{
+		uint8_t group = *data++;
+		result |= static_cast<uint32_t>(group & 127) << shift;
+		shift += 7;
+
+		if (group < 128)
+		{
+			break;
+		}
+	}
+
+	return result;
+}
+
+static uint32_t DecodeIndex(const uint8_t*& data, uint32_t last)
+{
+	return last + Unzigzag32(DecodeVByte(data));
+}
+
+static void WriteIndex(uint8_t* destination, size_t offset, size_t indexSize, uint32_t index)
+{
+	if (indexSize == 2)
+	{
+		uint16_t value = static_cast<uint16_t>(index);
+		std::memcpy(destination + offset * 2, &value, 2);
+	}
+	else
+	{
+		std::memcpy(destination + offset * 4, &index, 4);
+	}
+}
+
+/* Slot is only consumed if bAdvance; otherwise next push overwrites it */
+static void PushVertexFifo(uint32_t* fifo, uint32_t index, size_t& offset, bool bAdvance = true)
+{
+	fifo[offset] = index;
+	offset = (offset + (bAdvance ? 1 : 0)) & (FifoSize - 1);
+}
+
+static void PushEdgeFifo(uint32_t (*fifo)[2], uint32_t from, uint32_t to, size_t& offset)
+{
+	fifo[offset][0] = from;
+	fifo[offset][1] = to;
+	offset = (offset + 1) & (FifoSize - 1);
+}
+
+template <typename T>
+static T LoadElement(const uint8_t* data)
+{
+	T value;
+	std::memcpy(&value, data, sizeof(T));
+	return value;
+}
+
+template <typename T>
+static void StoreElement(uint8_t* data, T value)
+{
+	std::memcpy(data, &value, sizeof(T));
+}
+
+static int RoundToInt(float value)
+{
+	return static_cast<int>(value + (value >= 0.0f ? 0.5f : -0.5f));
+}
+
+template <typename T>
+static void DecodeFilterOct(uint8_t* data, size_t count)
+{
+	const float maxValue = static_cast<float>((1 << (sizeof(T) * 8 - 1)) - 1);
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		uint8_t* element = data + idx * 4 * sizeof(T);
+		float dirX = static_cast<float>(LoadElement<T>(element));
+		float dirY = static_cast<float>(LoadElement<T>(element + sizeof(T)));
+		/* Third component stores 1.0 in same scale as x and y */
+		float dirZ = static_cast<float>(LoadElement<T>(element + 2 * sizeof(T))) - std::fabs(dirX) - std::fabs(dirY);
+
+		/* Unfold lower hemisphere */
+		float fold = (dirZ < 0.0f) ? dirZ : 0.0f;
+		dirX += (dirX >= 0.0f) ? fold : -fold;
+		dirY += (dirY >= 0.0f) ? fold : -fold;
+
+		float length = std::sqrt(dirX * dirX + dirY * dirY + dirZ * dirZ);
+		float scale = (length > 0.0f) ? (maxValue / length) : 0.0f;
+
+		StoreElement<T>(element, static_cast<T>(RoundToInt(dirX * scale)));
+		StoreElement<T>(element + sizeof(T), static_cast<T>(RoundToInt(dirY * scale)));
+		StoreElement<T>(element + 2 * sizeof(T), static_cast<T>(RoundToInt(dirZ * scale)));
+	}
+}
+
+static void DecodeFilterQuat(uint8_t* data, size_t count)
+{
+	const float invSqrt2 = 1.0f / std::sqrt(2.0f);
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		uint8_t* element = data + idx * 8;
+		int16_t packedW = LoadElement<int16_t>(element + 6);
+
+		/* Scale is stored in high bits of 4th component, index of largest component in its lowest 2 bits */
+		int quantizedRange = packedW | 3;
+		float scale = invSqrt2 / static_cast<float>(quantizedRange);
+		int largestIdx = packedW & 3;
+
+		/* Three smallest components follow largest one in xyzw order */
+		float first = static_cast<float>(LoadElement<int16_t>(element)) * scale;
+		float second = static_cast<float>(LoadElement<int16_t>(element + 2)) * scale;
+		float third = static_cast<float>(LoadElement<int16_t>(element + 4)) * scale;
+
+		float largestSquared = 1.0f - first * first - second * second - third * third;
+		float largest = std::sqrt(largestSquared >= 0.0f ? largestSquared : 0.0f);
+
+		StoreElement<int16_t>(element + ((largestIdx + 1) & 3) * 2, static_cast<int16_t>(RoundToInt(first * 32767.0f)));
+		StoreElement<int16_t>(element + ((largestIdx + 2) & 3) * 2, static_cast<int16_t>(RoundToInt(second * 32767.0f)));
+		StoreElement<int16_t>(element + ((largestIdx + 3) & 3) * 2, static_cast<int16_t>(RoundToInt(third * 32767.0f)));
+		StoreElement<int16_t>(element + largestIdx * 2, static_cast<int16_t>(static_cast<int>(largest * 32767.0f + 0.5f)));
+	}
+}
+
+static void DecodeFilterExp(uint8_t* data, size_t count)
+{
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		uint32_t encoded = LoadElement<uint32_t>(data + idx * 4);
+
+		/* 24-bit signed mantissa, 8-bit signed exponent */
+		int32_t mantissa = static_cast<int32_t>(encoded << 8) >> 8;
+		int32_t exponent = static_cast<int32_t>(encoded) >> 24;
+		StoreElement<float>(data + idx * 4, std::ldexp(static_cast<float>(mantissa), exponent));
+	}
+}
+
+const uint8_t* MeshoptDecoder::DecodeBytes(const uint8_t* data, const uint8_t* dataEnd, uint8_t* buffer, size_t bufferSize)
+{
+	/* 2-bit mode of each group; 4 groups per header byte */
+	const uint8_t* header = data;
+	size_t headerSize = (bufferSize / ByteGroupSize + 3) / 4;
+	if (static_cast<size_t>(dataEnd - data) < headerSize)
+	{
+		return nullptr;
+	}
+
+	data += headerSize;
+	for (size_t offset = 0; offset < bufferSize; offset += ByteGroupSize)
+	{
+		if (static_cast<size_t>(dataEnd - data) < ByteGroupDecodeLimit)
+		{
+			return nullptr;
+		}
+
+		size_t group = offset / ByteGroupSize;
+		int mode = (header[group / 4] >> ((group % 4) * 2)) & 3;
+		uint8_t* out = buffer + offset;
+		switch (mode)
+		{
+		case 0:
+			std::memset(out, 0, ByteGroupSize);
+			break;
+
+		case 3:
+			std::memcpy(out, data, ByteGroupSize);
+			data += ByteGroupSize;
+			break;
+
+		default:
+		{
+			/* Packed 2-bit or 4-bit values, most significant first; all ones marks an exception byte stored after them */
+			int bits = (mode == 1) ? 2 : 4;
+			int sentinel = (1 << bits) - 1;
+			size_t packedBytes = (ByteGroupSize * bits) / 8;
+			const uint8_t* exceptions = data + packedBytes;
+			for (size_t idx = 0; idx < ByteGroupSize; ++idx)
+			{
+				int shift = 8 - bits - static_cast<int>((idx * bits) % 8);
+				int value = (data[(idx * bits) / 8] >> shift) & sentinel;
+				out[idx] = (value == sentinel) ? *exceptions++ : static_cast<uint8_t>(value);
+			}
+
+			data = exceptions;
+		}
+		break;
+		}
+	}
+
+	return data;
+}
+
+const uint8_t* MeshoptDecoder::DecodeVertexBlock(const uint8_t* data, const uint8_t* dataEnd, uint8_t* vertexData, size_t vertexCount, size_t vertexSize, uint8_t lastVertex[256])
+{
+	uint8_t buffer[VertexBlockMaxSize];
+	size_t alignedCount = (vertexCount + ByteGroupSize - 1) & ~(ByteGroupSize - 1);
+
+	/* Each byte of vertex is stored as its own stream of deltas against previous vertex */
+	for (size_t byteIdx = 0; byteIdx < vertexSize; ++byteIdx)
+	{
+		data = DecodeBytes(data, dataEnd, buffer, alignedCount);
+		if (data == nullptr)
+		{
+			return nullptr;
+		}
+
+		uint8_t prev = lastVertex[byteIdx];
+		for (size_t idx = 0; idx < vertexCount; ++idx)
+		{
+			uint8_t value = static_cast<uint8_t>(Unzigzag8(buffer[idx]) + prev);
+			vertexData[idx * vertexSize + byteIdx] = value;
+			prev = value;
+		}
+	}
+
+	std::memcpy(lastVertex, vertexData + (vertexCount - 1) * vertexSize, vertexSize);
+	return data;
+}
+
+bool MeshoptDecoder::DecodeVertexBuffer(uint8_t* destination, size_t count, size_t byteStride, const uint8_t* data, size_t size)
+{
+	if (byteStride == 0 || byteStride > 256 || byteStride % 4 != 0)
+	{
+		return false;
+	}
+
+	const uint8_t* dataEnd = data + size;
+	if (size < 1 + byteStride)
+	{
+		return false;
+	}
+
+	uint8_t header = *data++;
+	if ((header & 0xf0) != VertexHeader || (header & 0x0f) != 0)
+	{
+		return false;
+	}
+
+	/* Tail holds first vertex, which seeds deltas of first block */
+	uint8_t lastVertex[256];
+	std::memcpy(lastVertex, dataEnd - byteStride, byteStride);
+
+	size_t blockSize = GetVertexBlockSize(byteStride);
+	for (size_t offset = 0; offset < count; offset += blockSize)
+	{
+		size_t vertices = (offset + blockSize < count) ? blockSize : (count - offset);
+		data = DecodeVertexBlock(data, dataEnd, destination + offset * byteStride, vertices, byteStride, lastVertex);
+		if (data == nullptr)
+		{
+			return false;
+		}
+	}
+
+	size_t tailSize = (byteStride < TailMaxSize) ? TailMaxSize : byteStride;
+	return static_cast<size_t>(dataEnd - data) == tailSize;
+}
+
+bool MeshoptDecoder::DecodeIndexBuffer(uint8_t* destination, size_t count, size_t indexSize, const uint8_t* data, size_t size)
+{
+	if (count % 3 != 0 || (indexSize != 2 && indexSize != 4))
+	{
+		return false;
+	}
+
+	/* Header, one code byte per triangle and 16 byte codeaux table at the end */
+	if (size < 1 + count / 3 + 16)
+	{
+		return false;
+	}
+
+	int version = data[0] & 0x0f;
+	if ((data[0] & 0xf0) != IndexHeader || version > 1)
+	{
+		return false;
+	}
+
+	uint32_t edgeFifo[FifoSize][2];
+	uint32_t vertexFifo[FifoSize];
+	std::memset(edgeFifo, -1, sizeof(edgeFifo));
+	std::memset(vertexFifo, -1, sizeof(vertexFifo));
+	size_t edgeFifoOffset = 0;
+	size_t vertexFifoOffset = 0;
+
+	uint32_t next = 0;
+	uint32_t last = 0;
+	/* Version 1 encodes free index of last +-1 as vertex code 13, 14 */
+	int reuseCodeLimit = (version >= 1) ? 13 : 15;
+
+	const uint8_t* codes = data + 1;
+	const uint8_t* stream = codes + count / 3;
+	const uint8_t* streamEnd = data + size - 16;
+	const uint8_t* codeauxTable = streamEnd;
+
+	/*
+	* Vertex code of each corner : 0 is next sequential index, 15 is free index in stream,
+	* otherwise distance into vertex fifo.
+	**/
+	for (size_t idx = 0; idx < count; idx += 3)
+	{
+		/* Triangle reads at most 16 bytes(codeaux + 3 free indices), which fit into codeaux table past the end */
+		if (stream > streamEnd)
+		{
+			return false;
+		}
+
+		uint8_t triangleCode = *codes++;
+		uint32_t first = 0;
+		uint32_t second = 0;
+		uint32_t third = 0;
+		if (triangleCode < 0xf0)
+		{
+			/* Edge from fifo and a third vertex */
+			size_t edgeSlot = (edgeFifoOffset - 1 - (triangleCode >> 4)) & (FifoSize - 1);
+			first = edgeFifo[edgeSlot][0];
+			second = edgeFifo[edgeSlot][1];
+
+			int thirdCode = triangleCode & 15;
+			if (thirdCode < reuseCodeLimit)
+			{
+				bool bSequential = (thirdCode == 0);
+				third = bSequential ? next : vertexFifo[(vertexFifoOffset - 1 - thirdCode) & (FifoSize - 1)];
+				next += bSequential ? 1 : 0;
+				PushVertexFifo(vertexFifo, third, vertexFifoOffset, bSequential);
+			}
+			else
+			{
+				last = third = (thirdCode != 15) ? (last + (thirdCode - (thirdCode ^ 3))) : DecodeIndex(stream, last);
+				PushVertexFifo(vertexFifo, third, vertexFifoOffset);
+			}
+
+			PushEdgeFifo(edgeFifo, third, second, edgeFifoOffset);
+			PushEdgeFifo(edgeFifo, first, third, edgeFifoOffset);
+		}
+		else
+		{
+			int secondCode = 0;
+			int thirdCode = 0;
+			if (triangleCode < 0xfe)
+			{
+				/* Table never contains free indices(15) */
+				uint8_t codeaux = codeauxTable[triangleCode & 15];
+				secondCode = codeaux >> 4;
+				thirdCode = codeaux & 15;
+
+				first = next++;
+				second = (secondCode == 0) ? next++ : vertexFifo[(vertexFifoOffset - secondCode) & (FifoSize - 1)];
+				third = (thirdCode == 0) ? next++ : vertexFifo[(vertexFifoOffset - thirdCode) & (FifoSize - 1)];
+			}
+			else
+			{
+				uint8_t codeaux = *stream++;
+				int firstCode = (triangleCode == 0xfe) ? 0 : 15;
+				secondCode = codeaux >> 4;
+				thirdCode = codeaux & 15;
+
+				/* Zero codeaux out of table resets sequential indices */
+				if (codeaux == 0)
+				{
+					next = 0;
+				}
+
+				first = (firstCode == 0) ? next++ : 0;
+				second = (secondCode == 0) ? next++ : vertexFifo[(vertexFifoOffset - secondCode) & (FifoSize - 1)];
+				third = (thirdCode == 0) ? next++ : vertexFifo[(vertexFifoOffset - thirdCode) & (FifoSize - 1)];
+
+				if (firstCode == 15)
+				{
+					last = first = DecodeIndex(stream, last);
+				}
+
+				if (secondCode == 15)
+				{
+					last = second = DecodeIndex(stream, last);
+				}
+
+				if (thirdCode == 15)
+				{
+					last = third = DecodeIndex(stream, last);
+				}
+			}
+
+			PushVertexFifo(vertexFifo, first, vertexFifoOffset);
+			PushVertexFifo(vertexFifo, second, vertexFifoOffset, secondCode == 0 || secondCode == 15);
+			PushVertexFifo(vertexFifo, third, vertexFifoOffset, thirdCode == 0 || thirdCode == 15);
+
+			PushEdgeFifo(edgeFifo, second, first, edgeFifoOffset);
+			PushEdgeFifo(edgeFifo, third, second, edgeFifoOffset);
+			PushEdgeFifo(edgeFifo, first, third, edgeFifoOffset);
+		}
+
+		WriteIndex(destination, idx + 0, indexSize, first);
+		WriteIndex(destination, idx + 1, indexSize, second);
+		WriteIndex(destination, idx + 2, indexSize, third);
+	}
+
+	return stream == streamEnd;
+}
+
+bool MeshoptDecoder::DecodeIndexSequence(uint8_t* destination, size_t count, size_t indexSize, const uint8_t* data, size_t size)
+{
+	if (indexSize != 2 && indexSize != 4)
+	{
+		return false;
+	}
+
+	/* Header, at least one byte per index and 4 byte tail */
+	if (size < 1 + count + 4)
+	{
+		return false;
+	}
+
+	int version = data[0] & 0x0f;
+	if ((data[0] & 0xf0) != SequenceHeader || version > 1)
+	{
+		return false;
+	}
+
+	const uint8_t* stream = data + 1;
+	const uint8_t* streamEnd = data + size - 4;
+	uint32_t last[2] = { 0, 0 };
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		/* Index reads at most 5 bytes, tail covers the rest */
+		if (stream >= streamEnd)
+		{
+			return false;
+		}
+
+		/* Lowest bit selects baseline, remaining bits are zigzag delta against it */
+		uint32_t encoded = DecodeVByte(stream);
+		uint32_t baseline = encoded & 1;
+		uint32_t index = last[baseline] + Unzigzag32(encoded >> 1);
+		last[baseline] = index;
+		WriteIndex(destination, idx, indexSize, index);
+	}
+
+	return stream == streamEnd;
+}
+
+bool MeshoptDecoder::ApplyFilter(EMeshoptFilter filter, uint8_t* data, size_t count, size_t byteStride)
+{
+	switch (filter)
+	{
+	case EMeshoptFilter::None:
+		return true;
+
+	case EMeshoptFilter::Octahedral:
+		if (byteStride == 4)
+		{
+			DecodeFilterOct<int8_t>(data, count);
+			return true;
+		}
+		else if (byteStride == 8)
+		{
+			DecodeFilterOct<int16_t>(data, count);
+			return true;
+		}
+		return false;
+
+	case EMeshoptFilter::Quaternion:
+		if (byteStride != 8)
+		{
+			return false;
+		}
+		DecodeFilterQuat(data, count);
+		return true;
+
+	case EMeshoptFilter::Exponential:
+		if (byteStride % 4 != 0)
+		{
+			return false;
+		}
+		DecodeFilterExp(data, count * (byteStride / 4));
+		return true;
+	}
+
+	return false;
+}
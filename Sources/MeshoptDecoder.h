@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+enum class EMeshoptFilter
+{
+	None,
+	Octahedral,
+	Quaternion,
+	Exponential
+};
+
+/*
+* Decoders of buffer view codecs defined by EXT_meshopt_compression(bitstream version 0).
+* Every decoder validates bounds of its input and returns false on malformed data instead of reading past it.
+* Stateless; safe to call from worker threads.
+**/
+class MeshoptDecoder
+{
+public:
+	/* Mode "ATTRIBUTES"; byteStride must be multiple of 4 and at most 256 */
+	static bool DecodeVertexBuffer(uint8_t* destination, size_t count, size_t byteStride, const uint8_t* data, size_t size);
+	/* Mode "TRIANGLES"; count is number of indices, indexSize is 2 or 4 */
+	static bool DecodeIndexBuffer(uint8_t* destination, size_t count, size_t indexSize, const uint8_t* data, size_t size);
+	/* Mode "INDICES" */
+	static bool DecodeIndexSequence(uint8_t* destination, size_t count, size_t indexSize, const uint8_t* data, size_t size);
+
+	/* Applied in place after DecodeVertexBuffer */
+	static bool ApplyFilter(EMeshoptFilter filter, uint8_t* data, size_t count, size_t byteStride);
+
+private:
+	static const uint8_t* DecodeBytes(const uint8_t* data, const uint8_t* dataEnd, uint8_t* buffer, size_t bufferSize);
+	static const uint8_t* DecodeVertexBlock(const uint8_t* data, const uint8_t* dataEnd, uint8_t* vertexData, size_t vertexCount, size_t vertexSize, uint8_t lastVertex[256]);
+
+};
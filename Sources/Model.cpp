@@ -1,7 +1,11 @@
 #include "Model.h"
 #include "Texture2D.h"
+#include "TextureCache.h"
 #include "Material.h"
 #include "Mesh.h"
+#include "MeshCache.h"
+#include "MeshBinaryCache.h"
+#include "GLTFImporter.h"
 #include "Shader.h"
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
@@ -18,19 +22,31 @@ m_mode(GL_TRIANGLES)
 }
 
 Model::Model(const std::string& name, std::string filePath, const ModelLoadParams& params) :
+	Model(name, std::move(filePath))
+{
+	bool bCreated = false;
+	ModelAsset* asset = MeshCache::Acquire(m_filePath, params, bCreated);
+	if (bCreated)
+	{
+		std::vector<MeshImportData> meshes;
+		const bool bImported = Import(m_filePath, params, meshes);
+		for (auto& mesh : meshes)
+		{
+			asset->AddMesh(std::move(mesh));
+		}
+
+		asset->SetReady(bImported);
+	}
+
+	SetAsset(asset);
+	asset->OnReady(this, [this](bool) { Instantiate(); });
+}
+
+Model::Model(const std::string& name, std::string filePath) :
 	Object(name),
    m_mode(GL_TRIANGLES),
 	m_filePath(std::move(filePath))
 {
-	std::filesystem::path path(m_filePath);
-	path = path.parent_path();
-	std::wstring originParentPath = path.c_str();
-	char folderPath[2048];
-	size_t converted = 0;
-	wcstombs_s(&converted, folderPath, 2048, originParentPath.c_str(), originParentPath.size());
-	m_folderPath = folderPath;
-	m_folderPath.append("/");
-	LoadModel(params);
 }
 
 Model::~Model()
@@ -43,47 +59,98 @@ Model::~Model()
 	{
 		delete mesh;
 	}
+
+	if (m_asset != nullptr)
+	{
+		m_asset->RemoveCallbacks(this);
+		ModelAsset::Release(m_asset);
+		m_asset = nullptr;
+	}
 }
 
-void Model::LoadModel(const ModelLoadParams& params)
+void Model::SetAsset(ModelAsset* asset)
 {
+	if (m_asset != nullptr)
+	{
+		m_asset->RemoveCallbacks(this);
+		ModelAsset::Release(m_asset);
+	}
+
+	m_asset = asset;
+}
+
+bool Model::Import(const std::string& filePath, const ModelLoadParams& params, std::vector<MeshImportData>& outMeshes)
+{
+	if (MeshBinaryCache::Load(filePath, params, outMeshes))
+	{
+		return true;
+	}
+
+	std::vector<std::string> dependencies;
+	if (GLTFImporter::IsGLTF(filePath) && GLTFImporter::Import(filePath, params, outMeshes, &dependencies))
+	{
+		MeshBinaryCache::Save(filePath, params, outMeshes, dependencies);
+		return true;
+	}
+
+	std::filesystem::path path(filePath);
+	path = path.parent_path();
+	std::wstring originParentPath = path.c_str();
+	char folderPath[2048];
+	size_t converted = 0;
+	wcstombs_s(&converted, folderPath, 2048, originParentPath.c_str(), originParentPath.size());
+	std::string folder = folderPath;
+	folder.append("/");
+
+	// Importer owns its scene; one importer per call keeps concurrent imports independent
 	Assimp::Importer importer;
-	auto scene = importer.ReadFile(m_filePath,
+	auto scene = importer.ReadFile(filePath,
 		(params.CalcTangentSpace ? aiProcess_CalcTangentSpace : 0x0) |
 		(params.Triangulate ? aiProcess_Triangulate : 0x0) |
 		(params.ConvertToLeftHanded ? aiProcess_ConvertToLeftHanded : 0x0) |
 		(params.GenUVs ? aiProcess_GenUVCoords : 0x0) |
 		(params.PreTransformVertices ? aiProcess_PreTransformVertices : 0x0));
 
-	this->ProcessNode(scene, scene->mRootNode);
+	if (scene == nullptr)
+	{
+		std::cout << "Failed to import model : " << filePath << " (" << importer.GetErrorString() << ")" << std::endl;
+		return false;
+	}
+
+	ProcessNode(scene, scene->mRootNode, folder, outMeshes);
 
 	importer.FreeScene();
+	MeshBinaryCache::Save(filePath, params, outMeshes);
+	return true;
 }
 
-void Model::ProcessNode(const aiScene* scene, const aiNode* node)
+void Model::ProcessNode(const aiScene* scene, const aiNode* node, const std::string& folderPath, std::vector<MeshImportData>& outMeshes)
 {
 	if (scene != nullptr && node != nullptr)
 	{
 		for (size_t idx = 0; idx < node->mNumMeshes; ++idx)
 		{
-			ProcessMesh(scene, scene->mMeshes[node->mMeshes[idx]]);
+			ProcessMesh(scene, scene->mMeshes[node->mMeshes[idx]], folderPath, outMeshes);
 		}
 
 		for (size_t childIdx = 0; childIdx < node->mNumChildren; ++childIdx)
 		{
-			ProcessNode(scene, node->mChildren[childIdx]);
+			ProcessNode(scene, node->mChildren[childIdx], folderPath, outMeshes);
 		}
 	}
 }
 
-void Model::ProcessMesh(const aiScene* scene, const aiMesh* mesh)
+void Model::ProcessMesh(const aiScene* scene, const aiMesh* mesh, const std::string& folderPath, std::vector<MeshImportData>& outMeshes)
 {
    if (scene != nullptr && mesh != nullptr)
    {
-		AABB meshBoundingBox;
+		MeshImportData& data = outMeshes.emplace_back();
+		data.Name = mesh->mName.C_Str();
+		data.Vertices.resize(mesh->mNumVertices);
+		data.Indices.resize(mesh->mNumFaces * 3);
 
-		std::vector<VertexPosTexNT> vertices(mesh->mNumVertices);
-		std::vector<unsigned int> indices(mesh->mNumFaces * 3);
+		auto& vertices = data.Vertices;
+		auto& indices = data.Indices;
 
 		bool bHasUVCoords = mesh->HasTextureCoords(0);
 		bool bHasNormals = mesh->HasNormals();
@@ -96,13 +163,9 @@ void Model::ProcessMesh(const aiScene* scene, const aiMesh* mesh)
 			const auto& aiPos = mesh->mVertices[idx];
 			vertex.Position = glm::vec3(aiPos.x, aiPos.y, aiPos.z);
 
-			// Model Bounding Box
-			this->m_boundingBox.UpdateMin(vertex.Position);
-			this->m_boundingBox.UpdateMax(vertex.Position);
-
 			// Mesh Bounding Box
-			meshBoundingBox.UpdateMin(vertex.Position);
-			meshBoundingBox.UpdateMax(vertex.Position);
+			data.BoundingBox.UpdateMin(vertex.Position);
+			data.BoundingBox.UpdateMax(vertex.Position);
 
 			if (bHasUVCoords)
 			{
@@ -133,105 +196,93 @@ void Model::ProcessMesh(const aiScene* scene, const aiMesh* mesh)
 		}
 
 		/* Material Data Process */
-		const auto newMat = new Material();
-		newMat->SetName(mesh->mName.C_Str());
-
-		aiString baseColorFileName;
-		aiString metallicRoughnessFileName;
-		aiString aoFileName;
-		aiString emissiveFileName;
-		aiString normalFileName;
-
 		const auto aiMaterial = scene->mMaterials[mesh->mMaterialIndex];
-		aiMaterial->GetTexture(AI_MATKEY_GLTF_PBRMETALLICROUGHNESS_BASE_COLOR_TEXTURE, &baseColorFileName);
-		aiMaterial->GetTexture(AI_MATKEY_GLTF_PBRMETALLICROUGHNESS_METALLICROUGHNESS_TEXTURE, &metallicRoughnessFileName);
-		aiMaterial->GetTexture(aiTextureType::aiTextureType_EMISSIVE, 0, &emissiveFileName);
-		aiMaterial->GetTexture(aiTextureType::aiTextureType_AMBIENT_OCCLUSION, 0, &aoFileName);
-		aiMaterial->GetTexture(aiTextureType::aiTextureType_NORMALS, 0, &normalFileName);
-
-		if (baseColorFileName.length > 0)
+		const auto resolveTexture = [&](aiTextureType type, unsigned int index, EMaterialTexture slot)
 		{
-			auto baseColorPath = m_folderPath;
-			baseColorPath.append(baseColorFileName.C_Str());
-			if (const auto baseColor = new Texture2D(baseColorPath); baseColor->GetID() != 0)
+			aiString fileName;
+			aiMaterial->GetTexture(type, index, &fileName);
+			if (fileName.length > 0)
 			{
-				newMat->SetBaseColor(baseColor);
+				data.TexturePaths[slot] = folderPath;
+				data.TexturePaths[slot].append(fileName.C_Str());
 			}
-			else
-			{
-				delete baseColor;
-			}
-		}
+		};
 
-		if (metallicRoughnessFileName.length > 0)
-		{
-			auto metallicRoughnnesPath = m_folderPath;
-			metallicRoughnnesPath.append(metallicRoughnessFileName.C_Str());
-			if (const auto metallicRoughness = new Texture2D(metallicRoughnnesPath); metallicRoughness->GetID() != 0)
-			{
-				newMat->SetMetallicRoughness(metallicRoughness);
-			}
-			else
-			{
-				delete metallicRoughness;
-			}
-		}
+		resolveTexture(AI_MATKEY_GLTF_PBRMETALLICROUGHNESS_BASE_COLOR_TEXTURE, EMaterialTexture::BaseColor);
+		resolveTexture(AI_MATKEY_GLTF_PBRMETALLICROUGHNESS_METALLICROUGHNESS_TEXTURE, EMaterialTexture::MetallicRoughness);
+		resolveTexture(aiTextureType::aiTextureType_EMISSIVE, 0, EMaterialTexture::Emissive);
+		resolveTexture(aiTextureType::aiTextureType_AMBIENT_OCCLUSION, 0, EMaterialTexture::AO);
+		resolveTexture(aiTextureType::aiTextureType_NORMALS, 0, EMaterialTexture::Normal);
+   }
+}
 
-		if (emissiveFileName.length > 0)
-		{
-			auto emissivePath = m_folderPath;
-			emissivePath.append(emissiveFileName.C_Str());
-			if (const auto emissive = new Texture2D(emissivePath); emissive->GetID() != 0)
-			{
-				newMat->SetEmissive(emissive);
-			}
-			else
-			{
-				delete emissive;
-			}
-		}
+void Model::AddMesh(size_t assetMeshIdx)
+{
+	const auto& entry = m_asset->GetMeshes()[assetMeshIdx];
+	const AABB meshBoundingBox = entry.Geometry->GetBoundingBox();
 
-		if (aoFileName.length > 0)
-		{
-			auto aoPath = m_folderPath;
-			aoPath.append(aoFileName.C_Str());
-			if (const auto ao = new Texture2D(aoPath); ao->GetID() != 0)
-			{
-				newMat->SetAmbientOcclusion(ao);
-			}
-			else
-			{
-				delete ao;
-			}
-		}
+	// Model Bounding Box
+	m_boundingBox.UpdateMin(meshBoundingBox.Min);
+	m_boundingBox.UpdateMax(meshBoundingBox.Max);
 
-		if (normalFileName.length > 0 )
+	const auto newMat = new Material();
+	newMat->SetName(entry.Name);
+
+	// Shown until streamed texture is resident; neutral value of each slot
+	const glm::u8vec4 placeholders[5] = {
+		glm::u8vec4(255, 255, 255, 255),	// BaseColor
+		glm::u8vec4(128, 128, 255, 255),	// Normal
+		glm::u8vec4(255, 255, 0, 255),	// MetallicRoughness
+		glm::u8vec4(255, 255, 255, 255),	// AO
+		glm::u8vec4(0, 0, 0, 255) };		// Emissive
+
+	Texture2D* textures[5] = { nullptr, nullptr, nullptr, nullptr, nullptr };
+	for (size_t slot = 0; slot < 5; ++slot)
+	{
+		if (!entry.TexturePaths[slot].empty())
 		{
-			auto normalPath = m_folderPath;
-			normalPath.append(normalFileName.C_Str());
-			if (const auto normal = new Texture2D(normalPath); normal->GetID() != 0)
+			if (const auto texture = TextureCache::Acquire(entry.TexturePaths[slot], placeholders[slot]); texture->GetID() != 0)
 			{
-				newMat->SetNormal(normal);
+				textures[slot] = texture;
 			}
 			else
 			{
-				delete normal;
+				Texture2D::Release(texture);
 			}
 		}
+	}
 
-		const auto newMesh = new Mesh(vertices, indices, newMat, meshBoundingBox);
-		m_meshes.push_back(newMesh);
-		m_materials.push_back(newMat);
-   }
+	newMat->SetBaseColor(textures[EMaterialTexture::BaseColor]);
+	newMat->SetMetallicRoughness(textures[EMaterialTexture::MetallicRoughness]);
+	newMat->SetEmissive(textures[EMaterialTexture::Emissive]);
+	newMat->SetAmbientOcclusion(textures[EMaterialTexture::AO]);
+	newMat->SetNormal(textures[EMaterialTexture::Normal]);
+
+	if (entry.Factors.bValid)
+	{
+		newMat->SetBaseColorFactor(entry.Factors.BaseColor);
+		newMat->SetMetallicFactor(entry.Factors.Metallic);
+		newMat->SetRoughnessFactor(entry.Factors.Roughness);
+		newMat->SetEmissiveFactor(entry.Factors.Emissive);
+		newMat->SetForceFactor(EMaterialTexture::BaseColor, textures[EMaterialTexture::BaseColor] == nullptr);
+		newMat->SetForceFactor(EMaterialTexture::MetallicRoughness, textures[EMaterialTexture::MetallicRoughness] == nullptr);
+		newMat->SetForceFactor(EMaterialTexture::Emissive, textures[EMaterialTexture::Emissive] == nullptr && entry.Factors.Emissive != glm::vec3(0.0f));
+	}
+
+	const auto newMesh = new Mesh(entry.Geometry, newMat);
+	m_meshes.push_back(newMesh);
+	m_materials.push_back(newMat);
 }
 
-void Model::Render(Shader* shader)
+void Model::Instantiate()
 {
-	if (this->IsActivated())
+	if (m_asset == nullptr)
 	{
-		for (auto& mesh : m_meshes)
-		{
-			mesh->Render(shader, m_mode);
-		}
+		return;
 	}
-}
\ No newline at end of file
+
+	for (size_t idx = m_meshes.size(); idx < m_asset->GetMeshes().size(); ++idx)
+	{
+		AddMesh(idx);
+	}
+}
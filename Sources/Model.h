@@ -2,7 +2,11 @@
 #include "Object.h"
 #include "Rendering.h"
 #include "AABB.h"
+#include "Vertex.h"
 
+#include <memory>
+#include <span>
+#include <string>
 #include <vector>
 
 enum EVertexAttrib
@@ -18,6 +22,8 @@ class Texture;
 class Sampler;
 class Mesh;
 class Shader;
+class ModelAsset;
+class MappedFile;
 struct aiScene;
 struct aiMesh;
 struct aiNode;
@@ -33,13 +39,64 @@ public:
 	bool Triangulate = true;
 };
 
+/*
+* pbrMetallicRoughness factors of imported material.
+* Shaders use factor instead of texture, so they are forced only on slots which have no texture.
+**/
+struct MaterialFactors
+{
+	glm::vec4 BaseColor = glm::vec4(1.0f);
+	glm::vec3 Emissive = glm::vec3(0.0f);
+	float Metallic = 1.0f;
+	float Roughness = 1.0f;
+	/* Set by importers which read factors(GLTFImporter); Assimp path leaves material defaults */
+	bool bValid = false;
+};
+
+/* CPU side result of importing one mesh; produced without any GL call */
+struct MeshImportData
+{
+	std::string Name;
+	/* Filled by importers; stream which has mapped span instead is left empty */
+	std::vector<VertexPosTexNT> Vertices;
+	std::vector<unsigned int> Indices;
+	/* File which mapped spans point into(MeshBinaryCache, glTF buffer); kept alive until geometry is uploaded */
+	std::shared_ptr<const MappedFile> Mapping;
+	std::span<const VertexPosTexNT> MappedVertices;
+	std::span<const unsigned int> MappedIndices;
+	AABB BoundingBox;
+	/* Indexed by EMaterialTexture; empty if material has no such texture */
+	std::string TexturePaths[5];
+	MaterialFactors Factors;
+
+	std::span<const VertexPosTexNT> GetVertices() const { return !MappedVertices.empty() ? MappedVertices : std::span<const VertexPosTexNT>(Vertices); }
+	std::span<const unsigned int> GetIndices() const { return !MappedIndices.empty() ? MappedIndices : std::span<const unsigned int>(Indices); }
+};
+
 class Model : public Object
 {
 public:
 	Model(const std::string& name);
+	/* Shares geometry through MeshCache; if same file is still being imported, meshes are added once it is ready */
 	Model(const std::string& name, std::string filePath, const ModelLoadParams& params);
+	/* Empty model of file; meshes are added by AddMesh as they are imported */
+	Model(const std::string& name, std::string filePath);
 	~Model();
 
+	/*
+	* Maps binary cache of file if it is up to date, otherwise imports(glTF natively, rest or unsupported glTF with Assimp) and writes the cache.
+	* No GL call; safe to call from worker threads.
+	**/
+	static bool Import(const std::string& filePath, const ModelLoadParams& params, std::vector<MeshImportData>& outMeshes);
+
+	/* Takes over one reference of asset */
+	void SetAsset(ModelAsset* asset);
+	ModelAsset* GetAsset() const { return m_asset; }
+	/* Creates own material of assetMeshIdx-th mesh of asset, drawing its shared geometry; GL thread only */
+	void AddMesh(size_t assetMeshIdx);
+	/* Adds every mesh of asset which is not added yet */
+	void Instantiate();
+
 	std::string GetFilePath() const { return m_filePath; }
 	Material* GetMaterial(size_t idx) const { return m_materials[idx]; }
 	const std::vector<Material*>& GetMaterials() const { return m_materials; }
@@ -47,7 +104,6 @@ public:
 	std::vector<Material*>& GetMaterials() { return m_materials; }
 	std::vector<Mesh*>& GetMeshes() { return m_meshes; }
 
-	void Render(Shader* shader);
 
 	void SetMode(GLenum mode = GL_TRIANGLES) { m_mode = mode; }
 	GLenum GetMode() const { return m_mode; }
@@ -66,9 +122,8 @@ public:
 	}
 
 private:
-	void LoadModel(const ModelLoadParams& params);
-	void ProcessNode(const aiScene* scene, const aiNode* node);
-	void ProcessMesh(const aiScene* scene, const aiMesh* mesh);
+	static void ProcessNode(const aiScene* scene, const aiNode* node, const std::string& folderPath, std::vector<MeshImportData>& outMeshes);
+	static void ProcessMesh(const aiScene* scene, const aiMesh* mesh, const std::string& folderPath, std::vector<MeshImportData>& outMeshes);
 
 public:
 	bool bCastShadow = true;
@@ -79,7 +134,7 @@ protected:
 
 private:
 	std::string m_filePath;
-	std::string m_folderPath;
+	ModelAsset* m_asset = nullptr;
 	std::vector<Material*> m_materials;
 	std::vector<Mesh*> m_meshes;
 	GLenum m_mode;
@@ -0,0 +1,409 @@
+#include "RenderQueue.h"
+#include "GLStateCache.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "MaterialTable.h"
+#include "Shader.h"
+#include "ShaderPermutation.h"
+#include "Frustum.h"
+#include "HiZBuffer.h"
+
+#include <algorithm>
+#include <array>
+
+constexpr unsigned int CullGroupSize = 64;
+constexpr UniformID FrustumPlaneIDs[] = {
+	"frustumPlanes[0]", "frustumPlanes[1]", "frustumPlanes[2]",
+	"frustumPlanes[3]", "frustumPlanes[4]", "frustumPlanes[5]" };
+
+constexpr uint64_t RenderQueueDepthBits = 24;
+constexpr uint64_t RenderQueueMaterialBits = 23;
+constexpr uint64_t RenderQueueFeatureBits = 5;
+constexpr uint64_t RenderQueueDepthMask = (1ull << RenderQueueDepthBits) - 1;
+constexpr uint64_t RenderQueueMaterialMask = (1ull << RenderQueueMaterialBits) - 1;
+constexpr uint64_t RenderQueueFeatureMask = (1ull << RenderQueueFeatureBits) - 1;
+static_assert(RenderQueueFeatureBits >= MaterialFeatureCount, "Every material feature must fit in sort key");
+
+RenderQueue::~RenderQueue()
+{
+	glDeleteBuffers(1, &m_commandBuffer);
+	glDeleteBuffers(1, &m_drawDataBuffer);
+	glDeleteBuffers(1, &m_cullDataBuffer);
+	glDeleteBuffers(1, &m_culledCommandBuffer);
+	glDeleteBuffers(1, &m_drawCountBuffer);
+	glDeleteBuffers(1, &m_occlusionStatsBuffer);
+}
+
+void RenderQueue::Clear()
+{
+	m_items.clear();
+	m_keys.clear();
+	m_order.clear();
+}
+
+uint64_t RenderQueue::EncodeKey(ERenderQueueSortMode mode, const RenderItem& item, float maxDepth)
+{
+	const float normalizedDepth = glm::clamp(item.Depth / maxDepth, 0.0f, 1.0f);
+	const uint64_t depth = static_cast<uint64_t>(normalizedDepth * static_cast<float>(RenderQueueDepthMask)) & RenderQueueDepthMask;
+	const uint64_t material = static_cast<uint64_t>(item.DrawMesh->GetMaterial()->GetID()) & RenderQueueMaterialMask;
+	const uint64_t cull = item.bDoubleSided ? 1 : 0;
+	const uint64_t features = static_cast<uint64_t>(item.MaterialFeatures) & RenderQueueFeatureMask;
+
+	switch (mode)
+	{
+	case ERenderQueueSortMode::FrontToBack:
+		// [63:40] Depth | [39] Cull | [38:16] Material
+		return (depth << 40) | (cull << 39) | (material << 16);
+
+	case ERenderQueueSortMode::StateFirst:
+	default:
+		// [63:59] Material features | [58] Cull | [57:35] Material | [34:11] Depth
+		return (features << 59) | (cull << 58) | (material << 35) | (depth << 11);
+	}
+}
+
+void RenderQueue::Sort(ERenderQueueSortMode mode, float maxDepth)
+{
+	maxDepth = glm::max(maxDepth, 0.0001f);
+
+	m_keys.resize(m_items.size());
+	m_order.resize(m_items.size());
+	for (uint32_t idx = 0; idx < m_items.size(); ++idx)
+	{
+		m_keys[idx] = EncodeKey(mode, m_items[idx], maxDepth);
+		m_order[idx] = idx;
+	}
+
+	RadixSort();
+}
+
+void RenderQueue::RadixSort()
+{
+	const size_t count = m_keys.size();
+	if (count < 2)
+	{
+		return;
+	}
+
+	m_tempKeys.resize(count);
+	m_tempOrder.resize(count);
+
+	for (unsigned int shift = 0; shift < 64; shift += 8)
+	{
+		std::array<uint32_t, 256> histogram{ };
+		for (const uint64_t key : m_keys)
+		{
+			++histogram[(key >> shift) & 0xFF];
+		}
+
+		// Every key shares this digit, order is already stable for it
+		if (histogram[(m_keys[0] >> shift) & 0xFF] == count)
+		{
+			continue;
+		}
+
+		uint32_t offset = 0;
+		for (auto& bucket : histogram)
+		{
+			const uint32_t bucketSize = bucket;
+			bucket = offset;
+			offset += bucketSize;
+		}
+
+		for (size_t idx = 0; idx < count; ++idx)
+		{
+			const uint32_t dst = histogram[(m_keys[idx] >> shift) & 0xFF]++;
+			m_tempKeys[dst] = m_keys[idx];
+			m_tempOrder[dst] = m_order[idx];
+		}
+
+		m_keys.swap(m_tempKeys);
+		m_order.swap(m_tempOrder);
+	}
+}
+
+void RenderQueue::GroupInstances(size_t begin, size_t end)
+{
+	m_instanceGroups.clear();
+	m_instanceKeys.clear();
+	for (size_t idx = begin; idx < end; ++idx)
+	{
+		// Group index by first appearance keeps sorted order between groups
+		const MeshGeometry* geometry = m_items[m_order[idx]].DrawMesh->GetGeometry();
+		const uint64_t group = m_instanceGroups.try_emplace(geometry, static_cast<uint32_t>(m_instanceGroups.size())).first->second;
+		m_instanceKeys.push_back((group << 32) | m_order[idx]);
+	}
+
+	// Every item has its own geometry; nothing to merge
+	if (m_instanceGroups.size() == (end - begin))
+	{
+		return;
+	}
+
+	// Stable by group only; sorted order inside of each group is kept
+	std::stable_sort(m_instanceKeys.begin(), m_instanceKeys.end(), [](uint64_t lhs, uint64_t rhs) { return (lhs >> 32) < (rhs >> 32); });
+	for (size_t idx = begin; idx < end; ++idx)
+	{
+		m_order[idx] = static_cast<uint32_t>(m_instanceKeys[idx - begin]);
+	}
+}
+
+bool RenderQueue::CanBatch(const RenderItem& lhs, const RenderItem& rhs, bool bForceCullFace, bool bSplitFeatures)
+{
+	return lhs.Mode == rhs.Mode &&
+		(bForceCullFace || lhs.bDoubleSided == rhs.bDoubleSided) &&
+		(!bSplitFeatures || lhs.MaterialFeatures == rhs.MaterialFeatures);
+}
+
+bool RenderQueue::IsGPUCullingSupported()
+{
+	return glMultiDrawElementsIndirectCount != nullptr || glMultiDrawElementsIndirectCountARB != nullptr;
+}
+
+void RenderQueue::Submit(bool bForceCullFace, ShaderPermutation* permutation, uint32_t passFeatures, const GPUCullParams* cull)
+{
+	m_lastSubmitDrawCalls = 0;
+	m_lastSubmitCommands = 0;
+	if (m_order.empty())
+	{
+		return;
+	}
+
+	if (m_commandBuffer == 0)
+	{
+		glCreateBuffers(1, &m_commandBuffer);
+		glCreateBuffers(1, &m_drawDataBuffer);
+	}
+
+	const bool bGPUCulling = cull != nullptr && cull->ViewFrustum != nullptr && m_cullPass != nullptr && IsGPUCullingSupported();
+	if (bGPUCulling && m_cullDataBuffer == 0)
+	{
+		glCreateBuffers(1, &m_cullDataBuffer);
+		glCreateBuffers(1, &m_culledCommandBuffer);
+		glCreateBuffers(1, &m_drawCountBuffer);
+		glCreateBuffers(1, &m_occlusionStatsBuffer);
+		glNamedBufferData(m_occlusionStatsBuffer, sizeof(OcclusionCullStats), nullptr, GL_DYNAMIC_COPY);
+	}
+
+	if (bGPUCulling && cull->HiZ != nullptr)
+	{
+		// Accumulated over every chunk of this submit
+		const GLuint zero = 0;
+		glClearNamedBufferData(m_occlusionStatsBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+	}
+
+	GeometryBuffer::Bind();
+
+	if (permutation != nullptr)
+	{
+		// Submit every variant this pass needs before the first bind, so new variants compile in parallel
+		uint32_t lastFeatures = ~0u;
+		for (const uint32_t itemIdx : m_order)
+		{
+			if (m_items[itemIdx].MaterialFeatures != lastFeatures)
+			{
+				lastFeatures = m_items[itemIdx].MaterialFeatures;
+				permutation->Get(passFeatures | lastFeatures);
+			}
+		}
+	}
+
+	for (size_t chunkBegin = 0; chunkBegin < m_order.size(); chunkBegin += MaxDrawsPerSubmit)
+	{
+		const size_t drawCount = std::min<size_t>(m_order.size() - chunkBegin, MaxDrawsPerSubmit);
+
+		m_batches.clear();
+		for (size_t batchBegin = 0; batchBegin < drawCount; )
+		{
+			const RenderItem& item = m_items[m_order[chunkBegin + batchBegin]];
+			size_t batchEnd = batchBegin + 1;
+			while (batchEnd < drawCount && CanBatch(item, m_items[m_order[chunkBegin + batchEnd]], bForceCullFace, permutation != nullptr))
+			{
+				++batchEnd;
+			}
+
+			m_batches.push_back(Batch{ batchBegin, batchEnd });
+			batchBegin = batchEnd;
+		}
+
+		m_commands.clear();
+		m_drawData.resize(drawCount);
+		m_cullData.clear();
+		for (size_t batchIdx = 0; batchIdx < m_batches.size(); ++batchIdx)
+		{
+			Batch& batch = m_batches[batchIdx];
+			if (m_bInstancing && (batch.End - batch.Begin) > 1)
+			{
+				GroupInstances(chunkBegin + batch.Begin, chunkBegin + batch.End);
+			}
+
+			batch.CommandBegin = m_commands.size();
+			const MeshGeometry* lastGeometry = nullptr;
+			for (size_t drawIdx = batch.Begin; drawIdx < batch.End; ++drawIdx)
+			{
+				const RenderItem& item = m_items[m_order[chunkBegin + drawIdx]];
+				m_drawData[drawIdx].WorldMatrix = item.WorldMatrix;
+				m_drawData[drawIdx].MaterialIndex = item.DrawMesh->GetMaterial()->GetTableIndex();
+
+				const MeshGeometry* geometry = item.DrawMesh->GetGeometry();
+				m_drawData[drawIdx].PositionOffset = geometry->GetAllocation().PositionOffset;
+				m_drawData[drawIdx].PositionScale = geometry->GetAllocation().PositionScale;
+				if (m_bInstancing && geometry == lastGeometry)
+				{
+					// Instance i reads DrawData of (BaseInstance + i) through instance rate draw index attribute
+					DrawElementsIndirectCommand& command = m_commands.back();
+					++command.InstanceCount;
+					if (bGPUCulling)
+					{
+						// Whole command is culled at once; bounds of every instance in world space
+						DrawCullData& cullData = m_cullData.back();
+						AABB worldBounds = item.LocalBounds.Transformed(item.WorldMatrix);
+						if (command.InstanceCount == 2)
+						{
+							const RenderItem& firstInstance = m_items[m_order[chunkBegin + command.BaseInstance]];
+							worldBounds.Combine(firstInstance.LocalBounds.Transformed(firstInstance.WorldMatrix));
+						}
+						else
+						{
+							worldBounds.Combine(AABB{ cullData.BoundsMin, cullData.BoundsMax });
+						}
+
+						cullData.BoundsMin = worldBounds.Min;
+						cullData.BoundsMax = worldBounds.Max;
+					}
+
+					continue;
+				}
+
+				lastGeometry = geometry;
+				m_commands.push_back(item.DrawMesh->GetIndirectCommand(static_cast<GLuint>(drawIdx)));
+				if (bGPUCulling)
+				{
+					DrawCullData cullData;
+					cullData.BoundsMin = item.LocalBounds.Min;
+					cullData.BoundsMax = item.LocalBounds.Max;
+					cullData.BatchIndex = static_cast<GLuint>(batchIdx);
+					cullData.BatchBegin = static_cast<GLuint>(batch.CommandBegin);
+					m_cullData.push_back(cullData);
+				}
+			}
+
+			batch.CommandEnd = m_commands.size();
+		}
+
+		const size_t commandCount = m_commands.size();
+		m_lastSubmitCommands += static_cast<unsigned int>(commandCount);
+
+		// Re-specify(orphan) storage, so previous pass which still reads old data does not stall
+		glNamedBufferData(m_commandBuffer, sizeof(DrawElementsIndirectCommand) * commandCount, m_commands.data(), GL_STREAM_DRAW);
+		glNamedBufferData(m_drawDataBuffer, sizeof(DrawData) * drawCount, m_drawData.data(), GL_STREAM_DRAW);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DrawDataBinding, m_drawDataBuffer);
+
+		if (bGPUCulling)
+		{
+			DispatchCulling(*cull, commandCount, m_batches.size());
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_culledCommandBuffer);
+			glBindBuffer(GL_PARAMETER_BUFFER, m_drawCountBuffer);
+		}
+		else
+		{
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+		}
+
+		for (size_t batchIdx = 0; batchIdx < m_batches.size(); ++batchIdx)
+		{
+			const Batch& batch = m_batches[batchIdx];
+			const RenderItem& item = m_items[m_order[chunkBegin + batch.Begin]];
+			if (permutation != nullptr)
+			{
+				permutation->Get(passFeatures | item.MaterialFeatures)->Bind();
+			}
+
+			if (!bForceCullFace)
+			{
+				GLStateCache::SetEnabled(GL_CULL_FACE, !item.bDoubleSided);
+			}
+
+			if (bGPUCulling)
+			{
+				MultiDrawIndirectCount(item.Mode, batch.CommandBegin, batchIdx, batch.CommandEnd - batch.CommandBegin);
+			}
+			else
+			{
+				glMultiDrawElementsIndirect(
+					item.Mode,
+					GL_UNSIGNED_INT,
+					reinterpret_cast<void*>(sizeof(DrawElementsIndirectCommand) * batch.CommandBegin),
+					static_cast<GLsizei>(batch.CommandEnd - batch.CommandBegin),
+					0);
+			}
+
+			++m_lastSubmitDrawCalls;
+		}
+	}
+}
+
+void RenderQueue::DispatchCulling(const GPUCullParams& cull, size_t commandCount, size_t batchCount)
+{
+	glNamedBufferData(m_cullDataBuffer, sizeof(DrawCullData) * commandCount, m_cullData.data(), GL_STREAM_DRAW);
+	glNamedBufferData(m_culledCommandBuffer, sizeof(DrawElementsIndirectCommand) * commandCount, nullptr, GL_STREAM_DRAW);
+	glNamedBufferData(m_drawCountBuffer, sizeof(GLuint) * batchCount, nullptr, GL_STREAM_DRAW);
+	const GLuint zero = 0;
+	glClearNamedBufferData(m_drawCountBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DrawCullDataBinding, m_cullDataBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CullInputCommandBinding, m_commandBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CullOutputCommandBinding, m_culledCommandBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DrawCountBinding, m_drawCountBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, OcclusionStatsBinding, m_occlusionStatsBuffer);
+
+	// Pass program was bound by caller before submit; restore it after dispatch
+	const GLuint passProgram = GLStateCache::GetProgram();
+
+	const auto& planes = cull.ViewFrustum->GetPlanes();
+	m_cullPass->Bind();
+	for (size_t idx = 0; idx < planes.size(); ++idx)
+	{
+		m_cullPass->SetVec4f(FrustumPlaneIDs[idx], planes[idx]);
+	}
+	m_cullPass->SetInt("numCommands", static_cast<int>(commandCount));
+
+	m_cullPass->SetInt("bOcclusionCulling", (cull.HiZ != nullptr) ? 1 : 0);
+	if (cull.HiZ != nullptr)
+	{
+		cull.HiZ->Bind(HiZTextureUnit);
+		m_cullPass->SetMat4f("occlusionViewProj", cull.OcclusionViewProj);
+		m_cullPass->SetVec2f("hiZUVScale", cull.HiZUVScale);
+		m_cullPass->SetVec2f("hiZSize", glm::vec2(cull.HiZ->GetWidth(), cull.HiZ->GetHeight()));
+		m_cullPass->SetInt("hiZLevels", static_cast<int>(cull.HiZ->GetLevels()));
+	}
+	m_cullPass->Dispatch(static_cast<unsigned int>((commandCount + CullGroupSize - 1) / CullGroupSize), 1, 1);
+
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+	GLStateCache::UseProgram(passProgram);
+}
+
+OcclusionCullStats RenderQueue::ReadOcclusionStats() const
+{
+	OcclusionCullStats stats;
+	if (m_occlusionStatsBuffer != 0)
+	{
+		glGetNamedBufferSubData(m_occlusionStatsBuffer, 0, sizeof(OcclusionCullStats), &stats);
+	}
+
+	return stats;
+}
+
+void RenderQueue::MultiDrawIndirectCount(GLenum mode, size_t firstCommand, size_t batchIndex, size_t maxDrawCount)
+{
+	const void* indirect = reinterpret_cast<void*>(sizeof(DrawElementsIndirectCommand) * firstCommand);
+	const GLintptr drawCount = static_cast<GLintptr>(sizeof(GLuint) * batchIndex);
+	if (glMultiDrawElementsIndirectCount != nullptr)
+	{
+		glMultiDrawElementsIndirectCount(mode, GL_UNSIGNED_INT, indirect, drawCount, static_cast<GLsizei>(maxDrawCount), 0);
+	}
+	else
+	{
+		glMultiDrawElementsIndirectCountARB(mode, GL_UNSIGNED_INT, indirect, drawCount, static_cast<GLsizei>(maxDrawCount), 0);
+	}
+}
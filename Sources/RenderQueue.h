@@ -0,0 +1,181 @@
+#pragma once
+#include "Rendering.h"
+#include "GeometryBuffer.h"
+#include "AABB.h"
+#include "glm/glm.hpp"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+class Mesh;
+class MeshGeometry;
+class Shader;
+class ShaderPermutation;
+class Frustum;
+class HiZBuffer;
+
+/* SSBO binding point of per draw(instance) data, indexed by draw index attribute */
+constexpr GLuint DrawDataBinding = 0;
+/* SSBO binding points of GPU frustum culling pass */
+constexpr GLuint DrawCullDataBinding = 2;
+constexpr GLuint CullInputCommandBinding = 3;
+constexpr GLuint CullOutputCommandBinding = 4;
+constexpr GLuint DrawCountBinding = 5;
+constexpr GLuint OcclusionStatsBinding = 6;
+
+/* std430 layout of 'DrawData' in shaders */
+struct DrawData
+{
+	glm::mat4 WorldMatrix = glm::mat4(1.0f);
+	/* Dequantization of packed positions; see GeometryAllocation */
+	glm::vec3 PositionOffset = glm::vec3(0.0f);
+	GLuint MaterialIndex = 0;
+	glm::vec3 PositionScale = glm::vec3(1.0f);
+	float Padding = 0.0f;
+};
+
+static_assert(sizeof(DrawData) == 96, "DrawData must match std430 layout");
+
+/* std430 layout of 'DrawCullData' in frustum culling shader */
+struct DrawCullData
+{
+	/* Local space bounds; world space bounds of every instance if command draws more than one instance */
+	glm::vec3 BoundsMin = glm::vec3(0.0f);
+	GLuint BatchIndex = 0;
+	glm::vec3 BoundsMax = glm::vec3(0.0f);
+	/* Index of first command of the batch; visible commands are compacted from here */
+	GLuint BatchBegin = 0;
+};
+
+/* std430 layout of 'OcclusionStats' in frustum culling shader; commands which were inside frustum but behind Hi-Z */
+struct OcclusionCullStats
+{
+	GLuint CulledCommands = 0;
+	GLuint CulledInstances = 0;
+	/* Index count * instance count; vertex shader invocations skipped before post transform cache */
+	GLuint CulledIndices = 0;
+	GLuint Padding = 0;
+};
+
+/* Inputs of GPU culling pass */
+struct GPUCullParams
+{
+	const Frustum* ViewFrustum = nullptr;
+	/* Occlusion culling is skipped if null */
+	HiZBuffer* HiZ = nullptr;
+	/* View projection which depth of HiZ was rendered with */
+	glm::mat4 OcclusionViewProj = glm::mat4(1.0f);
+	/* Render area size / pyramid size */
+	glm::vec2 HiZUVScale = glm::vec2(1.0f);
+};
+
+enum class ERenderQueueSortMode
+{
+	/* Material features > Cull mode > Material > Depth; minimizes state changes and keeps texture accesses coherent */
+	StateFirst,
+	/* Depth > Cull mode > Material; maximizes early-z rejection */
+	FrontToBack
+};
+
+struct RenderItem
+{
+	Mesh* DrawMesh = nullptr;
+	glm::mat4 WorldMatrix = glm::mat4(1.0f);
+	GLenum Mode = GL_TRIANGLES;
+	bool bDoubleSided = false;
+	float Depth = 0.0f;
+	/* EMaterialFlag bits, selects variant when submitted with shader permutation */
+	uint32_t MaterialFeatures = 0;
+	/* Local space bounds of mesh; tested against frustum by GPU culling pass */
+	AABB LocalBounds;
+};
+
+/*
+* Collects visible draw items of a pass, sorts them by 64-bit key and submits in order.
+* Sort is LSD radix sort over 8-bit digits; digits which are same on every key are skipped.
+* Sorted items are submitted as glMultiDrawElementsIndirect batches from the shared geometry buffer.
+* With instancing, items of a batch which share mesh geometry are drawn by one instanced command;
+* each instance still reads its own world matrix and material from consecutive DrawData.
+**/
+class RenderQueue
+{
+public:
+	~RenderQueue();
+
+	void Clear();
+	void Push(const RenderItem& item) { m_items.push_back(item); }
+
+	/* maxDepth : Depth which maps to farthest quantized depth value */
+	void Sort(ERenderQueueSortMode mode, float maxDepth);
+
+	/*
+	* Consecutive items with same cull mode and primitive mode are merged into one multi draw.
+	* Inside a multi draw, items of same geometry are gathered(in order of first appearance) into one instanced command.
+	* With permutation, batches also split by material features and each binds variant of (passFeatures | MaterialFeatures).
+	* With cull params, every command is tested by compute shader(frustum, then Hi-Z occlusion) which compacts visible commands of each batch,
+	* then batches are drawn with glMultiDrawElementsIndirectCount. Items must not be culled on CPU in that case.
+	**/
+	void Submit(bool bForceCullFace, ShaderPermutation* permutation = nullptr, uint32_t passFeatures = 0, const GPUCullParams* cull = nullptr);
+
+	/* Compute shader of GPU frustum culling(FrustumCullCS.comp) */
+	void SetCullPass(Shader* cullPass) { m_cullPass = cullPass; }
+	/* Requires glMultiDrawElementsIndirectCount(GL 4.6 or ARB_indirect_parameters) */
+	static bool IsGPUCullingSupported();
+
+	/* Merges items of same geometry into instanced commands */
+	void SetInstancing(bool bEnable) { m_bInstancing = bEnable; }
+	bool IsInstancingEnabled() const { return m_bInstancing; }
+
+	size_t GetSize() const { return m_items.size(); }
+	unsigned int GetLastSubmitDrawCalls() const { return m_lastSubmitDrawCalls; }
+	/* Indirect commands of last submit; less than items when instances were merged */
+	unsigned int GetLastSubmitCommands() const { return m_lastSubmitCommands; }
+	/* Counters of last submit with occlusion culling; reading back stalls until GPU finishes it, so debug output only */
+	OcclusionCullStats ReadOcclusionStats() const;
+
+private:
+	static uint64_t EncodeKey(ERenderQueueSortMode mode, const RenderItem& item, float maxDepth);
+	static bool CanBatch(const RenderItem& lhs, const RenderItem& rhs, bool bForceCullFace, bool bSplitFeatures);
+	void RadixSort();
+	/* Reorders m_order[begin, end) so that items of same geometry are consecutive */
+	void GroupInstances(size_t begin, size_t end);
+	void DispatchCulling(const GPUCullParams& cull, size_t commandCount, size_t batchCount);
+	static void MultiDrawIndirectCount(GLenum mode, size_t firstCommand, size_t batchIndex, size_t maxDrawCount);
+
+private:
+	std::vector<RenderItem> m_items;
+	std::vector<uint64_t> m_keys;
+	std::vector<uint32_t> m_order;
+
+	std::vector<uint64_t> m_tempKeys;
+	std::vector<uint32_t> m_tempOrder;
+
+	struct Batch
+	{
+		size_t Begin = 0;
+		size_t End = 0;
+		size_t CommandBegin = 0;
+		size_t CommandEnd = 0;
+	};
+
+	bool m_bInstancing = true;
+	std::vector<uint64_t> m_instanceKeys;
+	std::unordered_map<const MeshGeometry*, uint32_t> m_instanceGroups;
+
+	std::vector<Batch> m_batches;
+	std::vector<DrawElementsIndirectCommand> m_commands;
+	std::vector<DrawData> m_drawData;
+	std::vector<DrawCullData> m_cullData;
+	GLuint m_commandBuffer = 0;
+	GLuint m_drawDataBuffer = 0;
+
+	Shader* m_cullPass = nullptr;
+	GLuint m_cullDataBuffer = 0;
+	GLuint m_culledCommandBuffer = 0;
+	GLuint m_drawCountBuffer = 0;
+	GLuint m_occlusionStatsBuffer = 0;
+
+	unsigned int m_lastSubmitDrawCalls = 0;
+	unsigned int m_lastSubmitCommands = 0;
+
+};
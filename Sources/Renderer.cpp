@@ -1,6 +1,10 @@
 #include "Renderer.h"
+#include "GLStateCache.h"
+#include "Material.h"
+#include "MaterialTable.h"
 #include "Scene.h"
 #include "Mesh.h"
+#include "GeometryBuffer.h"
 #include "Model.h"
 #include "Camera.h"
 #include "Viewport.h"
@@ -12,10 +16,34 @@
 #include "FBO.h"
 #include "ShadowMap.h"
 #include "Frustum.h"
+#include "UniformRingBuffer.h"
+#include "ShaderPermutation.h"
+#include "HiZBuffer.h"
+#include "FrustumCuller.h"
+#include "TextureStreamer.h"
+
+static_assert(EVCTFeature::VCTDirectDiffuse == (1u << MaterialFeatureCount), "VCT features must start right above material features");
+
+static float Halton(unsigned int index, unsigned int base)
+{
+	float result = 0.0f;
+	float fraction = 1.0f;
+	while (index > 0)
+	{
+		fraction /= static_cast<float>(base);
+		result += fraction * static_cast<float>(index % base);
+		index /= base;
+	}
+
+	return result;
+}
 
 Renderer::~Renderer()
 {
 	delete m_frustum;
+	delete m_shadowFrustum;
+	delete m_frustumCullPass;
+	delete m_uniformRing;
 
 	if (m_gBuffer != nullptr)
 	{
@@ -41,15 +69,33 @@ Renderer::~Renderer()
 	delete m_voxelVolume;
 	delete m_voxelizePass;
 	delete m_renderVoxelPass;
-	delete m_vctPass;
+	delete m_vctPermutation;
+
+	delete m_depthPrepass;
+	glDeleteQueries(2, m_prepassSampleQueries);
+	glDeleteQueries(2, m_vctSampleQueries);
+
+	delete m_sceneTarget;
+	delete m_historyTargets[0];
+	delete m_historyTargets[1];
+	delete m_temporalUpscalePass;
+	glDeleteQueries(2, m_gpuTimerQueries);
+	delete m_hiZBuffer;
 }
 
 bool Renderer::Init(unsigned int width, unsigned int height)
 {
 	m_winWidth = width;
 	m_winHeight = height;
+	m_renderWidth = width;
+	m_renderHeight = height;
 
+	GLStateCache::Invalidate();
 	m_frustum = new Frustum();
+	m_shadowFrustum = new Frustum();
+	m_frustumCullPass = new Shader("Resources/Shaders/FrustumCullCS.comp");
+	m_renderQueue.SetCullPass(m_frustumCullPass);
+	m_uniformRing = new UniformRingBuffer(4096);
 
 	m_gBuffer = new GBuffer(width, height);
 	if (!m_gBuffer->Init())
@@ -57,23 +103,25 @@ bool Renderer::Init(unsigned int width, unsigned int height)
 		return false;
 	}
 
+	MaterialTable::Init();
+	// Every pass drawing from GeometryBuffer decodes its vertex format
+	const std::vector<std::string> vertexDefines = GeometryBuffer::GetShaderDefines();
+	std::vector<std::string> materialDefines = MaterialTable::GetShaderDefines();
+	materialDefines.insert(materialDefines.end(), vertexDefines.begin(), vertexDefines.end());
+
 	m_geometryPass = new Shader(
 		"Resources/Shaders/GeometryPass.vs",
-		"Resources/Shaders/GeometryPass.fs");
+		"Resources/Shaders/GeometryPass.fs",
+		materialDefines);
 
 	m_lightingPass = new Shader(
 		"Resources/Shaders/LightingPass.vs",
 		"Resources/Shaders/LightingPass.fs");
-	m_lightingPass->Bind();
-	m_lightingPass->SetInt("positionBuffer", 0);
-	m_lightingPass->SetInt("normalBuffer", 1);
-	m_lightingPass->SetInt("albedoBuffer", 2);
-	m_lightingPass->SetInt("metallicRoughnessBuffer", 3);
-	m_lightingPass->SetInt("emissiveAOBuffer", 4);
 
 	m_shadowPass = new Shader(
 		"Resources/Shaders/ShadowVS.vert",
-		"Resources/Shaders/ShadowFS.frag");
+		"Resources/Shaders/ShadowFS.frag",
+		vertexDefines);
 	m_shadowMap = new ShadowMap(ShadowMapRes, ShadowMapRes);
 
 	m_voxelVolume = new Texture3D(
@@ -101,7 +149,8 @@ bool Renderer::Init(unsigned int width, unsigned int height)
 	m_encodedVoxelizePass = new Shader(
 		"Resources/Shaders/VoxelizationVS.glsl",
 		"Resources/Shaders/VoxelizationGS.glsl",
-		"Resources/Shaders/VoxelizationR32UIFS.frag");
+		"Resources/Shaders/VoxelizationR32UIFS.frag",
+		materialDefines);
 
 	//m_voxelizePass = new Shader(
 	//	"Resources/Shaders/VoxelizationVS.glsl",
@@ -116,9 +165,29 @@ bool Renderer::Init(unsigned int width, unsigned int height)
 	glGenVertexArrays(1, &m_texture3DVAO);
 	glGenVertexArrays(1, &m_boundingBoxPointVAO);
 
-	m_vctPass = new Shader(
+	// Material flags and debug toggles become compile time constants of each variant
+	std::vector<std::string> vctDefines = materialDefines;
+	vctDefines.emplace_back("MATERIAL_PERMUTATION");
+	std::vector<std::string> vctFeatureDefines = MaterialTable::GetFeatureDefines();
+	vctFeatureDefines.insert(vctFeatureDefines.end(), {
+		"ENABLE_DIRECT_DIFFUSE",
+		"ENABLE_INDIRECT_DIFFUSE",
+		"ENABLE_DIRECT_SPECULAR",
+		"ENABLE_INDIRECT_SPECULAR",
+		"DEBUG_AMBIENT_OCCLUSION",
+		"EARLY_DEPTH_TEST" });
+	m_vctPermutation = new ShaderPermutation(
 		"Resources/Shaders/VoxelConeTracingVS.vert",
-		"Resources/Shaders/VoxelConeTracingFS.frag");
+		"Resources/Shaders/VoxelConeTracingFS.frag",
+		vctDefines,
+		vctFeatureDefines);
+
+	m_depthPrepass = new Shader(
+		"Resources/Shaders/DepthPrepassVS.vert",
+		"Resources/Shaders/DepthPrepassFS.frag",
+		materialDefines);
+	glGenQueries(2, m_prepassSampleQueries);
+	glGenQueries(2, m_vctSampleQueries);
 
 	float quadVertices[] = {
 		-1.0f,  1.0f, 0.0f, 0.0f, 1.0f,
@@ -129,7 +198,7 @@ bool Renderer::Init(unsigned int width, unsigned int height)
 
 	glGenVertexArrays(1, &m_quadVAO);
 	glGenBuffers(1, &m_quadVBO);
-	glBindVertexArray(m_quadVAO);
+	GLStateCache::BindVertexArray(m_quadVAO);
 	glBindBuffer(GL_ARRAY_BUFFER, m_quadVBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
 	glEnableVertexAttribArray(0);
@@ -138,10 +207,10 @@ bool Renderer::Init(unsigned int width, unsigned int height)
 	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3*sizeof(float)));
 
 	//glEnable(GL_MULTISAMPLE);
-	glEnable(GL_DEPTH_TEST);
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_BACK);
-	glFrontFace(GL_CCW);
+	GLStateCache::Enable(GL_DEPTH_TEST);
+	GLStateCache::Enable(GL_CULL_FACE);
+	GLStateCache::CullFace(GL_BACK);
+	GLStateCache::FrontFace(GL_CCW);
 
 	m_texture3DReductionRGBA = new Shader("Resources/Shaders/Texture3DReductionRGBA8CS.comp");
 	m_decodeR32UIToRGBA8 = new Shader("Resources/Shaders/DecodeR32UIToRGBA8CS.comp");
@@ -149,13 +218,33 @@ bool Renderer::Init(unsigned int width, unsigned int height)
 	m_visualizeConeDirPass = new Shader(
 		"Resources/Shaders/VisualizeDiffuseConeDirection.vert",
 		"Resources/Shaders/VisualizeDiffuseConeDirection.geom",
-		"Resources/Shaders/VisualizeDiffuseConeDirection.frag");
+		"Resources/Shaders/VisualizeDiffuseConeDirection.frag",
+		vertexDefines);
 
 	m_visualizeBoundingBoxPass = new Shader(
 		"Resources/Shaders/VisualizeBoundingBox.vert",
 		"Resources/Shaders/VisualizeBoundingBox.geom",
 		"Resources/Shaders/VisualizeBoundingBox.frag");
 
+	m_sceneTarget = new FBO(width, height, GL_LINEAR, GL_LINEAR, GL_RGBA16F, GL_FLOAT, GL_CLAMP_TO_EDGE, true);
+	m_historyTargets[0] = new FBO(width, height, GL_LINEAR, GL_LINEAR, GL_RGBA16F, GL_FLOAT, GL_CLAMP_TO_EDGE);
+	m_historyTargets[1] = new FBO(width, height, GL_LINEAR, GL_LINEAR, GL_RGBA16F, GL_FLOAT, GL_CLAMP_TO_EDGE);
+	m_temporalUpscalePass = new Shader(
+		"Resources/Shaders/TemporalUpscaleVS.vert",
+		"Resources/Shaders/TemporalUpscaleFS.frag");
+	glGenQueries(2, m_gpuTimerQueries);
+	m_hiZBuffer = new HiZBuffer(width, height);
+
+	// Every program above was only submitted; collect results once all of them are compiling
+	Shader::FinishPending();
+
+	m_lightingPass->Bind();
+	m_lightingPass->SetInt("positionBuffer", 0);
+	m_lightingPass->SetInt("normalBuffer", 1);
+	m_lightingPass->SetInt("albedoBuffer", 2);
+	m_lightingPass->SetInt("metallicRoughnessBuffer", 3);
+	m_lightingPass->SetInt("emissiveAOBuffer", 4);
+
 	return true;
 }
 
@@ -164,9 +253,30 @@ void Renderer::Render(const Scene* scene)
 	const auto camera = scene->GetMainCamera();
 	m_frustum->Construct(camera->GetViewMatrix(), camera->GetProjMatrix());
 
+	m_uniformRing->BeginFrame();
+	UpdateLightConstants(scene);
+	UpdateVoxelConstants();
+
+	// Streamed textures replacing placeholders change voxelized albedo/emission
+	if (TextureStreamer::Update() > 0)
+	{
+		m_bNeedVoxelize = true;
+	}
+
+	MaterialTable::Update();
+	MaterialTable::Bind();
+
 	Shadow(scene);
 	//Voxelize(scene);
 	EncodedVoxelize(scene);
+
+	BeginDynamicResolution(camera);
+	UpdateFrameConstants(camera);
+	if (m_bUpscaleThisFrame)
+	{
+		glBeginQuery(GL_TIME_ELAPSED, m_gpuTimerQueries[m_frameIndex % 2]);
+	}
+
 	switch(m_renderMode)
 	{
 	case ERenderMode::VCT:
@@ -182,6 +292,16 @@ void Renderer::Render(const Scene* scene)
 		break;
 	}
 
+	if (m_bUpscaleThisFrame)
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+		m_bGPUTimerIssued[m_frameIndex % 2] = true;
+		TemporalUpscale(scene);
+
+		// Debug passes are drawn on the upscaled target without jitter
+		UpdateFrameConstants(camera);
+	}
+
 	if (bDebugConeDirection)
 	{
 		DebugConeDirections(scene);
@@ -191,9 +311,20 @@ void Renderer::Render(const Scene* scene)
 	{
 		DebugBoundingBoxes(scene);
 	}
+
+	GLStateCache::EndFrame();
+	m_uniformRing->EndFrame();
+	++m_frameIndex;
 }
 
-void Renderer::PrintVCTParams() const
+bool Renderer::IsOcclusionCullingActive() const
+{
+	// Pyramid needs sampleable depth(scene target) and is only read by GPU culling
+	return bEnableOcclusionCulling && bEnableDepthPrepass && m_bUpscaleThisFrame &&
+		bEnableViewFrustumCulling && bEnableGPUFrustumCulling && RenderQueue::IsGPUCullingSupported();
+}
+
+void Renderer::PrintVCTParams(const Scene* scene) const
 {
 	std::cout << "----   Voxel Cone Tracing Params   ----" << std::endl;
 	std::cout << "VCT_MAX_DISTANCE : " << VCTMaxDistance << std::endl;
@@ -206,76 +337,182 @@ void Renderer::PrintVCTParams() const
 	std::cout << "bEnableIndirectDiffuse : " << bEnableIndirectDiffuse << std::endl;
 	std::cout << "bEnableDirectSpecular : " << bEnableDirectSpecular << std::endl;
 	std::cout << "bEnableIndirectSpecular : " << bEnableIndirectSpecular << std::endl;
+	std::cout << "bEnableDynamicResolution : " << bEnableDynamicResolution << std::endl;
+	std::cout << "bEnableDepthPrepass : " << bEnableDepthPrepass << std::endl;
+	if (bEnableDepthPrepass)
+	{
+		std::cout << "Depth Prepass Saved Fragments(Estimated, at least) : " << m_depthPrepassSavedFragments << " (Shaded : " << m_vctShadedFragments << ")" << std::endl;
+	}
+	std::cout << "GL State Changes (Last Frame) : " << GLStateCache::GetLastFrameIssuedCalls() << " issued, "
+		<< GLStateCache::GetLastFrameFilteredCalls() << " filtered" << std::endl;
+	std::cout << "Render Queue (Last Pass) : " << m_renderQueue.GetSize() << " items, " << m_renderQueue.GetLastSubmitCommands() << " commands, " << m_renderQueue.GetLastSubmitDrawCalls() << " multi draws" << std::endl;
+	std::cout << "Instancing : " << bEnableInstancing << std::endl;
+	std::cout << "Geometry Buffer : " << GeometryBuffer::GetAllocatedVertices() << " vertices(" << GeometryBuffer::GetVertexStride() << " bytes each), "
+		<< GeometryBuffer::GetAllocatedIndices() << " indices" << std::endl;
+	std::cout << "GPU Frustum Culling : " << (bEnableGPUFrustumCulling && RenderQueue::IsGPUCullingSupported()) << std::endl;
+	std::cout << "Hi-Z Occlusion Culling : " << bEnableOcclusionCulling << " (Active : " << IsOcclusionCullingActive() << ")" << std::endl;
+	if (IsOcclusionCullingActive())
+	{
+		// Fragments of occluded meshes were already rejected by early depth test; culling saves their vertex work only
+		const OcclusionCullStats stats = m_renderQueue.ReadOcclusionStats();
+		std::cout << "Hi-Z Occlusion Culled (Last Pass) : " << stats.CulledCommands << " commands, " << stats.CulledInstances << " instances, "
+			<< stats.CulledIndices << " vertex invocations" << std::endl;
+	}
+	std::cout << "CPU Frustum Culling : " << (bEnableSIMDCulling ? FrustumCuller::ToString(FrustumCuller::GetSupportedLevel()) : "BVH") << std::endl;
+	std::cout << "Bindless Materials : " << MaterialTable::IsBindless() << std::endl;
+	if (scene != nullptr)
+	{
+		const BVH& bvh = scene->GetBVH();
+		std::cout << "Scene BVH : " << bvh.GetPrimitiveCount() << " meshes (" << bvh.GetNodeCount() << " nodes)" << (scene->IsBVHOutdated() ? ", outdated" : "") << std::endl;
+	}
+	std::cout << "VCT Shader Variants : " << m_vctPermutation->GetCompiledVariants() << std::endl;
 	std::cout << std::endl;
 }
 
-void Renderer::RenderScene(const Scene* scene, Shader* shader, bool bIsShadowCasting, bool bForceCullFace, bool bEnableFrustumCulling)
+void Renderer::RenderScene(const Scene* scene, bool bIsShadowCasting, bool bForceCullFace, const Frustum* cullFrustum, ERenderQueueSortMode sortMode, ShaderPermutation* permutation, uint32_t passFeatures, bool bEnableOcclusionCulling)
 {
 	if (const Camera* camera = scene->GetMainCamera(); 
 		(camera != nullptr && camera->IsActivated()))
 	{
-		const glm::mat4 view = camera->GetViewMatrix();
-		const glm::mat4 proj = camera->GetProjMatrix();
-		const glm::mat4 viewProj = proj * view;
-		shader->SetMat4f("viewMatrix", view);
-		shader->SetMat4f("projMatrix", proj);
-		shader->SetVec3f("camPos", camera->GetPosition());
+		const glm::vec3 camPos = camera->GetPosition();
+		const bool bGPUCulling = cullFrustum != nullptr && bEnableGPUFrustumCulling && RenderQueue::IsGPUCullingSupported();
+		const bool bCPUCulling = cullFrustum != nullptr && !bGPUCulling;
+		m_renderQueue.Clear();
 
-		if (auto lights = scene->GetLights(); !lights.empty())
+		auto pushItem = [&](Model* model, Mesh* mesh)
 		{
-			shader->SetVec3f("light.Direction", lights[0]->LightDirection());
-			shader->SetVec3f("light.Intensity", lights[0]->GetIntensity());
-		}
+			if (!model->IsActivated() || (bIsShadowCasting && !model->bCastShadow) || mesh->GetMaterial() == nullptr)
+			{
+				return;
+			}
+
+			const auto worldMatrix = model->GetWorldMatrix();
+			const AABB localBoundingBox = mesh->GetBoundingBox();
+			RenderItem item;
+			item.DrawMesh = mesh;
+			item.WorldMatrix = worldMatrix;
+			item.Mode = model->GetMode();
+			item.bDoubleSided = model->bDoubleSided;
+			item.Depth = glm::distance(camPos, glm::vec3(worldMatrix * glm::vec4((localBoundingBox.Min + localBoundingBox.Max) * 0.5f, 1.0f)));
+			item.MaterialFeatures = mesh->GetMaterial()->GetShaderFeatures();
+			item.LocalBounds = localBoundingBox;
+			m_renderQueue.Push(item);
+		};
+
+		const BVH& bvh = scene->GetBVH();
+		if (bCPUCulling && !scene->IsBVHOutdated() && bvh.GetPrimitiveCount() > 0)
+		{
+			if (bEnableSIMDCulling)
+			{
+				// Brute force over every mesh, several boxes per instruction
+				m_bvhQueryResult.resize(bvh.GetPrimitiveCount());
+				m_bvhQueryResult.resize(FrustumCuller::Cull(cullFrustum->GetPlanes(), bvh.GetPrimitiveBounds(), m_bvhQueryResult.data()));
+			}
+			else
+			{
+				// Hierarchy rejects whole clusters of meshes at once
+				m_bvhQueryResult.clear();
+				bvh.QueryFrustum(*cullFrustum, m_bvhQueryResult);
+			}
 
-		for (auto models = scene->GetModels(); auto model : models)
+			for (const uint32_t primIdx : m_bvhQueryResult)
+			{
+				const BVHPrimitive& primitive = bvh.GetPrimitive(primIdx);
+				pushItem(primitive.Owner, primitive.PrimMesh);
+			}
+		}
+		else
 		{
-			if (model != nullptr)
+			for (auto models = scene->GetModels(); auto model : models)
 			{
-				if (model->IsActivated())
+				if (model != nullptr)
 				{
-					if (!bEnableFrustumCulling || m_frustum->IsVisible(model->GetBoundingBox()))
+					for (auto mesh : model->GetMeshes())
 					{
-						if (!bIsShadowCasting || model->bCastShadow)
-						{
-							if (!bForceCullFace)
-							{
-								if (model->bDoubleSided)
-								{
-									glDisable(GL_CULL_FACE);
-								}
-								else
-								{
-									glEnable(GL_CULL_FACE);
-								}
-							}
-
-							const auto worldMatrix = model->GetWorldMatrix();
-							const auto mode = model->GetMode();
-							shader->SetMat4f("worldMatrix", worldMatrix);
-							for (auto mesh : model->GetMeshes())
-							{
-								if(!bEnableFrustumCulling || m_frustum->IsVisible(mesh->GetBoundingBox().Transformed(worldMatrix)))
-								{
-									mesh->Render(shader, mode);
-								}
-							}
-							//model->Render(shader);
-						}
+						pushItem(model, mesh);
 					}
 				}
 			}
 		}
+
+		GPUCullParams cullParams;
+		cullParams.ViewFrustum = cullFrustum;
+		if (bEnableOcclusionCulling)
+		{
+			cullParams.HiZ = m_hiZBuffer;
+			cullParams.OcclusionViewProj = m_hiZViewProj;
+			cullParams.HiZUVScale = glm::vec2(
+				static_cast<float>(m_renderWidth) / static_cast<float>(m_hiZBuffer->GetWidth()),
+				static_cast<float>(m_renderHeight) / static_cast<float>(m_hiZBuffer->GetHeight()));
+		}
+
+		m_renderQueue.Sort(sortMode, camera->GetFarPlane());
+		m_renderQueue.SetInstancing(bEnableInstancing);
+		m_renderQueue.Submit(bForceCullFace, permutation, passFeatures, bGPUCulling ? &cullParams : nullptr);
 	}
 }
 
+void Renderer::UpdateFrameConstants(const Camera* camera)
+{
+	FrameConstants constants;
+	if (camera != nullptr)
+	{
+		constants.ViewMatrix = camera->GetViewMatrix();
+		constants.ProjMatrix = camera->GetProjMatrix();
+		constants.CamPos = camera->GetPosition();
+	}
+
+	m_uniformRing->Bind(FrameConstantsBinding, constants);
+}
+
+void Renderer::UpdateLightConstants(const Scene* scene)
+{
+	LightConstants constants;
+	if (auto lights = scene->GetLights(); !lights.empty())
+	{
+		constants.Direction = lights[0]->LightDirection();
+		constants.Intensity = lights[0]->GetIntensity();
+
+		// Shadow map is re-rendered only when scene is dirty; matrices have to stay in sync with it
+		if (scene->IsSceneDirty() || m_bFirstShadow)
+		{
+			m_shadowViewMat = glm::lookAt(-lights[0]->LightDirection(), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+			m_shadowProjMat = glm::ortho<float>(-120.0f, 120.0f, -120.0f, 120.0f, -500.0f, 500.0f);
+			m_shadowFrustum->Construct(m_shadowViewMat, m_shadowProjMat);
+		}
+	}
+
+	constants.ShadowViewMat = m_shadowViewMat;
+	constants.ShadowProjMat = m_shadowProjMat;
+	m_uniformRing->Bind(LightConstantsBinding, constants);
+}
+
+void Renderer::UpdateVoxelConstants()
+{
+	VoxelConstants constants;
+	constants.ProjX = m_projX;
+	constants.ProjY = m_projY;
+	constants.ProjZ = m_projZ;
+	constants.VoxelGridWorldSize = VoxelGridWorldSize;
+	constants.VoxelDim = static_cast<float>(VoxelUnitSize);
+
+	/* VCT params */
+	constants.MaxDistance = VCTMaxDistance;
+	constants.Step = VCTStep;
+	constants.AlphaThreshold = VCTAlphaThreshold;
+	constants.InitialStep = VCTInitialStep;
+	constants.SpecularSampleNum = static_cast<GLint>(VCTSpecularSampleNum);
+	m_uniformRing->Bind(VoxelConstantsBinding, constants);
+}
+
 void Renderer::DeferredRender(const Scene* scene)
 {
 	if (scene != nullptr)
 	{
-		glEnable(GL_DEPTH_TEST);
-		glEnable(GL_CULL_FACE);
-		glCullFace(GL_BACK);
-		glFrontFace(GL_CCW);
+		GLStateCache::Enable(GL_DEPTH_TEST);
+		GLStateCache::Enable(GL_CULL_FACE);
+		GLStateCache::CullFace(GL_BACK);
+		GLStateCache::FrontFace(GL_CCW);
 
 		// @TODO: Impl render to multiple render targets(textures) which owned by cameras
 		Camera* camera = scene->GetMainCamera();
@@ -285,35 +522,47 @@ void Renderer::DeferredRender(const Scene* scene)
 			glm::vec3 clearColor = camera->GetClearColor();
 			Clear(glm::vec4{ clearColor, 1.0f });
 
-			Viewport* viewport = camera->GetViewport();
-			glViewport(0, 0, viewport->GetWidth(), viewport->GetHeight());
+			if (m_bUpscaleThisFrame)
+			{
+				GLStateCache::Viewport(0, 0, m_renderWidth, m_renderHeight);
+			}
+			else
+			{
+				Viewport* viewport = camera->GetViewport();
+				GLStateCache::Viewport(0, 0, viewport->GetWidth(), viewport->GetHeight());
+			}
 
 			m_geometryPass->Bind();
-			glEnable(GL_DEPTH_TEST);
-			RenderScene(scene, m_geometryPass);
+			GLStateCache::Enable(GL_DEPTH_TEST);
+			RenderScene(scene);
 			m_gBuffer->UnbindFrameBuffer();
 
 			// ########### TEST CODE ##############
-			glViewport(0, 0, m_winWidth, m_winHeight);
+			BindMainRenderTarget();
+			if (m_bUpscaleThisFrame)
+			{
+				// Temporal upscaling requires depth of current frame to reproject history
+				GLStateCache::BindFramebuffer(GL_READ_FRAMEBUFFER, m_gBuffer->GetID());
+				GLStateCache::BindFramebuffer(GL_DRAW_FRAMEBUFFER, m_sceneTarget->GetID());
+				glBlitFramebuffer(
+					0, 0, m_renderWidth, m_renderHeight,
+					0, 0, m_renderWidth, m_renderHeight,
+					GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+				m_sceneTarget->Bind();
+			}
+
 			m_lightingPass->Bind();
+			m_lightingPass->SetVec2f("uvScale", glm::vec2(
+				static_cast<float>(m_renderWidth) / static_cast<float>(m_winWidth),
+				static_cast<float>(m_renderHeight) / static_cast<float>(m_winHeight)));
 			m_gBuffer->BindTextures();
 			m_shadowMap->BindAsTexture(5);
 			m_lightingPass->SetInt("shadowMap", 5);
-			m_lightingPass->SetVec3f("camPos", camera->GetPosition());
-			m_lightingPass->SetMat4f("shadowViewMat", m_shadowViewMat);
-			m_lightingPass->SetMat4f("shadowProjMat", m_shadowProjMat);
 
-		   const std::vector<Light*>& lights = scene->GetLights();
-			if (!lights.empty())
-			{
-				m_lightingPass->SetVec3f("light.Direction", lights[0]->LightDirection());
-				m_lightingPass->SetVec3f("light.Intensity", lights[0]->GetIntensity());
-			}
-
-			glDisable(GL_DEPTH_TEST);
-			glBindVertexArray(m_quadVAO);
+			GLStateCache::Disable(GL_DEPTH_TEST);
+			GLStateCache::BindVertexArray(m_quadVAO);
 			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-			glBindVertexArray(0);
+			GLStateCache::BindVertexArray(0);
 			m_gBuffer->UnbindTextures();
 		}
 	}
@@ -328,22 +577,17 @@ void Renderer::Shadow(const Scene* scene)
 		if (!lights.empty())
 		{
 			m_shadowPass->Bind();
-			glEnable(GL_DEPTH_TEST);
-			glEnable(GL_CULL_FACE);
-			glCullFace(GL_BACK);
-			glFrontFace(GL_CCW);
+			GLStateCache::Enable(GL_DEPTH_TEST);
+			GLStateCache::Enable(GL_CULL_FACE);
+			GLStateCache::CullFace(GL_BACK);
+			GLStateCache::FrontFace(GL_CCW);
 
 			m_shadowMap->Bind();
-			glViewport(0, 0, ShadowMapRes, ShadowMapRes);
+			GLStateCache::Viewport(0, 0, ShadowMapRes, ShadowMapRes);
 			glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-			m_shadowViewMat = glm::lookAt(-lights[0]->LightDirection(), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-			m_shadowProjMat = glm::ortho<float>(-120.0f, 120.0f, -120.0f, 120.0f, -500.0f, 500.0f);
-			m_shadowPass->SetMat4f("shadowViewMatrix", m_shadowViewMat);
-			m_shadowPass->SetMat4f("shadowProjMatrix", m_shadowProjMat);
-
-			RenderScene(scene, m_shadowPass, true);
+			RenderScene(scene, true, false, m_shadowFrustum);
 
 			m_shadowMap->Unbind();
 		}
@@ -356,7 +600,7 @@ void Renderer::Voxelize(const Scene* scene)
 	{
 		if (m_bFirstVoxelize || scene->IsSceneDirty() || bAlwaysVoxelize)
 		{
-			glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+			GLStateCache::ColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
 
 			m_bFirstVoxelize = false;
 			GLfloat volumeClear[4]{ 0.0f, 0.0f, 0.0f, 0.0f };
@@ -364,32 +608,22 @@ void Renderer::Voxelize(const Scene* scene)
 
 			m_voxelizePass->Bind();
 
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
-			glDisable(GL_DEPTH_TEST);
-			glDisable(GL_CULL_FACE);
-
-			// Vertex Shader Uniforms
-			m_voxelizePass->SetMat4f("shadowViewMat", m_shadowViewMat);
-			m_voxelizePass->SetMat4f("shadowProjMat", m_shadowProjMat);
-
-			// Geometry Shader Uniforms
-			m_voxelizePass->SetMat4f("projXAxis", m_projX);
-			m_voxelizePass->SetMat4f("projYAxis", m_projY);
-			m_voxelizePass->SetMat4f("projZAxis", m_projZ);
+			GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
+			GLStateCache::Disable(GL_DEPTH_TEST);
+			GLStateCache::Disable(GL_CULL_FACE);
 
-			// Fragment Shader Uniforms
 			m_voxelizePass->SetInt("shadowMap", 5);
 			m_shadowMap->BindAsTexture(5);
 
 			glBindImageTexture(0, m_voxelVolume->GetID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA8);
-			glViewport(0, 0, VoxelUnitSize, VoxelUnitSize);
-			RenderScene(scene, m_voxelizePass, false, true);
+			GLStateCache::Viewport(0, 0, VoxelUnitSize, VoxelUnitSize);
+			RenderScene(scene, false, true);
 
 			m_shadowMap->UnbindAsTexture(5);
 
-			glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-			glEnable(GL_DEPTH_TEST);
-			glEnable(GL_CULL_FACE);
+			GLStateCache::ColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+			GLStateCache::Enable(GL_DEPTH_TEST);
+			GLStateCache::Enable(GL_CULL_FACE);
 
 			this->GenerateTexture3DMipmap(m_voxelVolume);
 		}
@@ -410,45 +644,35 @@ void Renderer::EncodedVoxelize(const Scene* scene)
 		{
 			if (bEnableConservativeRasterization)
 			{
-				glEnable(GL_CONSERVATIVE_RASTERIZATION_NV);
+				GLStateCache::Enable(GL_CONSERVATIVE_RASTERIZATION_NV);
 				glConservativeRasterParameterfNV(GL_CONSERVATIVE_RASTER_DILATE_NV, 0.2f);
 			}
 			else
 			{
-				glDisable(GL_CONSERVATIVE_RASTERIZATION_NV);
+				GLStateCache::Disable(GL_CONSERVATIVE_RASTERIZATION_NV);
 			}
 
-			glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+			GLStateCache::ColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
 
 			const unsigned int clearValue = 0;
 			m_encodedVoxelVolume->Clear(clearValue);
 
 			m_encodedVoxelizePass->Bind();
 
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
-			glDisable(GL_DEPTH_TEST);
-			glDisable(GL_CULL_FACE);
+			GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
+			GLStateCache::Disable(GL_DEPTH_TEST);
+			GLStateCache::Disable(GL_CULL_FACE);
 
-			// Vertex Shader Uniforms
-			m_encodedVoxelizePass->SetMat4f("shadowViewMat", m_shadowViewMat);
-			m_encodedVoxelizePass->SetMat4f("shadowProjMat", m_shadowProjMat);
-
-			// Geometry Shader Uniforms
-			m_encodedVoxelizePass->SetMat4f("projXAxis", m_projX);
-			m_encodedVoxelizePass->SetMat4f("projYAxis", m_projY);
-			m_encodedVoxelizePass->SetMat4f("projZAxis", m_projZ);
-
-			// Fragment Shader Uniforms
 			m_encodedVoxelizePass->SetInt("shadowMap", 5);
 			m_shadowMap->BindAsTexture(5);
 
 			glBindImageTexture(0, m_encodedVoxelVolume->GetID(), 0, GL_TRUE, 0, GL_READ_WRITE, GL_R32UI);
-			glViewport(0, 0, VoxelUnitSize, VoxelUnitSize);
-			RenderScene(scene, m_encodedVoxelizePass, false, true);
+			GLStateCache::Viewport(0, 0, VoxelUnitSize, VoxelUnitSize);
+			RenderScene(scene, false, true);
 
 			m_shadowMap->UnbindAsTexture(5);
-			glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-			glDisable(GL_CONSERVATIVE_RASTERIZATION_NV);
+			GLStateCache::ColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+			GLStateCache::Disable(GL_CONSERVATIVE_RASTERIZATION_NV);
 
 			this->DecodeR32UI(m_encodedVoxelVolume, m_voxelVolume);
 			m_bVoxelized = true;
@@ -461,13 +685,13 @@ void Renderer::RenderVoxel(const Scene* scene)
 {
 	if (scene != nullptr)
 	{
-		glEnable(GL_CULL_FACE);
-		glEnable(GL_DEPTH_TEST);
+		GLStateCache::Enable(GL_CULL_FACE);
+		GLStateCache::Enable(GL_DEPTH_TEST);
 		glBindRenderbuffer(GL_RENDERBUFFER, 0);
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		glViewport(0, 0, m_winWidth, m_winHeight);
+		GLStateCache::Viewport(0, 0, m_winWidth, m_winHeight);
 
 		m_renderVoxelPass->Bind();
 		m_renderVoxelPass->SetInt("volumeDim", VoxelUnitSize);
@@ -482,9 +706,9 @@ void Renderer::RenderVoxel(const Scene* scene)
 		m_renderVoxelPass->SetMat4f("modelViewMatrix", modelViewMatrix);
 		m_renderVoxelPass->SetMat4f("projectionMatrix", projMatrix);
 
-		glBindVertexArray(m_texture3DVAO);
+		GLStateCache::BindVertexArray(m_texture3DVAO);
 		glDrawArrays(GL_POINTS, 0, VoxelNum);
-		glBindVertexArray(0);
+		GLStateCache::BindVertexArray(0);
 		m_voxelVolume->Unbind(0);
 	}
 }
@@ -498,49 +722,108 @@ void Renderer::VoxelConeTracing(const Scene* scene)
 		const auto lightDirection = -glm::normalize(lights[0]->LightDirection());
 		const float UoL = glm::dot(glm::vec3(0.0f, 1.0f, 0.0f), lightDirection);
 		lightIntensity *= UoL;
-		glEnable(GL_CULL_FACE);
-		glEnable(GL_DEPTH_TEST);
+		GLStateCache::Enable(GL_CULL_FACE);
+		GLStateCache::Enable(GL_DEPTH_TEST);
 		//glEnable(GL_BLEND);
-		glBindRenderbuffer(GL_RENDERBUFFER, 0);
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		BindMainRenderTarget();
 		glClearColor(lightIntensity.x, lightIntensity.y, lightIntensity.z, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		glViewport(0, 0, m_winWidth, m_winHeight);
 
-		m_vctPass->Bind();
+		const unsigned int queryIdx = m_frameIndex % 2;
+		UpdateDepthPrepassStats();
 
-		m_vctPass->SetMat4f("shadowViewMat", m_shadowViewMat);
-		m_vctPass->SetMat4f("shadowProjMat", m_shadowProjMat);
+		uint32_t vctFeatures = 0;
+		vctFeatures |= bEnableDirectDiffuse ? static_cast<uint32_t>(EVCTFeature::VCTDirectDiffuse) : 0u;
+		vctFeatures |= bEnableIndirectDiffuse ? static_cast<uint32_t>(EVCTFeature::VCTIndirectDiffuse) : 0u;
+		vctFeatures |= bEnableDirectSpecular ? static_cast<uint32_t>(EVCTFeature::VCTDirectSpecular) : 0u;
+		vctFeatures |= bEnableIndirectSpecular ? static_cast<uint32_t>(EVCTFeature::VCTIndirectSpecular) : 0u;
+		vctFeatures |= bDebugAmbientOcclusion ? static_cast<uint32_t>(EVCTFeature::VCTDebugAmbientOcclusion) : 0u;
 
-		m_shadowMap->BindAsTexture(5);
-		m_vctPass->SetInt("shadowMap", 5);
+		const bool bOcclusionCulling = IsOcclusionCullingActive();
+		if (bEnableDepthPrepass)
+		{
+			glBeginQuery(GL_SAMPLES_PASSED, m_prepassSampleQueries[queryIdx]);
+			DepthPrepass(scene);
+			glEndQuery(GL_SAMPLES_PASSED);
+
+			if (bOcclusionCulling)
+			{
+				BuildHiZ(scene->GetMainCamera());
+			}
 
+			// Only fragments which survived prepass reach the cone tracing
+			GLStateCache::DepthFunc(GL_EQUAL);
+			GLStateCache::DepthMask(GL_FALSE);
+			vctFeatures |= static_cast<uint32_t>(EVCTFeature::VCTEarlyDepthTest);
+		}
+
+		// Sampler units are fixed by layout(binding) in shader, so every variant shares them
+		m_shadowMap->BindAsTexture(5);
 		m_voxelVolume->Bind(6);
-		m_vctPass->SetInt("voxelVolume", 6);
-		m_vctPass->SetFloat("voxelGridWorldSize", VoxelGridWorldSize);
-		m_vctPass->SetFloat("voxelDim", static_cast<float>(VoxelUnitSize));
-
-		/* VCT params */
-		m_vctPass->SetFloat("maxDist_VCT", VCTMaxDistance);
-		m_vctPass->SetFloat("step_VCT", VCTStep);
-		m_vctPass->SetFloat("alphaThreshold_VCT", VCTAlphaThreshold);
-		m_vctPass->SetFloat("initialStep_VCT", VCTInitialStep);
-		m_vctPass->SetInt("specularSampleNum_VCT", VCTSpecularSampleNum);
-
-		/* Debug flags */
-		m_vctPass->SetInt("enableDirectDiffuse", bEnableDirectDiffuse ? 1 : 0);
-		m_vctPass->SetInt("enableIndirectDiffuse", bEnableIndirectDiffuse ? 1 : 0);
-		m_vctPass->SetInt("enableDirectSpecular", bEnableDirectSpecular ? 1 : 0);
-		m_vctPass->SetInt("enableIndirectSpecular", bEnableIndirectSpecular ? 1 : 0);
-		m_vctPass->SetInt("debugAmbientOcclusion", bDebugAmbientOcclusion ? 1 : 0);
-
-		RenderScene(scene, m_vctPass, false, false, bEnableViewFrustumCulling);
+
+		if (bEnableDepthPrepass)
+		{
+			glBeginQuery(GL_SAMPLES_PASSED, m_vctSampleQueries[queryIdx]);
+		}
+
+		RenderScene(scene, false, false, bEnableViewFrustumCulling ? m_frustum : nullptr, ERenderQueueSortMode::StateFirst, m_vctPermutation, vctFeatures, bOcclusionCulling);
+
+		if (bEnableDepthPrepass)
+		{
+			glEndQuery(GL_SAMPLES_PASSED);
+			m_bSampleQueriesIssued[queryIdx] = true;
+
+			GLStateCache::DepthFunc(GL_LESS);
+			GLStateCache::DepthMask(GL_TRUE);
+		}
 
 		m_voxelVolume->Unbind(6);
 		m_shadowMap->UnbindAsTexture(5);
 	}
 }
 
+void Renderer::DepthPrepass(const Scene* scene)
+{
+	if (scene != nullptr)
+	{
+		GLStateCache::ColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+		GLStateCache::DepthFunc(GL_LESS);
+		GLStateCache::DepthMask(GL_TRUE);
+
+		m_depthPrepass->Bind();
+		RenderScene(scene, false, false, bEnableViewFrustumCulling ? m_frustum : nullptr, ERenderQueueSortMode::FrontToBack);
+
+		GLStateCache::ColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	}
+}
+
+void Renderer::BuildHiZ(const Camera* camera)
+{
+	// Same matrices as the prepass, including jitter, so boxes project exactly onto the depth they are tested against
+	m_hiZViewProj = camera->GetProjMatrix() * camera->GetViewMatrix();
+	m_hiZBuffer->Build(m_sceneTarget->GetDepthTexture());
+}
+
+void Renderer::UpdateDepthPrepassStats()
+{
+	// Samples passed in prepass(depth less) estimate what VCT pass would shade without prepass.
+	// Prepass is sorted front to back while VCT pass is sorted by state, so VCT alone would overdraw more; saved count is a lower bound.
+	const unsigned int queryIdx = (m_frameIndex + 1) % 2;
+	if (m_bSampleQueriesIssued[queryIdx])
+	{
+		GLint bAvailable = GL_FALSE;
+		glGetQueryObjectiv(m_vctSampleQueries[queryIdx], GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+		if (bAvailable == GL_TRUE)
+		{
+			GLuint64 prepassSamples = 0;
+			glGetQueryObjectui64v(m_prepassSampleQueries[queryIdx], GL_QUERY_RESULT, &prepassSamples);
+			glGetQueryObjectui64v(m_vctSampleQueries[queryIdx], GL_QUERY_RESULT, &m_vctShadedFragments);
+			m_depthPrepassSavedFragments = (prepassSamples > m_vctShadedFragments) ? (prepassSamples - m_vctShadedFragments) : 0;
+			m_bSampleQueriesIssued[queryIdx] = false;
+		}
+	}
+}
+
 void Renderer::GenerateTexture3DMipmap(Texture3D* target)
 {
 	if (target != nullptr)
@@ -612,14 +895,14 @@ void Renderer::DebugConeDirections(const Scene* scene)
 {
 	if (scene != nullptr)
 	{
-		glEnable(GL_CULL_FACE);
-		glEnable(GL_DEPTH_TEST);
+		GLStateCache::Enable(GL_CULL_FACE);
+		GLStateCache::Enable(GL_DEPTH_TEST);
 		glBindRenderbuffer(GL_RENDERBUFFER, 0);
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 
 		m_visualizeConeDirPass->Bind();
 		m_visualizeConeDirPass->SetFloat("directionLength", DebugConeLength);
-		RenderScene(scene, m_visualizeConeDirPass);
+		RenderScene(scene);
 	}
 }
 
@@ -627,10 +910,10 @@ void Renderer::DebugBoundingBoxes(const Scene* scene)
 {
 	if (scene != nullptr)
 	{
-		glDisable(GL_CULL_FACE);
-		glEnable(GL_DEPTH_TEST);
+		GLStateCache::Disable(GL_CULL_FACE);
+		GLStateCache::Enable(GL_DEPTH_TEST);
 		glBindRenderbuffer(GL_RENDERBUFFER, 0);
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
 
 		m_visualizeBoundingBoxPass->Bind();
 		m_visualizeBoundingBoxPass->SetVec3f("boundingBoxColor", BoundingBoxDebugColor);
@@ -645,9 +928,9 @@ void Renderer::DebugBoundingBoxes(const Scene* scene)
 			m_visualizeBoundingBoxPass->SetVec3f("boundingBoxMin", modelBoundingBox.Min);
 			m_visualizeBoundingBoxPass->SetVec3f("boundingBoxMax", modelBoundingBox.Max);
 
-			glBindVertexArray(m_boundingBoxPointVAO);
+			GLStateCache::BindVertexArray(m_boundingBoxPointVAO);
 			glDrawArrays(GL_POINTS, 0, 1);
-			glBindVertexArray(0);
+			GLStateCache::BindVertexArray(0);
 
 			for (auto mesh : model->GetMeshes())
 			{
@@ -655,9 +938,9 @@ void Renderer::DebugBoundingBoxes(const Scene* scene)
 				m_visualizeBoundingBoxPass->SetVec3f("boundingBoxMin", meshBoundingBox.Min);
 				m_visualizeBoundingBoxPass->SetVec3f("boundingBoxMax", meshBoundingBox.Max);
 
-				glBindVertexArray(m_boundingBoxPointVAO);
+				GLStateCache::BindVertexArray(m_boundingBoxPointVAO);
 				glDrawArrays(GL_POINTS, 0, 1);
-				glBindVertexArray(0);
+				GLStateCache::BindVertexArray(0);
 			}
 		}
 	}
@@ -669,3 +952,136 @@ void Renderer::Clear(const glm::vec4& color, bool clearDepth)
 	glClearColor(color.r, color.g, color.b, color.a);
 	glClear(clearBit);
 }
+
+
+void Renderer::BeginDynamicResolution(Camera* camera)
+{
+	m_bUpscaleThisFrame = bEnableDynamicResolution && (m_renderMode != ERenderMode::VoxelVisualization);
+	if (!m_bUpscaleThisFrame)
+	{
+		m_renderWidth = m_winWidth;
+		m_renderHeight = m_winHeight;
+		m_bResetHistory = true;
+		camera->SetJitter(glm::vec2(0.0f));
+		return;
+	}
+
+	UpdateRenderScale();
+	m_renderWidth = std::max(1u, static_cast<unsigned int>(std::round(m_winWidth * m_renderScale)));
+	m_renderHeight = std::max(1u, static_cast<unsigned int>(std::round(m_winHeight * m_renderScale)));
+
+	// Halton(2, 3) sub-pixel jitter, in NDC of scaled render area
+	const unsigned int sampleIdx = (m_frameIndex % TemporalJitterSampleNum) + 1;
+	m_jitter = glm::vec2(Halton(sampleIdx, 2) - 0.5f, Halton(sampleIdx, 3) - 0.5f) *
+		glm::vec2(2.0f / static_cast<float>(m_renderWidth), 2.0f / static_cast<float>(m_renderHeight));
+	camera->SetJitter(m_jitter);
+
+	if (camera != m_prevCamera)
+	{
+		m_bResetHistory = true;
+	}
+}
+
+void Renderer::UpdateRenderScale()
+{
+	// Read back timer of previous frame; Never wait on GPU for it
+	const unsigned int queryIdx = (m_frameIndex + 1) % 2;
+	if (m_bGPUTimerIssued[queryIdx])
+	{
+		GLint bAvailable = GL_FALSE;
+		glGetQueryObjectiv(m_gpuTimerQueries[queryIdx], GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+		if (bAvailable == GL_TRUE)
+		{
+			GLuint64 elapsed = 0;
+			glGetQueryObjectui64v(m_gpuTimerQueries[queryIdx], GL_QUERY_RESULT, &elapsed);
+			m_bGPUTimerIssued[queryIdx] = false;
+
+			const float gpuTime = static_cast<float>(elapsed) * 1.0e-6f;
+			if (gpuTime > 0.0f)
+			{
+				// Main pass cost is linear in shaded pixels, so each axis scales with square root of the ratio.
+				const float desiredScale = m_renderScale * std::sqrt(TargetGPUTime / gpuTime);
+				m_renderScale = glm::clamp(glm::mix(m_renderScale, desiredScale, 0.1f), MinRenderScale, MaxRenderScale);
+			}
+		}
+	}
+}
+
+void Renderer::BindMainRenderTarget()
+{
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+	if (m_bUpscaleThisFrame)
+	{
+		m_sceneTarget->Bind();
+	}
+	else
+	{
+		GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	GLStateCache::Viewport(0, 0, m_renderWidth, m_renderHeight);
+}
+
+void Renderer::TemporalUpscale(const Scene* scene)
+{
+	if (scene != nullptr)
+	{
+		Camera* camera = scene->GetMainCamera();
+		const glm::mat4 viewProj = camera->GetUnjitteredProjMatrix() * camera->GetViewMatrix();
+
+		FBO* history = m_historyTargets[(m_frameIndex + 1) % 2];
+		FBO* output = m_historyTargets[m_frameIndex % 2];
+
+		GLStateCache::Disable(GL_DEPTH_TEST);
+		output->Bind();
+		GLStateCache::Viewport(0, 0, m_winWidth, m_winHeight);
+
+		m_temporalUpscalePass->Bind();
+		m_sceneTarget->BindAsTexture(0);
+		m_temporalUpscalePass->SetInt("currentColor", 0);
+		m_sceneTarget->BindDepthAsTexture(1);
+		m_temporalUpscalePass->SetInt("currentDepth", 1);
+		history->BindAsTexture(2);
+		m_temporalUpscalePass->SetInt("historyColor", 2);
+
+		m_temporalUpscalePass->SetVec2f("renderScale", glm::vec2(
+			static_cast<float>(m_renderWidth) / static_cast<float>(m_winWidth),
+			static_cast<float>(m_renderHeight) / static_cast<float>(m_winHeight)));
+		m_temporalUpscalePass->SetVec2f("jitter", m_jitter);
+		m_temporalUpscalePass->SetMat4f("invViewProj", glm::inverse(viewProj));
+		m_temporalUpscalePass->SetMat4f("prevViewProj", m_prevViewProj);
+		m_temporalUpscalePass->SetFloat("historyWeight", TemporalHistoryWeight);
+		m_temporalUpscalePass->SetInt("bResetHistory", m_bResetHistory ? 1 : 0);
+
+		GLStateCache::BindVertexArray(m_quadVAO);
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		GLStateCache::BindVertexArray(0);
+
+		history->UnbindAsTexture(2);
+		m_sceneTarget->UnbindAsTexture(1);
+		m_sceneTarget->UnbindAsTexture(0);
+
+		// Present resolved color, and upscaled depth to keep debug passes depth tested
+		GLStateCache::BindFramebuffer(GL_READ_FRAMEBUFFER, output->GetID());
+		GLStateCache::BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+		glBlitFramebuffer(
+			0, 0, m_winWidth, m_winHeight,
+			0, 0, m_winWidth, m_winHeight,
+			GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+		GLStateCache::BindFramebuffer(GL_READ_FRAMEBUFFER, m_sceneTarget->GetID());
+		glBlitFramebuffer(
+			0, 0, m_renderWidth, m_renderHeight,
+			0, 0, m_winWidth, m_winHeight,
+			GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+		GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
+		GLStateCache::Viewport(0, 0, m_winWidth, m_winHeight);
+		GLStateCache::Enable(GL_DEPTH_TEST);
+
+		camera->SetJitter(glm::vec2(0.0f));
+		m_prevViewProj = viewProj;
+		m_prevCamera = camera;
+		m_bResetHistory = false;
+	}
+}
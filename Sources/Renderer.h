@@ -1,6 +1,8 @@
 #pragma once
 #include "Rendering.h"
 #include "glm/glm.hpp"
+#include "RenderQueue.h"
+#include "ShaderConstants.h"
 
 // Voxel Volume Texture Size
 constexpr unsigned int VoxelUnitSize = 512;
@@ -8,6 +10,18 @@ constexpr float VoxelGridWorldSize = 512;
 constexpr unsigned int VoxelNum = VoxelUnitSize * VoxelUnitSize * VoxelUnitSize;
 constexpr float VoxelSize = (VoxelGridWorldSize / static_cast<float>(VoxelUnitSize));
 constexpr unsigned int ShadowMapRes = 8192;
+constexpr unsigned int TemporalJitterSampleNum = 8;
+
+/* Feature bits of VCT pass permutation; placed above EMaterialFlag bits(MaterialFeatureCount) */
+enum EVCTFeature : uint32_t
+{
+	VCTDirectDiffuse = 1 << 5,
+	VCTIndirectDiffuse = 1 << 6,
+	VCTDirectSpecular = 1 << 7,
+	VCTIndirectSpecular = 1 << 8,
+	VCTDebugAmbientOcclusion = 1 << 9,
+	VCTEarlyDepthTest = 1 << 10
+};
 
 enum class ERenderMode
 {
@@ -29,6 +43,9 @@ class Texture3D;
 class FBO;
 class ShadowMap;
 class Frustum;
+class UniformRingBuffer;
+class ShaderPermutation;
+class HiZBuffer;
 class Renderer
 {
 public:
@@ -43,18 +60,41 @@ public:
 	void SetRenderMode(ERenderMode mode) { m_renderMode = mode; }
 	ERenderMode GetRenderMode() const { return m_renderMode; }
 
-	void PrintVCTParams() const;
+	/* Also prints hierarchy stats of scene if it is given */
+	void PrintVCTParams(const Scene* scene = nullptr) const;
+
+	/* bEnableOcclusionCulling and every pass/target it depends on */
+	bool IsOcclusionCullingActive() const;
+
+	float GetRenderScale() const { return m_renderScale; }
+
+	/* Estimated(lower bound) fragments which depth prepass prevented from VCT shading(latest available frame) */
+	GLuint64 GetDepthPrepassSavedFragments() const { return m_depthPrepassSavedFragments; }
+	GLuint64 GetVCTShadedFragments() const { return m_vctShadedFragments; }
 
 private:
-	void RenderScene(const Scene* scene, Shader* shader, bool bIsShadowCasting = false, bool bForceCullFace = false, bool bEnableFrustumCulling = false);
+	/*
+	* cullFrustum : Meshes outside are culled; through scene BVH on CPU or by compute shader. Nothing is culled if null.
+	* bEnableOcclusionCulling : Test against depth pyramid built by BuildHiZ of this frame; GPU culling only
+	**/
+	void RenderScene(const Scene* scene, bool bIsShadowCasting = false, bool bForceCullFace = false, const Frustum* cullFrustum = nullptr, ERenderQueueSortMode sortMode = ERenderQueueSortMode::StateFirst, ShaderPermutation* permutation = nullptr, uint32_t passFeatures = 0, bool bEnableOcclusionCulling = false);
 	void DeferredRender(const Scene* scene);
 
+	/* Per frame constants; written once and bound to every program through UBOs */
+	void UpdateFrameConstants(const Camera* camera);
+	void UpdateLightConstants(const Scene* scene);
+	void UpdateVoxelConstants();
+
 	void Shadow(const Scene* scene);
 
 	void Voxelize(const Scene* scene);
 	void EncodedVoxelize(const Scene* scene);
 	void RenderVoxel(const Scene* scene);
 	void VoxelConeTracing(const Scene* scene);
+	void DepthPrepass(const Scene* scene);
+	/* Builds depth pyramid from depth of main render target */
+	void BuildHiZ(const Camera* camera);
+	void UpdateDepthPrepassStats();
 
 	// ̹   mipmap generation Ǿٰ 
 	void GenerateTexture3DMipmap(Texture3D* target);
@@ -63,8 +103,26 @@ private:
 	void DebugConeDirections(const Scene* scene);
 	void DebugBoundingBoxes(const Scene* scene);
 
+	void BeginDynamicResolution(Camera* camera);
+	void UpdateRenderScale();
+	void BindMainRenderTarget();
+	void TemporalUpscale(const Scene* scene);
+
 public:
 	bool bEnableViewFrustumCulling = true;
+	/* Frustum culling by compute shader; falls back to CPU if indirect count draw is not supported */
+	bool bEnableGPUFrustumCulling = true;
+	/*
+	* Hi-Z occlusion culling of VCT pass against depth prepass of same frame; off by default.
+	* Saves vertex work of occluded meshes only : VCT pass already rejects hidden fragments by GL_EQUAL early depth test,
+	* while prepass and shadow pass are not culled. Costs pyramid build and cull dispatch every frame.
+	* Only takes effect while IsOcclusionCullingActive(); pyramid needs sampleable depth of dynamic resolution target.
+	**/
+	bool bEnableOcclusionCulling = false;
+	/* CPU frustum culling; flat SIMD test over every mesh bounds instead of BVH traversal */
+	bool bEnableSIMDCulling = true;
+	/* Draws meshes which share geometry as instances of one indirect command */
+	bool bEnableInstancing = true;
 	bool bEnableDirectDiffuse = true;
 	bool bEnableIndirectDiffuse = true;
 	bool bEnableDirectSpecular = true;
@@ -74,6 +132,7 @@ public:
 	bool bAlwaysVoxelize = false;
 	bool bEnableConservativeRasterization = false;
 	bool bDebugBoundingBox = false;
+	bool bEnableDepthPrepass = true;
 	glm::vec3 BoundingBoxDebugColor = glm::vec3(0.0f, 1.0f, 0.0f);
 
 	float VCTMaxDistance = 150.0f;
@@ -84,9 +143,22 @@ public:
 
 	float DebugConeLength = 1.5f;
 
+	/* Dynamic Resolution */
+	bool bEnableDynamicResolution = true;
+	float TargetGPUTime = 14.0f; // ms, main pass only
+	float MinRenderScale = 0.5f;
+	float MaxRenderScale = 1.0f;
+	float TemporalHistoryWeight = 0.9f;
+
 private:
 	ERenderMode m_renderMode = ERenderMode::VCT;
 	Frustum* m_frustum = nullptr;
+	RenderQueue m_renderQueue;
+	std::vector<uint32_t> m_bvhQueryResult;
+	Shader* m_frustumCullPass = nullptr;
+	HiZBuffer* m_hiZBuffer = nullptr;
+	glm::mat4 m_hiZViewProj = glm::mat4(1.0f);
+	UniformRingBuffer* m_uniformRing = nullptr;
 
 	// Deferred Rendering
 	GBuffer*	m_gBuffer = nullptr;
@@ -97,6 +169,8 @@ private:
 	bool m_bFirstShadow = true;
 	ShadowMap* m_shadowMap = nullptr;
 	Shader* m_shadowPass = nullptr;
+	/* Volume of shadow projection; casters outside of it are culled */
+	Frustum* m_shadowFrustum = nullptr;
 	glm::mat4 m_shadowViewMat = glm::mat4();
 	glm::mat4 m_shadowProjMat = glm::mat4();
 
@@ -113,7 +187,15 @@ private:
 	GLuint m_texture3DVAO = 0;
 	GLuint m_boundingBoxPointVAO = 0;
 
-	Shader* m_vctPass = nullptr;
+	ShaderPermutation* m_vctPermutation = nullptr;
+
+	// Depth Prepass
+	Shader* m_depthPrepass = nullptr;
+	GLuint m_prepassSampleQueries[2] = { 0, 0 };
+	GLuint m_vctSampleQueries[2] = { 0, 0 };
+	bool m_bSampleQueriesIssued[2] = { false, false };
+	GLuint64 m_depthPrepassSavedFragments = 0;
+	GLuint64 m_vctShadedFragments = 0;
 
 	unsigned int m_quadVAO = 0;
 	unsigned int m_quadVBO = 0;
@@ -121,6 +203,22 @@ private:
 	unsigned int m_winWidth = 0;
 	unsigned int m_winHeight = 1;
 
+	// Dynamic Resolution & Temporal Upscaling
+	FBO* m_sceneTarget = nullptr;
+	FBO* m_historyTargets[2] = { nullptr, nullptr };
+	Shader* m_temporalUpscalePass = nullptr;
+	GLuint m_gpuTimerQueries[2] = { 0, 0 };
+	bool m_bGPUTimerIssued[2] = { false, false };
+	unsigned int m_frameIndex = 0;
+	bool m_bUpscaleThisFrame = false;
+	bool m_bResetHistory = true;
+	float m_renderScale = 1.0f;
+	unsigned int m_renderWidth = 0;
+	unsigned int m_renderHeight = 0;
+	glm::vec2 m_jitter = glm::vec2(0.0f);
+	glm::mat4 m_prevViewProj = glm::mat4(1.0f);
+	const Camera* m_prevCamera = nullptr;
+
 	bool m_bVoxelized = false;
 	bool m_bNeedVoxelize = true;
 
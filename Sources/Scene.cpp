@@ -3,6 +3,9 @@
 #include "Light.h"
 #include "Model.h"
 #include "Plane.h"
+#include "Mesh.h"
+#include "JobSystem.h"
+#include "MeshCache.h"
 
 #include <iostream>
 
@@ -12,8 +15,20 @@ Scene::Scene() :
 	this->CreateCamera("MainCamera");
 }
 
+bool ModelLoadHandle::IsDone() const
+{
+	return Counter == nullptr || Counter->IsDone();
+}
+
 Scene::~Scene()
 {
+	// Jobs in flight still refer to models of this scene
+	for (const auto& counter : m_pendingLoads)
+	{
+		m_jobSystem->Wait(*counter);
+	}
+	m_pendingLoads.clear();
+
 	for (auto* camera : m_cameras)
 	{
 		if (camera != nullptr)
@@ -62,14 +77,117 @@ Camera* Scene::CreateCamera(const std::string& name)
 Model* Scene::LoadModel(const std::string& name, const std::string& filePath, const ModelLoadParams& params)
 {
 	m_bIsDirty = true;
+	m_bBVHOutdated = true;
 	Model* newModel = new Model(name, filePath, params);
 	m_models.push_back(newModel);
+
+	// Same file is being imported by LoadModelAsync; meshes arrive when it is done
+	if (ModelAsset* asset = newModel->GetAsset(); !asset->IsReady())
+	{
+		asset->OnReady(newModel, [this](bool)
+		{
+			m_bIsDirty = true;
+			m_bBVHOutdated = true;
+		});
+	}
+
 	return newModel;
 }
 
+ModelLoadHandle Scene::LoadModelAsync(const std::string& name, const std::string& filePath, const ModelLoadParams& params, std::function<void(Model*)> onLoaded)
+{
+	ModelLoadHandle handle;
+	handle.Counter = std::make_shared<JobCounter>();
+	if (m_jobSystem == nullptr)
+	{
+		handle.Target = LoadModel(name, filePath, params);
+		if (onLoaded)
+		{
+			onLoaded(handle.Target);
+		}
+
+		return handle;
+	}
+
+	m_bIsDirty = true;
+	m_bBVHOutdated = true;
+	Model* newModel = new Model(name, filePath);
+	m_models.push_back(newModel);
+	handle.Target = newModel;
+
+	bool bCreated = false;
+	ModelAsset* asset = MeshCache::Acquire(filePath, params, bCreated);
+	newModel->SetAsset(asset);
+	handle.Counter = asset->GetLoadCounter();
+	m_pendingLoads.push_back(handle.Counter);
+
+	if (!bCreated)
+	{
+		// Same file is already imported, or being imported by another load; share its geometry once ready
+		asset->OnReady(newModel, [this, newModel, onLoaded = std::move(onLoaded)](bool bSucceeded)
+		{
+			newModel->Instantiate();
+			m_bIsDirty = true;
+			m_bBVHOutdated = true;
+			if (bSucceeded && onLoaded)
+			{
+				onLoaded(newModel);
+			}
+		});
+
+		return handle;
+	}
+
+	JobSystem* jobSystem = m_jobSystem;
+	JobCounter* counter = handle.Counter.get();
+	m_jobSystem->Run([this, jobSystem, counter, newModel, asset, filePath, params, onLoaded = std::move(onLoaded)]()
+	{
+		auto meshes = std::make_shared<std::vector<MeshImportData>>();
+		const bool bImported = Model::Import(filePath, params, *meshes);
+
+		// Main thread jobs run in queued order, so SetReady and onLoaded come after every mesh
+		for (size_t idx = 0; idx < meshes->size(); ++idx)
+		{
+			jobSystem->RunOnMainThread([this, newModel, asset, meshes, idx]()
+			{
+				asset->AddMesh(std::move((*meshes)[idx]));
+				newModel->AddMesh(idx);
+				m_bIsDirty = true;
+			}, counter);
+		}
+
+		// Hierarchy is rebuilt once per model instead of once per streamed mesh
+		jobSystem->RunOnMainThread([this, newModel, asset, bImported, onLoaded]()
+		{
+			asset->SetReady(bImported);
+			m_bBVHOutdated = true;
+			if (bImported && onLoaded)
+			{
+				onLoaded(newModel);
+			}
+		}, counter);
+	}, counter);
+
+	return handle;
+}
+
+bool Scene::IsLoading() const
+{
+	for (const auto& counter : m_pendingLoads)
+	{
+		if (!counter->IsDone())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 Model* Scene::CreatePlane(const std::string& name)
 {
 	m_bIsDirty = true;
+	m_bBVHOutdated = true;
 	Model* newModel = new Plane(name);
 	m_models.push_back(newModel);
 	return newModel;
@@ -134,3 +252,45 @@ void Scene::ResolveDirty(bool bIncludeCam)
 
 	m_bIsDirty = false;
 }
+
+void Scene::UpdateBVH()
+{
+	if (m_bBVHOutdated)
+	{
+		// Full SAH build is too expensive to repeat every frame while models stream in; renderer skips stale hierarchy meanwhile
+		if (IsLoading())
+		{
+			return;
+		}
+
+		std::vector<BVHPrimitive> primitives;
+		m_modelPrimitiveBegins.clear();
+		for (auto model : m_models)
+		{
+			m_modelPrimitiveBegins.push_back(static_cast<uint32_t>(primitives.size()));
+			const auto worldMatrix = model->GetWorldMatrix();
+			for (auto mesh : model->GetMeshes())
+			{
+				primitives.push_back(BVHPrimitive{ model, mesh, mesh->GetBoundingBox().Transformed(worldMatrix) });
+			}
+		}
+
+		m_bvh.Build(primitives);
+		m_bBVHOutdated = false;
+		return;
+	}
+
+	for (size_t modelIdx = 0; modelIdx < m_models.size(); ++modelIdx)
+	{
+		Model* model = m_models[modelIdx];
+		if (model->IsDirty())
+		{
+			const auto worldMatrix = model->GetWorldMatrix();
+			const auto& meshes = model->GetMeshes();
+			for (uint32_t meshIdx = 0; meshIdx < meshes.size(); ++meshIdx)
+			{
+				m_bvh.Refit(m_modelPrimitiveBegins[modelIdx] + meshIdx, meshes[meshIdx]->GetBoundingBox().Transformed(worldMatrix));
+			}
+		}
+	}
+}
@@ -1,16 +1,31 @@
 #pragma once
+#include <functional>
+#include <memory>
 #include <vector>
 #include <string>
 
 #include "glm/vec3.hpp"
+#include "BVH.h"
 
 class Camera;
 class Light;
 class Controller;
 class Material;
 class Model;
+class JobSystem;
+class JobCounter;
 struct ModelLoadParams;
 struct GLFWwindow;
+
+/* Target of LoadModelAsync is usable right away; its meshes appear as they are uploaded */
+struct ModelLoadHandle
+{
+	Model* Target = nullptr;
+	std::shared_ptr<JobCounter> Counter;
+
+	bool IsDone() const;
+};
+
 class Scene
 {
 public:
@@ -28,6 +43,15 @@ public:
 	Light* CreateLight(const std::string& name);
 	Camera* CreateCamera(const std::string& name);
 	Model* LoadModel(const std::string& name, const std::string& filePath, const ModelLoadParams& params);
+	/*
+	* Import runs on a worker thread, then each mesh is uploaded by its own main thread job, so scene renders while model streams in.
+	* onLoaded runs on main thread after the last mesh; it is not called if import failed.
+	* Loads synchronously if scene has no job system.
+	**/
+	ModelLoadHandle LoadModelAsync(const std::string& name, const std::string& filePath, const ModelLoadParams& params, std::function<void(Model*)> onLoaded = nullptr);
+	bool IsLoading() const;
+
+	void SetJobSystem(JobSystem* jobSystem) { m_jobSystem = jobSystem; }
 
 	Model* CreatePlane(const std::string& name);
 
@@ -38,6 +62,12 @@ public:
 	bool IsSceneDirty(bool bIncludeCam = false) const;
 	void ResolveDirty(bool bIncludeCam = false);
 
+	/* Rebuilds hierarchy if models were added(deferred until IsLoading is false), otherwise refits meshes of dirty models; call before ResolveDirty */
+	void UpdateBVH();
+	const BVH& GetBVH() const { return m_bvh; }
+	/* Hierarchy does not cover every mesh of scene yet */
+	bool IsBVHOutdated() const { return m_bBVHOutdated; }
+
 	virtual void Construct() { }
 	virtual void Update(float dt) { }
 	virtual void KeyCallback(GLFWwindow* window, int key, int scanCode, int action, int mods) {}
@@ -49,4 +79,12 @@ private:
 	std::vector<Model*>		m_models;
 	bool							m_bIsDirty = true;
 
+	BVH							m_bvh;
+	/* Index of first BVH primitive of each model; meshes of a model are consecutive */
+	std::vector<uint32_t>	m_modelPrimitiveBegins;
+	bool							m_bBVHOutdated = true;
+
+	JobSystem*					m_jobSystem = nullptr;
+	std::vector<std::shared_ptr<JobCounter>> m_pendingLoads;
+
 };
\ No newline at end of file
@@ -1,302 +1,636 @@
 #include "Shader.h"
 #include "Rendering.h"
+#include "GLStateCache.h"
 
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
-constexpr unsigned int INVALID_LOC = 0xFFFFFFFF;
+constexpr GLint INVALID_LOC = -1;
+constexpr unsigned int MaxIncludeDepth = 16;
+
+/* Linked program binaries; keyed by hash of driver strings and every preprocessed stage source */
+constexpr char ProgramBinaryCacheDirectory[] = "ShaderCache/";
+constexpr uint32_t ProgramBinaryMagic = 0x31424750; // 'PGB1'
+constexpr uint64_t FNVOffsetBasis = 0xcbf29ce484222325ull;
+
+std::vector<Shader*> Shader::s_pending;
+
+struct ProgramBinaryHeader
+{
+	uint32_t Magic = ProgramBinaryMagic;
+	uint32_t Format = 0;
+	uint64_t Key = 0;
+	uint64_t Length = 0;
+};
 
 Shader::Shader(const std::string& csPath)
 {
-	std::string csRaw;
-	std::ifstream csFile;
+	Submit({ Stage{ GL_COMPUTE_SHADER, csPath, LoadSource(csPath, std::vector<std::string>()) } });
+}
+
+Shader::Shader(
+	const std::string& vsPath,
+	const std::string& fsPath) :
+	Shader(vsPath, fsPath, std::vector<std::string>())
+{
+}
+
+Shader::Shader(
+	const std::string& vsPath,
+	const std::string& fsPath,
+	const std::vector<std::string>& defines)
+{
+	Submit({
+		Stage{ GL_VERTEX_SHADER, vsPath, LoadSource(vsPath, defines) },
+		Stage{ GL_FRAGMENT_SHADER, fsPath, LoadSource(fsPath, defines) } });
+}
+
+Shader::Shader(const std::string& vsPath, const std::string& gsPath, const std::string& fsPath) :
+	Shader(vsPath, gsPath, fsPath, std::vector<std::string>())
+{
+}
 
-	csFile.exceptions(std::ifstream::badbit | std::ifstream::failbit);
+Shader::Shader(
+	const std::string& vsPath,
+	const std::string& gsPath,
+	const std::string& fsPath,
+	const std::vector<std::string>& defines)
+{
+	Submit({
+		Stage{ GL_VERTEX_SHADER, vsPath, LoadSource(vsPath, defines) },
+		Stage{ GL_GEOMETRY_SHADER, gsPath, LoadSource(gsPath, defines) },
+		Stage{ GL_FRAGMENT_SHADER, fsPath, LoadSource(fsPath, defines) } });
+}
+
+std::string Shader::LoadSource(const std::string& path, const std::vector<std::string>& defines)
+{
+	std::ifstream file;
+	file.exceptions(std::ifstream::badbit | std::ifstream::failbit);
 	try
 	{
-		csFile.open(csPath);
-		std::stringstream vsStream;
-		vsStream << csFile.rdbuf();
-		csFile.close();
+		file.open(path);
+		std::stringstream stream;
+		stream << file.rdbuf();
+		file.close();
 
-		csRaw = vsStream.str();
+		return InjectDefines(ResolveIncludes(stream.str(), path), defines);
 	}
 	catch (std::ifstream::failure e)
 	{
-		std::cout << "Failed to open shader files " << e.what() << std::endl;
+		std::cout << "Failed to open shader files " << path << " : " << e.what() << std::endl;
 	}
 
-	const char* vsCode = csRaw.c_str();
-	unsigned int cs;
-	int success = 0;
-	char compileLog[512];
+	return std::string();
+}
 
-	cs = glCreateShader(GL_COMPUTE_SHADER);
-	glShaderSource(cs, 1, &vsCode, nullptr);
-	glCompileShader(cs);
-	glGetShaderiv(cs, GL_COMPILE_STATUS, &success);
-	if (success == 0)
+Shader::~Shader()
+{
+	if (m_pending != nullptr)
 	{
-		glGetShaderInfoLog(cs, 512, nullptr, compileLog);
-		std::cout << "Failed to compile compute shader: " << compileLog << std::endl;
+		s_pending.erase(std::remove(s_pending.begin(), s_pending.end(), this), s_pending.end());
+		for (const unsigned int shader : m_pending->Shaders)
+		{
+			glDeleteShader(shader);
+		}
+
+		delete m_pending;
+		m_pending = nullptr;
 	}
 
+	glDeleteProgram(m_id);
+	GLStateCache::OnProgramDeleted(m_id);
+}
+
+void Shader::Submit(const std::vector<Stage>& stages)
+{
+	// Kick driver compiler threads up before the first program goes out
+	IsParallelCompileSupported();
+
+	m_pending = new PendingBuild();
+	m_pending->BinaryKey = ComputeBinaryKey(stages);
+	m_pending->Stages = stages;
+	s_pending.push_back(this);
+
 	m_id = glCreateProgram();
-	glAttachShader(m_id, cs);
-	glLinkProgram(m_id);
-	glGetProgramiv(m_id, GL_LINK_STATUS, &success);
-	if (success == 0)
+	if (SubmitProgramBinary(m_pending->BinaryKey))
 	{
-		glGetProgramInfoLog(m_id, 512, nullptr, compileLog);
-		std::cout << "Failed to link shader program: " << compileLog << std::endl;
+		m_pending->bFromBinary = true;
+		return;
 	}
 
-	glDeleteShader(cs);
+	SubmitCompile(*m_pending);
 }
 
-/* @TODO	̴ ε ߺǴ ڵ Լ  */
-Shader::Shader(
-	const std::string& vsPath,
-	const std::string& fsPath)
+void Shader::SubmitCompile(PendingBuild& pending)
 {
-	std::string vsRaw;
-	std::string fsRaw;
+	for (const auto& stage : pending.Stages)
+	{
+		const char* code = stage.Source.c_str();
+		const unsigned int shader = glCreateShader(stage.Type);
+		glShaderSource(shader, 1, &code, nullptr);
+		glCompileShader(shader);
+		glAttachShader(m_id, shader);
+		pending.Shaders.push_back(shader);
+	}
 
-	std::ifstream vsFile;
-	std::ifstream fsFile;
+	// Querying compile status here would wait for the compiler; results are collected in Finish
+	glProgramParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glLinkProgram(m_id);
+}
 
-	vsFile.exceptions(std::ifstream::badbit | std::ifstream::failbit);
-	fsFile.exceptions(std::ifstream::badbit | std::ifstream::failbit);
-	try
+bool Shader::IsReady() const
+{
+	if (m_pending == nullptr)
 	{
-		vsFile.open(vsPath);
-		fsFile.open(fsPath);
-
-		std::stringstream vsStream;
-		std::stringstream fsStream;
+		return true;
+	}
 
-		vsStream << vsFile.rdbuf();
-		fsStream << fsFile.rdbuf();
+	if (!IsParallelCompileSupported())
+	{
+		return false;
+	}
 
-		vsFile.close();
-		fsFile.close();
+	GLint bCompleted = GL_FALSE;
+	glGetProgramiv(m_id, GL_COMPLETION_STATUS_KHR, &bCompleted);
+	return bCompleted == GL_TRUE;
+}
 
-		vsRaw = vsStream.str();
-		fsRaw = fsStream.str();
-	}
-	catch (std::ifstream::failure e)
+void Shader::Finish()
+{
+	if (m_pending == nullptr)
 	{
-		std::cout << "Failed to open shader files " << e.what() << std::endl;
+		return;
 	}
 
-	const char* vsCode = vsRaw.c_str();
-	const char* fsCode = fsRaw.c_str();
+	PendingBuild* pending = m_pending;
+	m_pending = nullptr;
+	s_pending.erase(std::remove(s_pending.begin(), s_pending.end(), this), s_pending.end());
 
-	unsigned int vs;
-	unsigned int fs;
 	int success = 0;
 	char compileLog[512];
 
-	vs = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vs, 1, &vsCode, nullptr);
-	glCompileShader(vs);
-	glGetShaderiv(vs, GL_COMPILE_STATUS, &success);
-	if (success == 0)
+	if (pending->bFromBinary)
 	{
-		glGetShaderInfoLog(vs, 512, nullptr, compileLog);
-		std::cout << "Failed to compile vertex shader: " << compileLog << std::endl;
+		glGetProgramiv(m_id, GL_LINK_STATUS, &success);
+		if (success == 0)
+		{
+			// Driver rejected binary(ex. updated without version string change); start over from source
+			glDeleteProgram(m_id);
+			GLStateCache::OnProgramDeleted(m_id);
+			m_id = glCreateProgram();
+			pending->bFromBinary = false;
+			SubmitCompile(*pending);
+		}
 	}
 
-	fs = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fs, 1, &fsCode, nullptr);
-	glCompileShader(fs);
-	glGetShaderiv(fs, GL_COMPILE_STATUS, &success);
-	if (success == 0)
+	if (!pending->bFromBinary)
 	{
-		glGetShaderInfoLog(fs, 512, nullptr, compileLog);
-		std::cout << "Failed to compile fragment shader: " << vsPath << " => " << compileLog << std::endl;
+		for (size_t idx = 0; idx < pending->Shaders.size(); ++idx)
+		{
+			glGetShaderiv(pending->Shaders[idx], GL_COMPILE_STATUS, &success);
+			if (success == 0)
+			{
+				glGetShaderInfoLog(pending->Shaders[idx], 512, nullptr, compileLog);
+				std::cout << "Failed to compile shader: " << pending->Stages[idx].Path << " => " << compileLog << std::endl;
+			}
+		}
+
+		glGetProgramiv(m_id, GL_LINK_STATUS, &success);
+		if (success == 0)
+		{
+			glGetProgramInfoLog(m_id, 512, nullptr, compileLog);
+			std::cout << "Failed to link shader program: " << compileLog << std::endl;
+		}
+		else
+		{
+			SaveProgramBinary(pending->BinaryKey);
+		}
+
+		for (const unsigned int shader : pending->Shaders)
+		{
+			glDetachShader(m_id, shader);
+			glDeleteShader(shader);
+		}
 	}
 
-	m_id = glCreateProgram();
-	glAttachShader(m_id, vs);
-	glAttachShader(m_id, fs);
-	glLinkProgram(m_id);
+	delete pending;
+	BuildLocationTable();
+}
 
-	glGetProgramiv(m_id, GL_LINK_STATUS, &success);
-	if (success == 0)
+void Shader::FinishPending()
+{
+	while (!s_pending.empty())
 	{
-		glGetProgramInfoLog(m_id, 512, nullptr, compileLog);
-		std::cout << "Failed to link shader program: " << compileLog << std::endl;
+		// Without completion status every query waits anyway, so just go in submit order
+		auto ready = std::find_if(s_pending.begin(), s_pending.end(), [](const Shader* shader) { return shader->IsReady(); });
+		Shader* shader = (ready != s_pending.end()) ? *ready : s_pending.front();
+		shader->Finish();
 	}
+}
+
+bool Shader::IsParallelCompileSupported()
+{
+	static const bool bSupported = []()
+	{
+		GLint numExtensions = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+		for (GLint idx = 0; idx < numExtensions; ++idx)
+		{
+			const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, idx));
+			if (extension != nullptr && std::strcmp(extension, "GL_KHR_parallel_shader_compile") == 0)
+			{
+				// 0xFFFFFFFF : Let implementation pick number of compiler threads
+				glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+				return true;
+			}
+		}
+
+		return false;
+	}();
+
+	return bSupported;
+}
 
-	glDeleteShader(vs);
-	glDeleteShader(fs);
+bool Shader::IsBinaryCacheSupported()
+{
+	static const bool bSupported = []()
+	{
+		GLint numFormats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+		return numFormats > 0;
+	}();
+
+	return bSupported;
 }
 
-Shader::Shader(const std::string& vsPath, const std::string& gsPath, const std::string& fsPath)
+uint64_t Shader::ComputeBinaryKey(const std::vector<Stage>& stages)
 {
-	std::string vsRaw;
-	std::string gsRaw;
-	std::string fsRaw;
+	// Binaries are only valid for the driver which produced them
+	static const uint64_t driverHash = []()
+	{
+		uint64_t hash = FNVOffsetBasis;
+		for (const GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+		{
+			const char* value = reinterpret_cast<const char*>(glGetString(name));
+			hash = HashCombine(hash, (value != nullptr) ? value : "");
+		}
+
+		return hash;
+	}();
+
+	uint64_t key = driverHash;
+	for (const auto& stage : stages)
+	{
+		key = HashCombine(key, std::to_string(stage.Type));
+		key = HashCombine(key, stage.Source);
+	}
 
-	std::ifstream vsFile;
-	std::ifstream gsFile;
-	std::ifstream fsFile;
+	return key;
+}
 
-	vsFile.exceptions(std::ifstream::badbit | std::ifstream::failbit);
-	gsFile.exceptions(std::ifstream::badbit | std::ifstream::failbit);
-	fsFile.exceptions(std::ifstream::badbit | std::ifstream::failbit);
-	try
+uint64_t Shader::HashCombine(uint64_t seed, std::string_view data)
+{
+	// FNV-1a continued from seed
+	for (const char character : data)
 	{
-		vsFile.open(vsPath);
-		gsFile.open(gsPath);
-		fsFile.open(fsPath);
+		seed ^= static_cast<uint64_t>(static_cast<unsigned char>(character));
+		seed *= 0x100000001b3ull;
+	}
 
-		std::stringstream vsStream;
-		std::stringstream gsStream;
-		std::stringstream fsStream;
+	return seed;
+}
 
-		vsStream << vsFile.rdbuf();
-		gsStream << gsFile.rdbuf();
-		fsStream << fsFile.rdbuf();
+std::string Shader::GetBinaryCachePath(uint64_t key)
+{
+	std::stringstream path;
+	path << ProgramBinaryCacheDirectory << std::hex << key << ".bin";
+	return path.str();
+}
 
-		vsFile.close();
-		gsFile.close();
-		fsFile.close();
+bool Shader::SubmitProgramBinary(uint64_t key)
+{
+	if (!IsBinaryCacheSupported())
+	{
+		return false;
+	}
 
-		vsRaw = vsStream.str();
-		gsRaw = gsStream.str();
-		fsRaw = fsStream.str();
+	std::ifstream file(GetBinaryCachePath(key), std::ios::binary);
+	if (!file.is_open())
+	{
+		return false;
 	}
-	catch (std::ifstream::failure e)
+
+	ProgramBinaryHeader header;
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!file || header.Magic != ProgramBinaryMagic || header.Key != key || header.Length == 0)
+	{
+		return false;
+	}
+
+	std::vector<char> binary(header.Length);
+	file.read(binary.data(), binary.size());
+	if (!file)
 	{
-		std::cout << "Failed to open shader files " << e.what() << std::endl;
+		return false;
 	}
 
-	const char* vsCode = vsRaw.c_str();
-	const char* gsCode = gsRaw.c_str();
-	const char* fsCode = fsRaw.c_str();
+	// Link status is checked in Finish; rejected binary falls back to compiling from source there
+	glProgramBinary(m_id, header.Format, binary.data(), static_cast<GLsizei>(binary.size()));
+	return true;
+}
 
-	unsigned int vs = 0;
-	unsigned int gs = 0;
-	unsigned int fs = 0;
-	int success = 0;
-	char compileLog[512];
+void Shader::SaveProgramBinary(uint64_t key) const
+{
+	if (!IsBinaryCacheSupported())
+	{
+		return;
+	}
 
-	vs = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vs, 1, &vsCode, nullptr);
-	glCompileShader(vs);
-	glGetShaderiv(vs, GL_COMPILE_STATUS, &success);
-	if (success == 0)
+	GLint length = 0;
+	glGetProgramiv(m_id, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
 	{
-		glGetShaderInfoLog(vs, 512, nullptr, compileLog);
-		std::cout << "Failed to compile vertex shader: " << compileLog << std::endl;
+		return;
 	}
 
-	gs = glCreateShader(GL_GEOMETRY_SHADER);
-	glShaderSource(gs, 1, &gsCode, nullptr);
-	glCompileShader(gs);
-	glGetShaderiv(gs, GL_COMPILE_STATUS, &success);
-	if (success == 0)
+	ProgramBinaryHeader header;
+	header.Key = key;
+	header.Length = static_cast<uint64_t>(length);
+
+	std::vector<char> binary(length);
+	GLenum format = 0;
+	glGetProgramBinary(m_id, length, nullptr, &format, binary.data());
+	header.Format = format;
+
+	std::error_code error;
+	std::filesystem::create_directories(ProgramBinaryCacheDirectory, error);
+
+	std::ofstream file(GetBinaryCachePath(key), std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
 	{
-		glGetShaderInfoLog(vs, 512, nullptr, compileLog);
-		std::cout << "Failed to compile geometry shader: " << compileLog << std::endl;
+		std::cout << "Failed to write program binary cache : " << GetBinaryCachePath(key) << std::endl;
+		return;
 	}
 
-	fs = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fs, 1, &fsCode, nullptr);
-	glCompileShader(fs);
-	glGetShaderiv(fs, GL_COMPILE_STATUS, &success);
-	if (success == 0)
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(binary.data(), binary.size());
+}
+
+std::string Shader::ResolveIncludes(const std::string& source, const std::string& path, unsigned int depth)
+{
+	if (depth > MaxIncludeDepth)
 	{
-		glGetShaderInfoLog(fs, 512, nullptr, compileLog);
-		std::cout << "Failed to compile fragment shader: " << compileLog << std::endl;
+		std::cout << "Shader include depth exceeded(recursive include?) : " << path << std::endl;
+		return source;
 	}
 
-	m_id = glCreateProgram();
-	glAttachShader(m_id, vs);
-	glAttachShader(m_id, gs);
-	glAttachShader(m_id, fs);
-	glLinkProgram(m_id);
+	// Included files are relative to directory of including file
+	const size_t dirEnd = path.find_last_of("/\\");
+	const std::string directory = (dirEnd == std::string::npos) ? std::string() : path.substr(0, dirEnd + 1);
 
-	glGetProgramiv(m_id, GL_LINK_STATUS, &success);
-	if (success == 0)
+	std::string result;
+	result.reserve(source.size());
+
+	std::istringstream stream(source);
+	std::string line;
+	while (std::getline(stream, line))
 	{
-		glGetProgramInfoLog(m_id, 512, nullptr, compileLog);
-		std::cout << "Failed to link shader program: " << compileLog << std::endl;
+		const size_t directivePos = line.find_first_not_of(" \t");
+		if (directivePos != std::string::npos && line.compare(directivePos, 8, "#include") == 0)
+		{
+			const size_t nameBegin = line.find('"', directivePos);
+			const size_t nameEnd = (nameBegin != std::string::npos) ? line.find('"', nameBegin + 1) : std::string::npos;
+			if (nameEnd != std::string::npos)
+			{
+				const std::string includePath = directory + line.substr(nameBegin + 1, nameEnd - nameBegin - 1);
+				std::ifstream includeFile(includePath);
+				if (includeFile.is_open())
+				{
+					std::stringstream includeStream;
+					includeStream << includeFile.rdbuf();
+					result.append(ResolveIncludes(includeStream.str(), includePath, depth + 1));
+					result.append("\n");
+					continue;
+				}
+
+				std::cout << "Failed to open shader include file : " << includePath << std::endl;
+			}
+		}
+
+		result.append(line);
+		result.append("\n");
 	}
 
-	glDeleteShader(vs);
-	glDeleteShader(gs);
-	glDeleteShader(fs);
+	return result;
+}
+
+std::string Shader::InjectDefines(const std::string& source, const std::vector<std::string>& defines)
+{
+	if (defines.empty())
+	{
+		return source;
+	}
+
+	std::string defineBlock;
+	for (const auto& define : defines)
+	{
+		defineBlock.append("#define ");
+		defineBlock.append(define);
+		defineBlock.append("\n");
+	}
+
+	// #version must be the first directive of the source
+	size_t insertPos = 0;
+	if (const size_t versionPos = source.find("#version"); versionPos != std::string::npos)
+	{
+		const size_t lineEnd = source.find('\n', versionPos);
+		if (lineEnd == std::string::npos)
+		{
+			return source + "\n" + defineBlock;
+		}
+
+		insertPos = lineEnd + 1;
+	}
+
+	std::string result = source;
+	result.insert(insertPos, defineBlock);
+	return result;
 }
 
 void Shader::Bind()
 {
-	glUseProgram(m_id);
+	Finish();
+	GLStateCache::UseProgram(m_id);
 }
 
-void Shader::SetInt(const std::string& name, int value)
+void Shader::SetInt(UniformID id, int value)
 {
-	unsigned int loc = FindLoc(name);
+	const GLint loc = FindLoc(id);
 	if (loc != INVALID_LOC)
 	{
 		glUniform1i(loc, value);
 	}
 }
 
-void Shader::SetFloat(const std::string& name, float value)
+void Shader::SetFloat(UniformID id, float value)
 {
-	unsigned int loc = FindLoc(name);
+	const GLint loc = FindLoc(id);
 	if (loc != INVALID_LOC)
 	{
 		glUniform1f(loc, value);
 	}
 }
 
-void Shader::SetVec3f(const std::string& name, glm::vec3 value)
+void Shader::SetVec2f(UniformID id, glm::vec2 value)
 {
-	unsigned int loc = FindLoc(name);
+	const GLint loc = FindLoc(id);
+	if (loc != INVALID_LOC)
+	{
+		glUniform2fv(loc, 1, &value[0]);
+	}
+}
+
+void Shader::SetVec3f(UniformID id, glm::vec3 value)
+{
+	const GLint loc = FindLoc(id);
 	if (loc != INVALID_LOC)
 	{
 		glUniform3fv(loc, 1, &value[0]);
 	}
 }
 
-void Shader::SetVec4f(const std::string& name, glm::vec4 value)
+void Shader::SetVec4f(UniformID id, glm::vec4 value)
 {
-	unsigned int loc = FindLoc(name);
+	const GLint loc = FindLoc(id);
 	if (loc != INVALID_LOC)
 	{
 		glUniform4fv(loc, 1, &value[0]);
 	}
 }
 
-void Shader::SetMat4f(const std::string& name, glm::mat4 value)
+void Shader::SetMat4f(UniformID id, const glm::mat4& value)
 {
-	unsigned int loc = FindLoc(name);
+	const GLint loc = FindLoc(id);
 	if (loc != INVALID_LOC)
 	{
 		glUniformMatrix4fv(loc, 1, GL_FALSE, &value[0][0]);
 	}
 }
 
-unsigned int Shader::FindLoc(const std::string& name)
+int Shader::FindLoc(UniformID id) const
 {
-	unsigned int loc = INVALID_LOC;
-	auto found = m_locs.find(name);
-	if (found != m_locs.end())
+	if (m_locationTable.empty())
 	{
-		loc = found->second;
+		return INVALID_LOC;
 	}
-	else
+
+	for (size_t slot = id.Hash & m_locationTableMask; ; slot = (slot + 1) & m_locationTableMask)
 	{
-		loc = glGetUniformLocation(m_id, name.c_str());
-		m_locs[name] = loc;
+		const LocationSlot& entry = m_locationTable[slot];
+		if (entry.Hash == id.Hash)
+		{
+			return entry.Location;
+		}
+		else if (entry.Hash == 0)
+		{
+			return INVALID_LOC;
+		}
 	}
+}
 
-	return loc;
+void Shader::BuildLocationTable()
+{
+	GLint numUniforms = 0;
+	GLint maxNameLength = 0;
+	glGetProgramInterfaceiv(m_id, GL_UNIFORM, GL_ACTIVE_RESOURCES, &numUniforms);
+	glGetProgramInterfaceiv(m_id, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength);
+
+	struct ActiveUniform
+	{
+		std::string Name;
+		GLint Location;
+		GLint ArraySize;
+	};
+
+	std::vector<ActiveUniform> uniforms;
+	size_t numNames = 0;
+	std::string nameBuffer(std::max(maxNameLength, 1), '\0');
+	for (GLint idx = 0; idx < numUniforms; ++idx)
+	{
+		const GLenum props[] = { GL_LOCATION, GL_ARRAY_SIZE };
+		GLint values[2] = { INVALID_LOC, 1 };
+		glGetProgramResourceiv(m_id, GL_UNIFORM, idx, 2, props, 2, nullptr, values);
+
+		// Members of uniform/storage blocks do not have location
+		if (values[0] == INVALID_LOC)
+		{
+			continue;
+		}
+
+		GLsizei length = 0;
+		glGetProgramResourceName(m_id, GL_UNIFORM, idx, static_cast<GLsizei>(nameBuffer.size()), &length, nameBuffer.data());
+		uniforms.push_back(ActiveUniform{ std::string(nameBuffer.data(), length), values[0], values[1] });
+		numNames += (values[1] > 1) ? (values[1] + 1) : 2;
+	}
+
+	// Keep load factor under 0.5, so probe sequences stay short
+	size_t capacity = 16;
+	while (capacity < numNames * 2)
+	{
+		capacity *= 2;
+	}
+
+	m_locationTable.assign(capacity, LocationSlot());
+	m_locationTableMask = capacity - 1;
+
+	for (const auto& uniform : uniforms)
+	{
+		// Arrays are reported as 'name[0]'; register 'name' and every 'name[n]'
+		std::string_view baseName = uniform.Name;
+		if (const size_t bracket = baseName.rfind("[0]"); bracket != std::string_view::npos && bracket + 3 == baseName.size())
+		{
+			baseName = baseName.substr(0, bracket);
+		}
+
+		InsertLocation(UniformID::FromString(baseName).Hash, uniform.Location);
+		for (GLint element = 0; element < uniform.ArraySize && uniform.ArraySize > 1; ++element)
+		{
+			const std::string elementName = std::string(baseName) + "[" + std::to_string(element) + "]";
+			InsertLocation(UniformID::FromString(elementName).Hash, uniform.Location + element);
+		}
+
+		if (uniform.ArraySize == 1 && baseName.size() != uniform.Name.size())
+		{
+			InsertLocation(UniformID::FromString(uniform.Name).Hash, uniform.Location);
+		}
+	}
+}
+
+void Shader::InsertLocation(uint64_t hash, int location)
+{
+	for (size_t slot = hash & m_locationTableMask; ; slot = (slot + 1) & m_locationTableMask)
+	{
+		LocationSlot& entry = m_locationTable[slot];
+		if (entry.Hash == 0)
+		{
+			entry.Hash = hash;
+			entry.Location = location;
+			return;
+		}
+		else if (entry.Hash == hash)
+		{
+			if (entry.Location != location)
+			{
+				std::cout << "Uniform name hash collision in program " << m_id << std::endl;
+			}
+
+			return;
+		}
+	}
 }
 
 void Shader::Dispatch(unsigned int numGroupX, unsigned int numGroupY, unsigned int numGroupZ)
@@ -1,8 +1,10 @@
 #pragma once
 #include <string>
-#include <unordered_map>
+#include <vector>
 
+#include "UniformID.h"
 #include "glm/matrix.hpp"
+#include "glm/vec2.hpp"
 #include "glm/vec3.hpp"
 #include "glm/vec4.hpp"
 
@@ -11,24 +13,88 @@ class Shader
 public:
 	Shader(const std::string& csPath);
 	Shader(const std::string& vsPath, const std::string& fsPath);
+	/* Each define injected as '#define <define>' right after #version directive */
+	Shader(const std::string& vsPath, const std::string& fsPath, const std::vector<std::string>& defines);
 	Shader(const std::string& vsPath, const std::string& gsPath, const std::string& fsPath);
+	Shader(const std::string& vsPath, const std::string& gsPath, const std::string& fsPath, const std::vector<std::string>& defines);
+	~Shader();
 
 	unsigned int GetProgramID() const { return m_id; }
 
+	/* True if program is finished, or driver reports compile/link completion(KHR_parallel_shader_compile) */
+	bool IsReady() const;
+	/* Collects compile/link results of this program; waits for the driver if still compiling */
+	void Finish();
+	/* Finishes every submitted program, in the order driver completes them when possible */
+	static void FinishPending();
+
+	/* Finishes program first if it is still pending */
 	void Bind();
 
-	void SetInt(const std::string& name, int value);
-	void SetFloat(const std::string& name, float value);
-	void SetVec3f(const std::string& name, glm::vec3 value);
-	void SetVec4f(const std::string& name, glm::vec4 value);
-	void SetMat4f(const std::string& name, glm::mat4 value);
+	void SetInt(UniformID id, int value);
+	void SetFloat(UniformID id, float value);
+	void SetVec2f(UniformID id, glm::vec2 value);
+	void SetVec3f(UniformID id, glm::vec3 value);
+	void SetVec4f(UniformID id, glm::vec4 value);
+	void SetMat4f(UniformID id, const glm::mat4& value);
 
-	unsigned int FindLoc(const std::string& name);
+	/* -1 if uniform is not active in this program */
+	int FindLoc(UniformID id) const;
 
 	void Dispatch(unsigned int numGroupX, unsigned int numGroupY, unsigned int numGroupZ);
 
 private:
+	struct Stage
+	{
+		unsigned int Type;
+		std::string Path;
+		std::string Source;
+	};
+
+	/* Reads source with includes resolved and defines injected */
+	static std::string LoadSource(const std::string& path, const std::vector<std::string>& defines);
+	/* Program submitted to driver whose compile/link status is not queried yet */
+	struct PendingBuild
+	{
+		uint64_t BinaryKey = 0;
+		std::vector<Stage> Stages;
+		std::vector<unsigned int> Shaders;
+		bool bFromBinary = false;
+	};
+
+	/* Issues program binary or every stage compile and link, without querying results */
+	void Submit(const std::vector<Stage>& stages);
+	void SubmitCompile(PendingBuild& pending);
+
+	static bool IsParallelCompileSupported();
+	static bool IsBinaryCacheSupported();
+	static uint64_t ComputeBinaryKey(const std::vector<Stage>& stages);
+	static uint64_t HashCombine(uint64_t seed, std::string_view data);
+	static std::string GetBinaryCachePath(uint64_t key);
+	bool SubmitProgramBinary(uint64_t key);
+	void SaveProgramBinary(uint64_t key) const;
+
+	/* Expands '#include "file"' lines recursively; paths are relative to the including file */
+	static std::string ResolveIncludes(const std::string& source, const std::string& path, unsigned int depth = 0);
+	static std::string InjectDefines(const std::string& source, const std::vector<std::string>& defines);
+
+	/* Resolves every active uniform location right after link, through program interface query */
+	void BuildLocationTable();
+	void InsertLocation(uint64_t hash, int location);
+
+private:
+	/* Open addressing(linear probing) slot; Hash zero means empty */
+	struct LocationSlot
+	{
+		uint64_t Hash = 0;
+		int Location = -1;
+	};
+
 	unsigned int m_id;
-	std::unordered_map<std::string, int> m_locs;
+	PendingBuild* m_pending = nullptr;
+	std::vector<LocationSlot> m_locationTable;
+	size_t m_locationTableMask = 0;
+
+	static std::vector<Shader*> s_pending;
 
 };
\ No newline at end of file
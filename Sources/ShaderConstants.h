@@ -0,0 +1,48 @@
+#pragma once
+#include "Rendering.h"
+#include "glm/glm.hpp"
+
+/* UBO binding points; shared by every program */
+constexpr GLuint FrameConstantsBinding = 0;
+constexpr GLuint LightConstantsBinding = 1;
+constexpr GLuint VoxelConstantsBinding = 2;
+
+/* std140 layout of 'FrameConstants' block in shaders */
+struct FrameConstants
+{
+	glm::mat4 ViewMatrix = glm::mat4(1.0f);
+	glm::mat4 ProjMatrix = glm::mat4(1.0f);
+	glm::vec3 CamPos = glm::vec3(0.0f);
+	float Padding = 0.0f;
+};
+
+/* std140 layout of 'LightConstants' block in shaders */
+struct LightConstants
+{
+	glm::vec3 Direction = glm::vec3(0.0f, -1.0f, 0.0f);
+	float Padding0 = 0.0f;
+	glm::vec3 Intensity = glm::vec3(0.0f);
+	float Padding1 = 0.0f;
+	glm::mat4 ShadowViewMat = glm::mat4(1.0f);
+	glm::mat4 ShadowProjMat = glm::mat4(1.0f);
+};
+
+/* std140 layout of 'VoxelConstants' block in shaders */
+struct VoxelConstants
+{
+	glm::mat4 ProjX = glm::mat4(1.0f);
+	glm::mat4 ProjY = glm::mat4(1.0f);
+	glm::mat4 ProjZ = glm::mat4(1.0f);
+	float VoxelGridWorldSize = 0.0f;
+	float VoxelDim = 0.0f;
+	float MaxDistance = 0.0f;
+	float Step = 0.0f;
+	float AlphaThreshold = 0.0f;
+	float InitialStep = 0.0f;
+	GLint SpecularSampleNum = 0;
+	float Padding = 0.0f;
+};
+
+static_assert(sizeof(FrameConstants) == 144, "FrameConstants must match std140 layout");
+static_assert(sizeof(LightConstants) == 160, "LightConstants must match std140 layout");
+static_assert(sizeof(VoxelConstants) == 224, "VoxelConstants must match std140 layout");
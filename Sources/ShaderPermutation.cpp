@@ -0,0 +1,59 @@
+#include "ShaderPermutation.h"
+#include "Shader.h"
+
+ShaderPermutation::ShaderPermutation(
+	const std::string& vsPath,
+	const std::string& fsPath,
+	const std::vector<std::string>& defines,
+	const std::vector<std::string>& featureDefines) :
+	ShaderPermutation(vsPath, std::string(), fsPath, defines, featureDefines)
+{
+}
+
+ShaderPermutation::ShaderPermutation(
+	const std::string& vsPath,
+	const std::string& gsPath,
+	const std::string& fsPath,
+	const std::vector<std::string>& defines,
+	const std::vector<std::string>& featureDefines) :
+	m_vsPath(vsPath),
+	m_gsPath(gsPath),
+	m_fsPath(fsPath),
+	m_defines(defines),
+	m_featureDefines(featureDefines)
+{
+}
+
+ShaderPermutation::~ShaderPermutation()
+{
+	for (auto& variant : m_variants)
+	{
+		delete variant.second;
+	}
+
+	m_variants.clear();
+}
+
+Shader* ShaderPermutation::Get(uint32_t features)
+{
+	if (auto found = m_variants.find(features); found != m_variants.end())
+	{
+		return found->second;
+	}
+
+	std::vector<std::string> defines = m_defines;
+	for (size_t bit = 0; bit < m_featureDefines.size(); ++bit)
+	{
+		if ((features & (1u << bit)) != 0)
+		{
+			defines.push_back(m_featureDefines[bit]);
+		}
+	}
+
+	Shader* variant = m_gsPath.empty() ?
+		new Shader(m_vsPath, m_fsPath, defines) :
+		new Shader(m_vsPath, m_gsPath, m_fsPath, defines);
+
+	m_variants[features] = variant;
+	return variant;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+class Shader;
+
+/*
+* Set of shader variants compiled from same sources.
+* Each bit of feature mask injects its define; variants are compiled on first use and cached.
+* New variant is only submitted to driver by Get; it is finished when first bound.
+**/
+class ShaderPermutation
+{
+public:
+	/* featureDefines[n] : Define injected when bit n of feature mask is set */
+	ShaderPermutation(
+		const std::string& vsPath,
+		const std::string& fsPath,
+		const std::vector<std::string>& defines,
+		const std::vector<std::string>& featureDefines);
+	ShaderPermutation(
+		const std::string& vsPath,
+		const std::string& gsPath,
+		const std::string& fsPath,
+		const std::vector<std::string>& defines,
+		const std::vector<std::string>& featureDefines);
+	~ShaderPermutation();
+
+	Shader* Get(uint32_t features);
+
+	size_t GetCompiledVariants() const { return m_variants.size(); }
+
+private:
+	std::string m_vsPath;
+	std::string m_gsPath;
+	std::string m_fsPath;
+	std::vector<std::string> m_defines;
+	std::vector<std::string> m_featureDefines;
+
+	std::unordered_map<uint32_t, Shader*> m_variants;
+
+};
@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "Rendering.h"
+#include "GLStateCache.h"
 #include <iostream>
 
 class ShadowMap
@@ -10,10 +11,10 @@ public:
    m_height(height)
    {
       glGenFramebuffers(1, &m_fbo);
-      glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+      GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, m_fbo);
 
       glGenTextures(1, &m_texture);
-      glBindTexture(GL_TEXTURE_2D, m_texture);
+      GLStateCache::BindTexture(GL_TEXTURE_2D, 0, m_texture);
       glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
 
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -33,24 +34,22 @@ public:
 
    void Bind()
    {
-      glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+      GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, m_fbo);
    }
 
    void Unbind()
    {
-      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+      GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, 0);
    }
 
    void BindAsTexture(unsigned int slot)
    {
-      glActiveTexture(GL_TEXTURE0 + slot);
-      glBindTexture(GL_TEXTURE_2D, m_texture);
+      GLStateCache::BindTexture(GL_TEXTURE_2D, slot, m_texture);
    }
 
    void UnbindAsTexture(unsigned int slot)
    {
-      glActiveTexture(GL_TEXTURE0 + slot);
-      glBindTexture(GL_TEXTURE_2D, 0);
+      GLStateCache::BindTexture(GL_TEXTURE_2D, slot, 0);
    }
 
    unsigned int GetWidth() const { return m_width; }
@@ -23,22 +23,24 @@ void SponzaScene::Construct()
 		.GenUVs = false,
 		.PreTransformVertices = false,
 		.Triangulate = false };
-	m_sponza = this->LoadModel("Sponza", "Resources/Models/Sponza/Sponza.gltf", sponzaLoadParams);
-	m_sponza->SetScale(glm::vec3(0.05f));
-
-	const auto& sponzaMaterials = m_sponza->GetMaterials();
-	for (auto material : sponzaMaterials)
+	// Every model streams in on worker threads; material setup waits for its model
+	m_sponza = this->LoadModelAsync("Sponza", "Resources/Models/Sponza/Sponza.gltf", sponzaLoadParams, [this](Model* sponza)
 	{
-		const std::string_view baseColorPath = material->GetBaseColor()->GetURI();
-		//Floor
-		if (baseColorPath == "Resources/Models/Sponza/5823059166183034438.jpg")
+		const auto& sponzaMaterials = sponza->GetMaterials();
+		for (auto material : sponzaMaterials)
 		{
-			m_floorMaterial = material;
-			material->SetForceFactor(EMaterialTexture::MetallicRoughness, true);
-			material->SetRoughnessFactor(m_floorRoughness);
-			material->SetMetallicFactor(0.0f);
+			const std::string_view baseColorPath = material->GetBaseColor()->GetURI();
+			//Floor
+			if (baseColorPath == "Resources/Models/Sponza/5823059166183034438.jpg")
+			{
+				m_floorMaterial = material;
+				material->SetForceFactor(EMaterialTexture::MetallicRoughness, true);
+				material->SetRoughnessFactor(m_floorRoughness);
+				material->SetMetallicFactor(0.0f);
+			}
 		}
-	}
+	}).Target;
+	m_sponza->SetScale(glm::vec3(0.05f));
 
 	const ModelLoadParams helmetLoadParams{
 		.CalcTangentSpace = true,
@@ -47,11 +49,13 @@ void SponzaScene::Construct()
 		.GenUVs = false,
 		.PreTransformVertices = true,
 		.Triangulate = false };
-	auto helmet = this->LoadModel("Helmet", "Resources/Models/DamagedHelmet/DamagedHelmet.gltf", helmetLoadParams);
+	auto helmet = this->LoadModelAsync("Helmet", "Resources/Models/DamagedHelmet/DamagedHelmet.gltf", helmetLoadParams, [](Model* helmet)
+	{
+		helmet->GetMaterial(0)->SetEmissiveIntensity(5.0f);
+	}).Target;
 	helmet->SetPosition(glm::vec3(0.0f, 2.0f, -5.5f));
 	helmet->SetScale(glm::vec3(2.5f));
 	helmet->SetRotation(glm::rotate(glm::quat(), glm::radians(135.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
-	helmet->GetMaterial(0)->SetEmissiveIntensity(5.0f);
 
 	const ModelLoadParams buddhaLoadParams{
 	.CalcTangentSpace = true,
@@ -61,16 +65,18 @@ void SponzaScene::Construct()
 	.PreTransformVertices = true,
 	.Triangulate = true
 	};
-	auto buddha = this->LoadModel("Buddah", "Resources/Models/Buddha/buddha.obj", buddhaLoadParams);
+	auto buddha = this->LoadModelAsync("Buddah", "Resources/Models/Buddha/buddha.obj", buddhaLoadParams, [](Model* buddha)
+	{
+		auto buddhaMat = buddha->GetMaterial(0);
+		buddhaMat->SetForceFactor(EMaterialTexture::BaseColor, true);
+		buddhaMat->SetForceFactor(EMaterialTexture::MetallicRoughness, true);
+		buddhaMat->SetMetallicFactor(1.0f);
+		buddhaMat->SetRoughnessFactor(0.5f);
+		buddhaMat->SetBaseColorFactor(glm::vec4(1.0f));
+	}).Target;
 	buddha->SetPosition(glm::vec3(14.5f, 4.0f, 1.5f));
 	buddha->SetScale(glm::vec3(10.5f));
 	buddha->SetRotation(glm::rotate(glm::quat(), glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
-	auto buddhaMat = buddha->GetMaterial(0);
-	buddhaMat->SetForceFactor(EMaterialTexture::BaseColor, true);
-	buddhaMat->SetForceFactor(EMaterialTexture::MetallicRoughness, true);
-	buddhaMat->SetMetallicFactor(1.0f);
-	buddhaMat->SetRoughnessFactor(0.5f);
-	buddhaMat->SetBaseColorFactor(glm::vec4(1.0f));
 
 	const ModelLoadParams sphereLoadParams{
 		.CalcTangentSpace = true,
@@ -80,105 +86,125 @@ void SponzaScene::Construct()
 		.PreTransformVertices = true,
 		.Triangulate = true
 	};
-	m_sphere = this->LoadModel("Sphere", "Resources/Models/sphere.obj", sphereLoadParams);
+	m_sphere = this->LoadModelAsync("Sphere", "Resources/Models/sphere.obj", sphereLoadParams, [](Model* sphere)
+	{
+		auto sphereMat = sphere->GetMaterial(0);
+		//sphereMat->SetForceFactor(EMaterialTexture::Emissive, true);
+		sphereMat->SetForceFactor(EMaterialTexture::BaseColor, true);
+		sphereMat->SetBaseColorFactor(glm::vec4(0.0f));
+		//sphereMat->SetBaseColorFactor(glm::vec4(1.0f));
+		sphereMat->SetRefract(true);
+		sphereMat->SetIOR(1.2f);
+	}).Target;
 	m_sphere->bCastShadow = false;
 	m_sphere->SetActive(false);
-	auto sphereMat = m_sphere->GetMaterial(0);
-	//sphereMat->SetForceFactor(EMaterialTexture::Emissive, true);
-	sphereMat->SetForceFactor(EMaterialTexture::BaseColor, true);
-	sphereMat->SetBaseColorFactor(glm::vec4(0.0f));
-	//sphereMat->SetBaseColorFactor(glm::vec4(1.0f));
-	sphereMat->bRefract = true;
-	sphereMat->IOR = 1.2f;
-
-	auto emissiveSphere0 = this->LoadModel("EmissiveSphere0", "Resources/Models/sphere.obj", sphereLoadParams);
-	emissiveSphere0->SetPosition(glm::vec3(20.0f, 30.0f, -20.0f));
-	auto emissiveSphere0Mat = emissiveSphere0->GetMaterial(0);
 
-	emissiveSphere0Mat->SetForceFactor(EMaterialTexture::BaseColor, true);
-	emissiveSphere0Mat->SetForceFactor(EMaterialTexture::Emissive, true);
-	emissiveSphere0Mat->SetEmissiveFactor(glm::vec3(0.0f, 1.0f, 0.0f));
-	emissiveSphere0Mat->SetEmissiveIntensity(1.0f);
-	emissiveSphere0Mat->SetBaseColorFactor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	auto emissiveSphere0 = this->LoadModelAsync("EmissiveSphere0", "Resources/Models/sphere.obj", sphereLoadParams, [](Model* emissiveSphere0)
+	{
+		auto emissiveSphere0Mat = emissiveSphere0->GetMaterial(0);
+
+		emissiveSphere0Mat->SetForceFactor(EMaterialTexture::BaseColor, true);
+		emissiveSphere0Mat->SetForceFactor(EMaterialTexture::Emissive, true);
+		emissiveSphere0Mat->SetEmissiveFactor(glm::vec3(0.0f, 1.0f, 0.0f));
+		emissiveSphere0Mat->SetEmissiveIntensity(1.0f);
+		emissiveSphere0Mat->SetBaseColorFactor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	}).Target;
+	emissiveSphere0->SetPosition(glm::vec3(20.0f, 30.0f, -20.0f));
 
-	auto emissiveSphere1 = this->LoadModel("EmissiveSphere1", "Resources/Models/sphere.obj", sphereLoadParams);
+	auto emissiveSphere1 = this->LoadModelAsync("EmissiveSphere1", "Resources/Models/sphere.obj", sphereLoadParams, [](Model* emissiveSphere1)
+	{
+		auto emissiveSphere1Mat = emissiveSphere1->GetMaterial(0);
+
+		emissiveSphere1Mat->SetForceFactor(EMaterialTexture::BaseColor, true);
+		emissiveSphere1Mat->SetForceFactor(EMaterialTexture::Emissive, true);
+		emissiveSphere1Mat->SetEmissiveFactor(glm::vec3(0.0f, 1.0f, 1.0f));
+		emissiveSphere1Mat->SetEmissiveIntensity(1.0f);
+		emissiveSphere1Mat->SetBaseColorFactor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	}).Target;
 	emissiveSphere1->SetPosition(glm::vec3(0.0f, 30.0f, -20.0f));
-	auto emissiveSphere1Mat = emissiveSphere1->GetMaterial(0);
-
-	emissiveSphere1Mat->SetForceFactor(EMaterialTexture::BaseColor, true);
-	emissiveSphere1Mat->SetForceFactor(EMaterialTexture::Emissive, true);
-	emissiveSphere1Mat->SetEmissiveFactor(glm::vec3(0.0f, 1.0f, 1.0f));
-	emissiveSphere1Mat->SetEmissiveIntensity(1.0f);
-	emissiveSphere1Mat->SetBaseColorFactor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
 
-	auto emissiveSphere2 = this->LoadModel("EmissiveSphere2", "Resources/Models/sphere.obj", sphereLoadParams);
+	auto emissiveSphere2 = this->LoadModelAsync("EmissiveSphere2", "Resources/Models/sphere.obj", sphereLoadParams, [](Model* emissiveSphere2)
+	{
+		auto emissiveSphere2Mat = emissiveSphere2->GetMaterial(0);
+
+		emissiveSphere2Mat->SetForceFactor(EMaterialTexture::BaseColor, true);
+		emissiveSphere2Mat->SetForceFactor(EMaterialTexture::Emissive, true);
+		emissiveSphere2Mat->SetEmissiveFactor(glm::vec3(1.0f, 1.0f, 0.0f));
+		emissiveSphere2Mat->SetEmissiveIntensity(1.0f);
+		emissiveSphere2Mat->SetBaseColorFactor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	}).Target;
 	emissiveSphere2->SetPosition(glm::vec3(-20.0f, 30.0f, -20.0f));
-	auto emissiveSphere2Mat = emissiveSphere2->GetMaterial(0);
-
-	emissiveSphere2Mat->SetForceFactor(EMaterialTexture::BaseColor, true);
-	emissiveSphere2Mat->SetForceFactor(EMaterialTexture::Emissive, true);
-	emissiveSphere2Mat->SetEmissiveFactor(glm::vec3(1.0f, 1.0f, 0.0f));
-	emissiveSphere2Mat->SetEmissiveIntensity(1.0f);
-	emissiveSphere2Mat->SetBaseColorFactor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
 
-	auto emissiveSphere3 = this->LoadModel("EmissiveSphere3", "Resources/Models/sphere.obj", sphereLoadParams);
+	auto emissiveSphere3 = this->LoadModelAsync("EmissiveSphere3", "Resources/Models/sphere.obj", sphereLoadParams, [](Model* emissiveSphere3)
+	{
+		auto emissiveSphere3Mat = emissiveSphere3->GetMaterial(0);
+
+		emissiveSphere3Mat->SetForceFactor(EMaterialTexture::BaseColor, true);
+		emissiveSphere3Mat->SetForceFactor(EMaterialTexture::Emissive, true);
+		emissiveSphere3Mat->SetEmissiveFactor(glm::vec3(1.0f, 0.0f, 0.0f));
+		emissiveSphere3Mat->SetEmissiveIntensity(1.0f);
+		emissiveSphere3Mat->SetBaseColorFactor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	}).Target;
 	emissiveSphere3->SetPosition(glm::vec3(-40.0f, 30.0f, -20.0f));
-	auto emissiveSphere3Mat = emissiveSphere3->GetMaterial(0);
-
-	emissiveSphere3Mat->SetForceFactor(EMaterialTexture::BaseColor, true);
-	emissiveSphere3Mat->SetForceFactor(EMaterialTexture::Emissive, true);
-	emissiveSphere3Mat->SetEmissiveFactor(glm::vec3(1.0f, 0.0f, 0.0f));
-	emissiveSphere3Mat->SetEmissiveIntensity(1.0f);
-	emissiveSphere3Mat->SetBaseColorFactor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
 
-	auto emissiveSphere4 = this->LoadModel("EmissiveSphere4", "Resources/Models/sphere.obj", sphereLoadParams);
+	auto emissiveSphere4 = this->LoadModelAsync("EmissiveSphere4", "Resources/Models/sphere.obj", sphereLoadParams, [](Model* emissiveSphere4)
+	{
+		auto emissiveSphere4Mat = emissiveSphere4->GetMaterial(0);
+
+		emissiveSphere4Mat->SetForceFactor(EMaterialTexture::BaseColor, true);
+		emissiveSphere4Mat->SetForceFactor(EMaterialTexture::Emissive, true);
+		emissiveSphere4Mat->SetEmissiveFactor(glm::vec3(1.0f, 1.0f, 1.0f));
+		emissiveSphere4Mat->SetEmissiveIntensity(1.0f);
+		emissiveSphere4Mat->SetBaseColorFactor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	}).Target;
 	emissiveSphere4->SetPosition(glm::vec3(-60.0f, 30.0f, -20.0f));
-	auto emissiveSphere4Mat = emissiveSphere4->GetMaterial(0);
-
-	emissiveSphere4Mat->SetForceFactor(EMaterialTexture::BaseColor, true);
-	emissiveSphere4Mat->SetForceFactor(EMaterialTexture::Emissive, true);
-	emissiveSphere4Mat->SetEmissiveFactor(glm::vec3(1.0f, 1.0f, 1.0f));
-	emissiveSphere4Mat->SetEmissiveIntensity(1.0f);
-	emissiveSphere4Mat->SetBaseColorFactor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
 
-	auto emissiveSphere5 = this->LoadModel("EmissiveSphere5", "Resources/Models/sphere.obj", sphereLoadParams);
+	auto emissiveSphere5 = this->LoadModelAsync("EmissiveSphere5", "Resources/Models/sphere.obj", sphereLoadParams, [](Model* emissiveSphere5)
+	{
+		auto emissiveSphere5Mat = emissiveSphere5->GetMaterial(0);
+
+		emissiveSphere5Mat->SetForceFactor(EMaterialTexture::BaseColor, true);
+		emissiveSphere5Mat->SetForceFactor(EMaterialTexture::Emissive, true);
+		emissiveSphere5Mat->SetEmissiveFactor(glm::vec3(1.0f, 1.0f, 1.0f));
+		emissiveSphere5Mat->SetEmissiveIntensity(1.0f);
+		emissiveSphere5Mat->SetBaseColorFactor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	}).Target;
 	emissiveSphere5->SetPosition(glm::vec3(-60.0f, 30.0f, -7.0f));
-	auto emissiveSphere5Mat = emissiveSphere5->GetMaterial(0);
-
-	emissiveSphere5Mat->SetForceFactor(EMaterialTexture::BaseColor, true);
-	emissiveSphere5Mat->SetForceFactor(EMaterialTexture::Emissive, true);
-	emissiveSphere5Mat->SetEmissiveFactor(glm::vec3(1.0f, 1.0f, 1.0f));
-	emissiveSphere5Mat->SetEmissiveIntensity(1.0f);
-	emissiveSphere5Mat->SetBaseColorFactor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
 
-	auto emissiveSphere6 = this->LoadModel("EmissiveSphere4", "Resources/Models/sphere.obj", sphereLoadParams);
+	auto emissiveSphere6 = this->LoadModelAsync("EmissiveSphere4", "Resources/Models/sphere.obj", sphereLoadParams, [](Model* emissiveSphere6)
+	{
+		auto emissiveSphere6Mat = emissiveSphere6->GetMaterial(0);
+
+		emissiveSphere6Mat->SetForceFactor(EMaterialTexture::BaseColor, true);
+		emissiveSphere6Mat->SetForceFactor(EMaterialTexture::Emissive, true);
+		emissiveSphere6Mat->SetEmissiveFactor(glm::vec3(1.0f, 1.0f, 1.0f));
+		emissiveSphere6Mat->SetEmissiveIntensity(1.0f);
+		emissiveSphere6Mat->SetBaseColorFactor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	}).Target;
 	emissiveSphere6->SetPosition(glm::vec3(-60.0f, 30.0f, 10.0f));
-	auto emissiveSphere6Mat = emissiveSphere6->GetMaterial(0);
-
-	emissiveSphere6Mat->SetForceFactor(EMaterialTexture::BaseColor, true);
-	emissiveSphere6Mat->SetForceFactor(EMaterialTexture::Emissive, true);
-	emissiveSphere6Mat->SetEmissiveFactor(glm::vec3(1.0f, 1.0f, 1.0f));
-	emissiveSphere6Mat->SetEmissiveIntensity(1.0f);
-	emissiveSphere6Mat->SetBaseColorFactor(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
 
-	Model* metallicSphere = this->LoadModel("MetallicSphere", "Resources/Models/sphere.obj", sphereLoadParams);
+	Model* metallicSphere = this->LoadModelAsync("MetallicSphere", "Resources/Models/sphere.obj", sphereLoadParams, [](Model* metallicSphere)
+	{
+		auto metallicSphereMat = metallicSphere->GetMaterial(0);
+		metallicSphereMat->SetForceFactor(EMaterialTexture::BaseColor, true);
+		metallicSphereMat->SetForceFactor(EMaterialTexture::MetallicRoughness, true);
+		metallicSphereMat->SetBaseColorFactor(glm::vec4(1.0f));
+		metallicSphereMat->SetMetallicFactor(1.0f);
+		metallicSphereMat->SetRoughnessFactor(0.0f);
+	}).Target;
 	metallicSphere->SetPosition(glm::vec3(-7.0f, 2.0f, -5.5f));
-	auto metallicSphereMat = metallicSphere->GetMaterial(0);
-	metallicSphereMat->SetForceFactor(EMaterialTexture::BaseColor, true);
-	metallicSphereMat->SetForceFactor(EMaterialTexture::MetallicRoughness, true);
-	metallicSphereMat->SetBaseColorFactor(glm::vec4(1.0f));
-	metallicSphereMat->SetMetallicFactor(1.0f);
-	metallicSphereMat->SetRoughnessFactor(0.0f);
-
-	auto refractiveBunny = this->LoadModel("RefractiveBunny", "Resources/Models/bunny.obj", sphereLoadParams);
+
+	auto refractiveBunny = this->LoadModelAsync("RefractiveBunny", "Resources/Models/bunny.obj", sphereLoadParams, [](Model* refractiveBunny)
+	{
+		auto refractiveBunnyMat = refractiveBunny->GetMaterial(0);
+		refractiveBunnyMat->SetForceFactor(EMaterialTexture::BaseColor, true);
+		refractiveBunnyMat->SetBaseColorFactor(glm::vec4(0.0f));
+		refractiveBunnyMat->SetRefract(true);
+		refractiveBunnyMat->SetIOR(1.2f);
+	}).Target;
 	refractiveBunny->SetPosition(glm::vec3(-21.0f, 0.0f, -7.5f));
 	refractiveBunny->SetScale(glm::vec3(1.5f));
 	refractiveBunny->bCastShadow = false;
-	auto refractiveBunnyMat = refractiveBunny->GetMaterial(0);
-	refractiveBunnyMat->SetForceFactor(EMaterialTexture::BaseColor, true);
-	refractiveBunnyMat->SetBaseColorFactor(glm::vec4(0.0f));
-	refractiveBunnyMat->bRefract = true;
-	refractiveBunnyMat->IOR = 1.2f;
 
 	m_quad = this->CreatePlane("EmissivePlane");
 	m_quad->bDoubleSided = true;
@@ -192,7 +218,7 @@ void SponzaScene::Construct()
 	std::filesystem::path animeEmissiveTexture = "Resources/Textures/fd376fc20378ec4fe5f372a82b6d55ccd9dbec2e.png";
 	if (std::filesystem::exists(animeEmissiveTexture))
 	{
-		quadMat->SetEmissive(new Texture2D("Resources/Textures/fd376fc20378ec4fe5f372a82b6d55ccd9dbec2e.png"));
+		quadMat->SetEmissive(Texture2D::LoadAsync("Resources/Textures/fd376fc20378ec4fe5f372a82b6d55ccd9dbec2e.png", glm::u8vec4(0, 0, 0, 255)));
 	}
 	else
 	{
@@ -338,13 +364,19 @@ void SponzaScene::KeyCallback(GLFWwindow* window, int key, int scanCode, int act
 		case GLFW_KEY_MINUS:
 			m_floorRoughness -= 0.1f;
 			m_floorRoughness = std::max(0.0f, m_floorRoughness);
-			m_floorMaterial->SetRoughnessFactor(m_floorRoughness);
+			if (m_floorMaterial != nullptr)
+			{
+				m_floorMaterial->SetRoughnessFactor(m_floorRoughness);
+			}
 			break;
 
 		case GLFW_KEY_EQUAL:
 			m_floorRoughness += 0.1f;
 			m_floorRoughness = std::min(1.0f, m_floorRoughness);
-			m_floorMaterial->SetRoughnessFactor(m_floorRoughness);
+			if (m_floorMaterial != nullptr)
+			{
+				m_floorMaterial->SetRoughnessFactor(m_floorRoughness);
+			}
 			break;
 
 		case GLFW_KEY_C:
@@ -0,0 +1,90 @@
+#include "StagingRingBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+constexpr GLuint64 FenceWaitTimeout = 1000000; // ns
+constexpr GLsizeiptr StagingAlignment = 16;
+
+StagingRingBuffer::StagingRingBuffer(GLsizeiptr segmentSize) :
+	m_segmentSize(((segmentSize + StagingAlignment - 1) / StagingAlignment) * StagingAlignment)
+{
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glCreateBuffers(1, &m_buffer);
+	glNamedBufferStorage(m_buffer, m_segmentSize * StagingRingSegmentCount, nullptr, flags);
+	m_mapped = static_cast<GLubyte*>(glMapNamedBufferRange(m_buffer, 0, m_segmentSize * StagingRingSegmentCount, flags));
+	if (m_mapped == nullptr)
+	{
+		std::cout << "StagingRingBuffer : Failed to map persistent staging buffer" << std::endl;
+	}
+}
+
+StagingRingBuffer::~StagingRingBuffer()
+{
+	for (GLsync& fence : m_fences)
+	{
+		if (fence != nullptr)
+		{
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+
+	if (m_mapped != nullptr)
+	{
+		glUnmapNamedBuffer(m_buffer);
+		m_mapped = nullptr;
+	}
+
+	glDeleteBuffers(1, &m_buffer);
+}
+
+void StagingRingBuffer::NextSegment()
+{
+	m_fences[m_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	m_segment = (m_segment + 1) % StagingRingSegmentCount;
+	m_offset = 0;
+
+	GLsync& fence = m_fences[m_segment];
+	if (fence != nullptr)
+	{
+		GLenum result = glClientWaitSync(fence, 0, 0);
+		while (result == GL_TIMEOUT_EXPIRED)
+		{
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FenceWaitTimeout);
+		}
+
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+}
+
+void StagingRingBuffer::Upload(GLuint dstBuffer, GLintptr dstOffset, const void* data, GLsizeiptr size)
+{
+	if (m_mapped == nullptr)
+	{
+		glNamedBufferSubData(dstBuffer, dstOffset, size, data);
+		return;
+	}
+
+	const GLubyte* src = static_cast<const GLubyte*>(data);
+	while (size > 0)
+	{
+		if (m_offset >= m_segmentSize)
+		{
+			NextSegment();
+		}
+
+		const GLsizeiptr chunkSize = std::min(size, m_segmentSize - m_offset);
+		const GLintptr stagingOffset = m_segmentSize * m_segment + m_offset;
+		std::memcpy(m_mapped + stagingOffset, src, chunkSize);
+		glCopyNamedBufferSubData(m_buffer, dstBuffer, stagingOffset, dstOffset, chunkSize);
+
+		m_offset += ((chunkSize + StagingAlignment - 1) / StagingAlignment) * StagingAlignment;
+		m_uploadedBytes += chunkSize;
+		src += chunkSize;
+		dstOffset += chunkSize;
+		size -= chunkSize;
+	}
+}
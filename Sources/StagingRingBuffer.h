@@ -0,0 +1,37 @@
+#pragma once
+#include "Rendering.h"
+
+/* Segments of the ring; a segment is rewritten only after GPU copies out of it are done */
+constexpr unsigned int StagingRingSegmentCount = 4;
+
+/*
+* Persistently mapped upload buffer, split into segments.
+* Data is written straight into mapped memory, then copied on GPU to its destination with glCopyNamedBufferSubData.
+* Segment is fenced when it fills up; upload waits only when the ring wraps around onto a segment still being copied.
+**/
+class StagingRingBuffer
+{
+public:
+	StagingRingBuffer(GLsizeiptr segmentSize);
+	~StagingRingBuffer();
+
+	/* Data larger than free space of current segment is split into several copies */
+	void Upload(GLuint dstBuffer, GLintptr dstOffset, const void* data, GLsizeiptr size);
+
+	size_t GetUploadedBytes() const { return m_uploadedBytes; }
+
+private:
+	void NextSegment();
+
+private:
+	GLuint m_buffer = 0;
+	GLubyte* m_mapped = nullptr;
+	GLsizeiptr m_segmentSize = 0;
+
+	GLsync m_fences[StagingRingSegmentCount] = { nullptr, nullptr, nullptr, nullptr };
+	unsigned int m_segment = 0;
+	GLsizeiptr m_offset = 0;
+
+	size_t m_uploadedBytes = 0;
+
+};
@@ -6,11 +6,26 @@
 
 #include "SponzaScene.h"
 #include "CornellBoxScene.h"
+#include "FrustumCuller.h"
+#include "JobSystem.h"
+#include "TextureCache.h"
+#include "MeshCache.h"
+#include "GeometryBuffer.h"
 
 #include <iostream>
 
 #include "Scene.h"
 
+TestApp::TestApp(const std::string& title, unsigned int width, unsigned int height, bool bFullScreen, bool bPackedVertices) :
+	Application(title, width, height, bFullScreen)
+{
+	// Vertex format has to be fixed before renderer creates its shaders
+	if (bPackedVertices)
+	{
+		GeometryBuffer::SetVertexFormat(EVertexFormat::Packed);
+	}
+}
+
 TestApp::~TestApp()
 {
 	delete m_controller;
@@ -24,6 +39,7 @@ bool TestApp::Init()
 
 	m_sponzaScene = new SponzaScene();
 	{
+		m_sponzaScene->SetJobSystem(this->GetJobSystem());
 		m_sponzaScene->Construct();
 
 		Camera* sceneMainCamera = m_sponzaScene->GetMainCamera();
@@ -36,6 +52,7 @@ bool TestApp::Init()
 
 	m_cornellBoxScene = new CornellBoxScene();
 	{
+		m_cornellBoxScene->SetJobSystem(this->GetJobSystem());
 		m_cornellBoxScene->Construct();
 
 		Camera* sceneMainCamera = m_cornellBoxScene->GetMainCamera();
@@ -84,6 +101,18 @@ void TestApp::KeyCallback(GLFWwindow * window, int key, int scanCode, int action
 			}
 			break;
 
+		case GLFW_KEY_F4:
+			renderer->bEnableDynamicResolution = !renderer->bEnableDynamicResolution;
+			if (renderer->bEnableDynamicResolution)
+			{
+				std::cout << "Renderer : Enabled Dynamic Resolution with Temporal Upscaling" << std::endl;
+			}
+			else
+			{
+				std::cout << "Renderer : Disabled Dynamic Resolution" << std::endl;
+			}
+			break;
+
 		case GLFW_KEY_F5:
 			ChangeSceneTo(EPredefinedScene::Sponza);
 			break;
@@ -92,6 +121,32 @@ void TestApp::KeyCallback(GLFWwindow * window, int key, int scanCode, int action
 			ChangeSceneTo(EPredefinedScene::CornellBox);
 			break;
 
+		case GLFW_KEY_F7:
+			renderer->bEnableDepthPrepass = !renderer->bEnableDepthPrepass;
+			if (renderer->bEnableDepthPrepass)
+			{
+				std::cout << "Renderer : Enabled Depth Prepass" << std::endl;
+			}
+			else
+			{
+				std::cout << "Renderer : Disabled Depth Prepass (Saved at least ~" << renderer->GetDepthPrepassSavedFragments() << " shaded fragments, "
+					<< renderer->GetVCTShadedFragments() << " shaded on last measured frame)" << std::endl;
+			}
+			break;
+
+		case GLFW_KEY_F8:
+			FrustumCuller::RunBenchmark();
+			break;
+
+		case GLFW_KEY_F11:
+			JobSystem::RunBenchmark();
+			break;
+
+		case GLFW_KEY_T:
+			TextureCache::PrintStats();
+			MeshCache::PrintStats();
+			break;
+
 		case GLFW_KEY_F9:
 			renderer->bDebugConeDirection = !renderer->bDebugConeDirection;
 			if (renderer->bDebugConeDirection)
@@ -250,6 +305,58 @@ void TestApp::KeyCallback(GLFWwindow * window, int key, int scanCode, int action
 			}
 			break;
 
+		case GLFW_KEY_G:
+			renderer->bEnableGPUFrustumCulling = !renderer->bEnableGPUFrustumCulling;
+			if (renderer->bEnableGPUFrustumCulling)
+			{
+				std::cout << "Renderer : Frustum Culling on GPU!" << std::endl;
+			}
+			else
+			{
+				std::cout << "Renderer : Frustum Culling on CPU!" << std::endl;
+			}
+			break;
+
+		case GLFW_KEY_B:
+			renderer->bEnableSIMDCulling = !renderer->bEnableSIMDCulling;
+			if (renderer->bEnableSIMDCulling)
+			{
+				std::cout << "Renderer : CPU Frustum Culling with " << FrustumCuller::ToString(FrustumCuller::GetSupportedLevel()) << std::endl;
+			}
+			else
+			{
+				std::cout << "Renderer : CPU Frustum Culling with BVH" << std::endl;
+			}
+			break;
+
+		case GLFW_KEY_O:
+			renderer->bEnableOcclusionCulling = !renderer->bEnableOcclusionCulling;
+			if (renderer->bEnableOcclusionCulling)
+			{
+				std::cout << "Renderer : Enable Hi-Z Occlusion Culling! (VCT pass vertex work only)" << std::endl;
+				if (!renderer->IsOcclusionCullingActive())
+				{
+					std::cout << "Renderer : Hi-Z Occlusion Culling needs depth prepass, GPU frustum culling and dynamic resolution" << std::endl;
+				}
+			}
+			else
+			{
+				std::cout << "Renderer : Disable Hi-Z Occlusion Culling!" << std::endl;
+			}
+			break;
+
+		case GLFW_KEY_I:
+			renderer->bEnableInstancing = !renderer->bEnableInstancing;
+			if (renderer->bEnableInstancing)
+			{
+				std::cout << "Renderer : Enable Instancing!" << std::endl;
+			}
+			else
+			{
+				std::cout << "Renderer : Disable Instancing!" << std::endl;
+			}
+			break;
+
 		}
 	}
 }
@@ -277,5 +384,5 @@ void TestApp::ChangeSceneTo(EPredefinedScene scene)
 	this->SetScene(m_mainScene);
 	m_controller->SetTarget(m_mainScene->GetMainCamera());
 	m_mainScene->SetToDirty();
-	renderer->PrintVCTParams();
+	renderer->PrintVCTParams(m_mainScene);
 }
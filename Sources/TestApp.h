@@ -14,11 +14,9 @@ class CornellBoxScene;
 class TestApp : public Application
 {
 public:
+	/* bPackedVertices opts in to EVertexFormat::Packed; EVertexFormat::Float otherwise */
 	TestApp(const std::string& title,
-		unsigned int width, unsigned int height, bool bFullScreen) :
-		Application(title, width, height, bFullScreen)
-	{
-	}
+		unsigned int width, unsigned int height, bool bFullScreen, bool bPackedVertices = false);
 
 	~TestApp();
 
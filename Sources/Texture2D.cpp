@@ -1,14 +1,23 @@
 #include "Texture2D.h"
+#include "GLStateCache.h"
+#include "TextureStreamer.h"
+#include "TextureCache.h"
+#include "MaterialTable.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #ifndef STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
 #endif
 
-Texture2D::Texture2D(std::string_view filePath, Sampler2D sampler, bool bGenerateMip) :
+Texture2D::Texture2D(std::string_view filePath, Sampler2D sampler, bool bGenerateMip, bool bSRGB) :
 m_id(0),
 m_latestSlot(0),
-m_uri(filePath)
+m_uri(filePath),
+m_sampler(sampler),
+m_bGenerateMip(bGenerateMip),
+m_bSRGB(bSRGB)
 {
 	int width = 0;
 	int height = 0;
@@ -17,7 +26,7 @@ m_uri(filePath)
 	if (data != nullptr)
 	{
 		glGenTextures(1, &m_id);
-		glBindTexture(GL_TEXTURE_2D, m_id);
+		GLStateCache::BindTexture(GL_TEXTURE_2D, 0, m_id);
 
 		glTexParameteri(
 			GL_TEXTURE_2D,
@@ -37,29 +46,34 @@ m_uri(filePath)
 			sampler.WrapT);
 
 		GLenum format = GL_RGB;
+		GLenum internalFormat = bSRGB ? GL_SRGB8 : GL_RGB;
 		switch(channels)
 		{
 		case 1:
 			format = GL_RED;
+			internalFormat = GL_RED;
 			break;
 
 		case 2:
 			format = GL_RG;
+			internalFormat = GL_RG;
 			break;
 
 		case 4:
 			format = GL_RGBA;
+			internalFormat = bSRGB ? GL_SRGB8_ALPHA8 : GL_RGBA;
 			break;
 		default:
 			break;
 		}
 
-		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, data);
 		if (bGenerateMip)
 		{
 			glGenerateMipmap(GL_TEXTURE_2D);
 		}
 
+		m_byteSize = CalcByteSize(width, height, channels, bGenerateMip);
 		stbi_image_free(data);
 	}
 	else
@@ -73,7 +87,7 @@ Texture2D::Texture2D(tinygltf::Image& image, tinygltf::Sampler& sampler) :
 	m_latestSlot(0)
 {
 	glGenTextures(1, &m_id);
-	glBindTexture(GL_TEXTURE_2D, m_id);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, 0, m_id);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
 	glTexParameteri(
@@ -116,18 +130,79 @@ Texture2D::Texture2D(tinygltf::Image& image, tinygltf::Sampler& sampler) :
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height,
 		0, format, type, &image.image.at(0));
 	glGenerateMipmap(GL_TEXTURE_2D);
+
+	m_byteSize = CalcByteSize(image.width, image.height, 4, true);
+}
+
+Texture2D::Texture2D(std::string_view filePath, Sampler2D sampler, bool bGenerateMip, bool bSRGB, GLuint placeholder) :
+	m_id(0),
+	m_latestSlot(0),
+	m_uri(filePath),
+	m_sampler(sampler),
+	m_bGenerateMip(bGenerateMip),
+	m_bSRGB(bSRGB),
+	m_placeholder(placeholder),
+	m_bResident(false)
+{
+}
+
+Texture2D::~Texture2D()
+{
+	if (!m_bResident)
+	{
+		TextureStreamer::Cancel(this);
+	}
+
+	if (m_id != 0)
+	{
+		MaterialTable::ReleaseTextureReference(m_id);
+		GLStateCache::OnTextureDeleted(m_id);
+		glDeleteTextures(1, &m_id);
+		m_id = 0;
+	}
+}
+
+Texture2D* Texture2D::LoadAsync(std::string_view filePath, glm::u8vec4 placeholder, Sampler2D sampler, bool bGenerateMip, bool bSRGB)
+{
+	if (!TextureStreamer::IsEnabled())
+	{
+		return new Texture2D(filePath, sampler, bGenerateMip, bSRGB);
+	}
+
+	Texture2D* texture = new Texture2D(filePath, sampler, bGenerateMip, bSRGB, TextureStreamer::GetPlaceholder(placeholder));
+	TextureStreamer::Request(texture);
+	return texture;
+}
+
+void Texture2D::Release(Texture2D* texture)
+{
+	if (texture != nullptr && --texture->m_refCount == 0)
+	{
+		TextureCache::Remove(texture);
+		delete texture;
+	}
+}
+
+size_t Texture2D::CalcByteSize(int width, int height, int channels, bool bGenerateMip)
+{
+	size_t byteSize = 0;
+	const int levels = bGenerateMip ? static_cast<int>(std::log2(std::max(width, height))) + 1 : 1;
+	for (int level = 0; level < levels; ++level)
+	{
+		byteSize += static_cast<size_t>(std::max(width >> level, 1)) * std::max(height >> level, 1) * channels;
+	}
+
+	return byteSize;
 }
 
 void Texture2D::Bind(unsigned int slot)
 {
-	glActiveTexture(GL_TEXTURE0 + slot);
-	glBindTexture(GL_TEXTURE_2D, m_id);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, slot, GetID());
 	m_latestSlot = slot;
 }
 
 void Texture2D::Unbind()
 {
-	glActiveTexture(GL_TEXTURE0 + m_latestSlot);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	GLStateCache::BindTexture(GL_TEXTURE_2D, m_latestSlot, 0);
 	m_latestSlot = 0;
 }
\ No newline at end of file
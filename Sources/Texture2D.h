@@ -1,5 +1,7 @@
 #pragma once
 #include "Rendering.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/type_precision.hpp"
 #include <string>
 
 namespace tinygltf
@@ -16,23 +18,58 @@ struct Sampler2D
 	GLint WrapT = GL_REPEAT;
 };
 
+/*
+* Shared by reference count; created with one reference and deleted by the last Release, never by delete.
+* Owner such as Material holds one reference of each texture it refers to.
+**/
 class Texture2D
 {
 public:
-	Texture2D(std::string_view filePath, Sampler2D sampler = Sampler2D(), bool bGenerateMip = true);
+	/* bSRGB : sRGB internal format, only for 3 or 4 channel images */
+	Texture2D(std::string_view filePath, Sampler2D sampler = Sampler2D(), bool bGenerateMip = true, bool bSRGB = false);
 	Texture2D(tinygltf::Image& image, tinygltf::Sampler& sampler);
 
-	unsigned int GetID() const { return m_id; }
+	/* Decoded and uploaded in background by TextureStreamer; 1x1 placeholder of given color is used until then */
+	static Texture2D* LoadAsync(std::string_view filePath, glm::u8vec4 placeholder, Sampler2D sampler = Sampler2D(), bool bGenerateMip = true, bool bSRGB = false);
+
+	void AddRef() { ++m_refCount; }
+	static void Release(Texture2D* texture);
+	unsigned int GetRefCount() const { return m_refCount; }
+
+	/* Placeholder while streaming; zero if streamed file could not be loaded */
+	unsigned int GetID() const { return m_bResident ? m_id : m_placeholder; }
+	bool IsResident() const { return m_bResident; }
 	unsigned int GetBoundedSlot() const { return m_latestSlot; }
 
 	void Bind(unsigned int slot);
 	void Unbind();
 
 	std::string GetURI() const { return m_uri; }
+	/* Estimated GPU memory including mip chain; zero until resident */
+	size_t GetByteSize() const { return m_byteSize; }
+
+private:
+	friend class TextureStreamer;
+	friend class TextureCache;
+	Texture2D(std::string_view filePath, Sampler2D sampler, bool bGenerateMip, bool bSRGB, GLuint placeholder);
+	~Texture2D();
+
+	static size_t CalcByteSize(int width, int height, int channels, bool bGenerateMip);
 
 private:
 	unsigned int m_id;
 	unsigned int m_latestSlot;
 	std::string	 m_uri;
 
+	Sampler2D m_sampler;
+	bool m_bGenerateMip = true;
+	bool m_bSRGB = false;
+	GLuint m_placeholder = 0;
+	bool m_bResident = true;
+
+	unsigned int m_refCount = 1;
+	size_t m_byteSize = 0;
+	/* Key in TextureCache; empty if texture is not cached */
+	std::string m_cacheKey;
+
 };
\ No newline at end of file
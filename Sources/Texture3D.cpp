@@ -1,4 +1,5 @@
 ﻿#include "Texture3D.h"
+#include "GLStateCache.h"
 
 Texture3D::Texture3D(const std::vector<GLfloat>& rawData, unsigned int width, unsigned int height, unsigned int depth, Sampler3D sampler, unsigned int maxMipLevel, bool bGenerateMip) :
 m_width(width),
@@ -7,7 +8,7 @@ m_depth(depth),
 m_maxMipLevel(maxMipLevel)
 {
    glGenTextures(1, &m_id);
-   glBindTexture(GL_TEXTURE_3D, m_id);
+   GLStateCache::BindTexture(GL_TEXTURE_3D, 0, m_id);
 
    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, sampler.MinFilter);
    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, sampler.MagFilter);
@@ -23,7 +24,7 @@ m_maxMipLevel(maxMipLevel)
       glGenerateMipmap(GL_TEXTURE_3D);
    }
 
-   glBindTexture(GL_TEXTURE_3D, 0);
+   GLStateCache::BindTexture(GL_TEXTURE_3D, 0, 0);
 }
 
 Texture3D::Texture3D(const std::vector<GLuint>& rawData, unsigned width, unsigned height, unsigned depth,
@@ -34,7 +35,7 @@ Texture3D::Texture3D(const std::vector<GLuint>& rawData, unsigned width, unsigne
    m_maxMipLevel(maxMipLevel)
 {
    glGenTextures(1, &m_id);
-   glBindTexture(GL_TEXTURE_3D, m_id);
+   GLStateCache::BindTexture(GL_TEXTURE_3D, 0, m_id);
 
    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, sampler.MinFilter);
    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, sampler.MagFilter);
@@ -50,35 +51,25 @@ Texture3D::Texture3D(const std::vector<GLuint>& rawData, unsigned width, unsigne
       glGenerateMipmap(GL_TEXTURE_3D);
    }
 
-   glBindTexture(GL_TEXTURE_3D, 0);
+   GLStateCache::BindTexture(GL_TEXTURE_3D, 0, 0);
 }
 
 void Texture3D::Bind(unsigned int slot)
 {
-   glActiveTexture(GL_TEXTURE0 + slot);
-   glBindTexture(GL_TEXTURE_3D, m_id);
+   GLStateCache::BindTexture(GL_TEXTURE_3D, slot, m_id);
 }
 
 void Texture3D::Unbind(unsigned slot)
 {
-   glActiveTexture(GL_TEXTURE0 + slot);
-   glBindTexture(GL_TEXTURE_3D, 0);
+   GLStateCache::BindTexture(GL_TEXTURE_3D, slot, 0);
 }
 
 void Texture3D::Clear(GLfloat clearColor[4])
 {
-   GLint prevBoundTexture = 0;
-   glGetIntegerv(GL_TEXTURE_BINDING_3D, &prevBoundTexture);
-   glBindTexture(GL_TEXTURE_3D, m_id);
    glClearTexImage(m_id, 0, GL_RGBA, GL_FLOAT, clearColor);
-   glBindTexture(GL_TEXTURE_3D, prevBoundTexture);
 }
 
 void Texture3D::Clear(unsigned int value)
 {
-   GLint prevBoundTexture = 0;
-   glGetIntegerv(GL_TEXTURE_BINDING_3D, &prevBoundTexture);
-   glBindTexture(GL_TEXTURE_3D, m_id);
    glClearTexImage(m_id, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, &value);
-   glBindTexture(GL_TEXTURE_3D, prevBoundTexture);
 }
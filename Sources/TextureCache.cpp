@@ -0,0 +1,86 @@
+#include "TextureCache.h"
+
+#include <filesystem>
+#include <iostream>
+
+std::unordered_map<std::string, TextureCache::Entry> TextureCache::s_entries;
+size_t TextureCache::s_hits = 0;
+size_t TextureCache::s_misses = 0;
+size_t TextureCache::s_retiredBytesSaved = 0;
+
+std::string TextureCache::MakeKey(std::string_view filePath, const Sampler2D& sampler, bool bSRGB)
+{
+	std::error_code error;
+	std::filesystem::path path = std::filesystem::weakly_canonical(std::filesystem::path(filePath), error);
+	if (error)
+	{
+		path = std::filesystem::path(filePath).lexically_normal();
+	}
+
+	std::string key = path.generic_string();
+	key.append("|");
+	key.append(std::to_string(sampler.MinFilter)).append(",");
+	key.append(std::to_string(sampler.MagFilter)).append(",");
+	key.append(std::to_string(sampler.WrapS)).append(",");
+	key.append(std::to_string(sampler.WrapT));
+	key.append(bSRGB ? "|sRGB" : "|Linear");
+	return key;
+}
+
+Texture2D* TextureCache::Acquire(std::string_view filePath, glm::u8vec4 placeholder, Sampler2D sampler, bool bSRGB)
+{
+	std::string key = MakeKey(filePath, sampler, bSRGB);
+	if (auto found = s_entries.find(key); found != s_entries.end())
+	{
+		++s_hits;
+		++found->second.Hits;
+		found->second.Texture->AddRef();
+		return found->second.Texture;
+	}
+
+	++s_misses;
+	Texture2D* texture = Texture2D::LoadAsync(filePath, placeholder, sampler, true, bSRGB);
+	texture->m_cacheKey = key;
+	s_entries[std::move(key)] = Entry{ texture, 0 };
+	return texture;
+}
+
+void TextureCache::Remove(Texture2D* texture)
+{
+	if (texture->m_cacheKey.empty())
+	{
+		return;
+	}
+
+	if (auto found = s_entries.find(texture->m_cacheKey); found != s_entries.end() && found->second.Texture == texture)
+	{
+		s_retiredBytesSaved += found->second.Hits * texture->GetByteSize();
+		s_entries.erase(found);
+	}
+}
+
+size_t TextureCache::GetBytesSaved()
+{
+	size_t bytesSaved = s_retiredBytesSaved;
+	for (const auto& entry : s_entries)
+	{
+		bytesSaved += entry.second.Hits * entry.second.Texture->GetByteSize();
+	}
+
+	return bytesSaved;
+}
+
+void TextureCache::PrintStats()
+{
+	size_t cachedBytes = 0;
+	for (const auto& entry : s_entries)
+	{
+		cachedBytes += entry.second.Texture->GetByteSize();
+	}
+
+	std::cout << "----   Texture Cache   ----" << std::endl;
+	std::cout << "Cached Textures : " << s_entries.size() << " (" << (cachedBytes / (1024.0 * 1024.0)) << " MB)" << std::endl;
+	std::cout << "Hits : " << s_hits << ", Misses : " << s_misses << std::endl;
+	std::cout << "Saved : " << (GetBytesSaved() / (1024.0 * 1024.0)) << " MB" << std::endl;
+	std::cout << std::endl;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "Texture2D.h"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/*
+* Shares textures loaded from same file with same sampler and color space.
+* Key is canonical path, so different spellings of one file hit same entry.
+* Entry lives while its texture has references; last Texture2D::Release removes it.
+**/
+class TextureCache
+{
+public:
+	/* Returns texture with one more reference for caller; streamed with placeholder on miss */
+	static Texture2D* Acquire(std::string_view filePath, glm::u8vec4 placeholder, Sampler2D sampler = Sampler2D(), bool bSRGB = false);
+
+	static size_t GetHits() { return s_hits; }
+	static size_t GetMisses() { return s_misses; }
+	/* GPU memory of uploads avoided by hits, counted once texture is resident */
+	static size_t GetBytesSaved();
+	static size_t GetCachedTextures() { return s_entries.size(); }
+
+	static void PrintStats();
+
+private:
+	friend class Texture2D;
+	static void Remove(Texture2D* texture);
+	static std::string MakeKey(std::string_view filePath, const Sampler2D& sampler, bool bSRGB);
+
+private:
+	struct Entry
+	{
+		Texture2D* Texture = nullptr;
+		size_t Hits = 0;
+	};
+
+	static std::unordered_map<std::string, Entry> s_entries;
+	static size_t s_hits;
+	static size_t s_misses;
+	/* Bytes saved by entries which are already removed */
+	static size_t s_retiredBytesSaved;
+
+};
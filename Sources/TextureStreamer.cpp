@@ -0,0 +1,326 @@
+#include "TextureStreamer.h"
+#include "Texture2D.h"
+#include "MaterialTable.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+constexpr GLsizeiptr UnpackRingSize = 64 << 20;
+constexpr GLsizeiptr UnpackAlignment = 16;
+
+JobSystem* TextureStreamer::s_jobSystem = nullptr;
+JobCounter* TextureStreamer::s_decodeJobs = nullptr;
+
+GLuint TextureStreamer::s_unpackBuffer = 0;
+GLubyte* TextureStreamer::s_mapped = nullptr;
+GLintptr TextureStreamer::s_head = 0;
+GLintptr TextureStreamer::s_tail = 0;
+
+std::unordered_map<Texture2D*, uint64_t> TextureStreamer::s_requests;
+uint64_t TextureStreamer::s_nextRequestID = 1;
+
+std::mutex TextureStreamer::s_decodedMutex;
+std::deque<TextureStreamer::DecodedImage> TextureStreamer::s_decoded;
+std::deque<TextureStreamer::InFlightUpload> TextureStreamer::s_inFlight;
+
+std::unordered_map<uint32_t, GLuint> TextureStreamer::s_placeholders;
+
+void TextureStreamer::Init(JobSystem* jobSystem)
+{
+	if (s_jobSystem != nullptr || jobSystem == nullptr)
+	{
+		return;
+	}
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glCreateBuffers(1, &s_unpackBuffer);
+	glNamedBufferStorage(s_unpackBuffer, UnpackRingSize, nullptr, flags);
+	s_mapped = static_cast<GLubyte*>(glMapNamedBufferRange(s_unpackBuffer, 0, UnpackRingSize, flags));
+	if (s_mapped == nullptr)
+	{
+		std::cout << "TextureStreamer : Failed to map pixel unpack buffer, textures are loaded synchronously" << std::endl;
+		glDeleteBuffers(1, &s_unpackBuffer);
+		s_unpackBuffer = 0;
+		return;
+	}
+
+	s_jobSystem = jobSystem;
+	s_decodeJobs = new JobCounter();
+}
+
+void TextureStreamer::Shutdown()
+{
+	if (s_jobSystem == nullptr)
+	{
+		return;
+	}
+
+	s_jobSystem->Wait(*s_decodeJobs);
+	delete s_decodeJobs;
+	s_decodeJobs = nullptr;
+	s_jobSystem = nullptr;
+
+	for (DecodedImage& image : s_decoded)
+	{
+		stbi_image_free(image.Pixels);
+	}
+	s_decoded.clear();
+
+	for (InFlightUpload& upload : s_inFlight)
+	{
+		glDeleteSync(upload.Fence);
+	}
+	s_inFlight.clear();
+	s_requests.clear();
+
+	glUnmapNamedBuffer(s_unpackBuffer);
+	glDeleteBuffers(1, &s_unpackBuffer);
+	s_unpackBuffer = 0;
+	s_mapped = nullptr;
+
+	for (auto& placeholder : s_placeholders)
+	{
+		glDeleteTextures(1, &placeholder.second);
+	}
+	s_placeholders.clear();
+}
+
+void TextureStreamer::Request(Texture2D* texture)
+{
+	const uint64_t requestID = s_nextRequestID++;
+	s_requests[texture] = requestID;
+
+	s_jobSystem->Run([texture, requestID, filePath = texture->GetURI()]()
+	{
+		DecodedImage image;
+		image.Target = texture;
+		image.RequestID = requestID;
+		image.Pixels = stbi_load(filePath.c_str(), &image.Width, &image.Height, &image.Channels, 0);
+
+		std::lock_guard<std::mutex> lock(s_decodedMutex);
+		s_decoded.push_back(image);
+	}, s_decodeJobs);
+}
+
+void TextureStreamer::Cancel(Texture2D* texture)
+{
+	s_requests.erase(texture);
+}
+
+bool TextureStreamer::IsRequested(Texture2D* texture, uint64_t requestID)
+{
+	const auto found = s_requests.find(texture);
+	return found != s_requests.end() && found->second == requestID;
+}
+
+bool TextureStreamer::AllocateStaging(GLsizeiptr size, GLintptr& offset)
+{
+	size = ((size + UnpackAlignment - 1) / UnpackAlignment) * UnpackAlignment;
+	if (s_inFlight.empty())
+	{
+		s_head = 0;
+		s_tail = 0;
+	}
+
+	// Free space is [head, end) and [0, tail) while head is ahead of tail, otherwise [head, tail)
+	if (s_inFlight.empty() || s_head > s_tail)
+	{
+		if (s_head + size <= UnpackRingSize)
+		{
+			offset = s_head;
+			s_head += size;
+			return true;
+		}
+
+		if (size <= s_tail)
+		{
+			offset = 0;
+			s_head = size;
+			return true;
+		}
+
+		return false;
+	}
+
+	if (s_head < s_tail && s_head + size <= s_tail)
+	{
+		offset = s_head;
+		s_head += size;
+		return true;
+	}
+
+	return false;
+}
+
+void TextureStreamer::Upload(DecodedImage& image, const void* pixels)
+{
+	Texture2D* texture = image.Target;
+
+	GLenum format = GL_RGB;
+	GLenum internalFormat = GL_RGB8;
+	switch (image.Channels)
+	{
+	case 1:
+		format = GL_RED;
+		internalFormat = GL_R8;
+		break;
+
+	case 2:
+		format = GL_RG;
+		internalFormat = GL_RG8;
+		break;
+
+	case 4:
+		format = GL_RGBA;
+		internalFormat = texture->m_bSRGB ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+		break;
+
+	default:
+		internalFormat = texture->m_bSRGB ? GL_SRGB8 : GL_RGB8;
+		break;
+	}
+
+	const GLsizei levels = texture->m_bGenerateMip ?
+		static_cast<GLsizei>(std::log2(std::max(image.Width, image.Height))) + 1 : 1;
+
+	glCreateTextures(GL_TEXTURE_2D, 1, &texture->m_id);
+	glTextureStorage2D(texture->m_id, levels, internalFormat, image.Width, image.Height);
+	glTextureParameteri(texture->m_id, GL_TEXTURE_MIN_FILTER, texture->m_sampler.MinFilter);
+	glTextureParameteri(texture->m_id, GL_TEXTURE_MAG_FILTER, texture->m_sampler.MagFilter);
+	glTextureParameteri(texture->m_id, GL_TEXTURE_WRAP_S, texture->m_sampler.WrapS);
+	glTextureParameteri(texture->m_id, GL_TEXTURE_WRAP_T, texture->m_sampler.WrapT);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTextureSubImage2D(texture->m_id, 0, 0, 0, image.Width, image.Height, format, GL_UNSIGNED_BYTE, pixels);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	if (texture->m_bGenerateMip)
+	{
+		glGenerateTextureMipmap(texture->m_id);
+	}
+
+	texture->m_byteSize = Texture2D::CalcByteSize(image.Width, image.Height, image.Channels, texture->m_bGenerateMip);
+}
+
+unsigned int TextureStreamer::Update()
+{
+	if (!IsEnabled())
+	{
+		return 0;
+	}
+
+	// Uploads are fenced in submit order, so only front can be signaled first
+	unsigned int residentCount = 0;
+	while (!s_inFlight.empty())
+	{
+		InFlightUpload& upload = s_inFlight.front();
+		if (glClientWaitSync(upload.Fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+		{
+			break;
+		}
+
+		glDeleteSync(upload.Fence);
+		s_tail = upload.End;
+		if (IsRequested(upload.Target, upload.RequestID))
+		{
+			upload.Target->m_bResident = true;
+			s_requests.erase(upload.Target);
+			++residentCount;
+		}
+
+		s_inFlight.pop_front();
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s_unpackBuffer);
+	while (true)
+	{
+		DecodedImage image;
+		{
+			std::lock_guard<std::mutex> lock(s_decodedMutex);
+			if (s_decoded.empty())
+			{
+				break;
+			}
+
+			image = s_decoded.front();
+			s_decoded.pop_front();
+		}
+
+		if (!IsRequested(image.Target, image.RequestID))
+		{
+			stbi_image_free(image.Pixels);
+			continue;
+		}
+
+		if (image.Pixels == nullptr)
+		{
+			std::cout << "Failed to load texture : " << image.Target->GetURI() << std::endl;
+			image.Target->m_bResident = true;
+			s_requests.erase(image.Target);
+			++residentCount;
+			continue;
+		}
+
+		const GLsizeiptr size = static_cast<GLsizeiptr>(image.Width) * image.Height * image.Channels;
+		GLintptr offset = 0;
+		if (size > UnpackRingSize)
+		{
+			// Never fits in ring; upload straight from client memory
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			Upload(image, image.Pixels);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s_unpackBuffer);
+		}
+		else if (AllocateStaging(size, offset))
+		{
+			std::memcpy(s_mapped + offset, image.Pixels, size);
+			Upload(image, reinterpret_cast<const void*>(offset));
+		}
+		else
+		{
+			// Ring is full; retry after some uploads are signaled
+			std::lock_guard<std::mutex> lock(s_decodedMutex);
+			s_decoded.push_front(image);
+			break;
+		}
+
+		stbi_image_free(image.Pixels);
+
+		InFlightUpload upload;
+		upload.Target = image.Target;
+		upload.RequestID = image.RequestID;
+		upload.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		upload.End = s_head;
+		s_inFlight.push_back(upload);
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	// Materials keep referencing placeholder until they are re-packed
+	if (residentCount > 0)
+	{
+		MaterialTable::MarkAllDirty();
+	}
+
+	return residentCount;
+}
+
+GLuint TextureStreamer::GetPlaceholder(glm::u8vec4 color)
+{
+	const uint32_t key = (color.r << 24) | (color.g << 16) | (color.b << 8) | color.a;
+	if (const auto found = s_placeholders.find(key); found != s_placeholders.end())
+	{
+		return found->second;
+	}
+
+	GLuint placeholder = 0;
+	glCreateTextures(GL_TEXTURE_2D, 1, &placeholder);
+	glTextureStorage2D(placeholder, 1, GL_RGBA8, 1, 1);
+	glTextureParameteri(placeholder, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTextureParameteri(placeholder, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTextureSubImage2D(placeholder, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, &color);
+
+	s_placeholders[key] = placeholder;
+	return placeholder;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "Rendering.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/type_precision.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class JobSystem;
+class JobCounter;
+class Texture2D;
+
+/*
+* Decodes image files on job system workers and uploads them through a persistently mapped pixel unpack ring.
+* Texture shows a 1x1 placeholder until the fence placed after its upload is signaled.
+* Decoding and uploads of different textures overlap, instead of stbi_load and glTexImage2D in sequence on main thread.
+**/
+class TextureStreamer
+{
+public:
+	/* Without job system, Texture2D::LoadAsync loads synchronously */
+	static void Init(JobSystem* jobSystem);
+	static void Shutdown();
+	static bool IsEnabled() { return s_jobSystem != nullptr; }
+
+	static void Request(Texture2D* texture);
+	/* Drops pending request of texture, e.g. when it is deleted before resident */
+	static void Cancel(Texture2D* texture);
+
+	/* Uploads decoded images while ring has space, then makes textures of signaled uploads resident; main thread only */
+	static unsigned int Update();
+
+	/* Shared 1x1 RGBA8 texture of color */
+	static GLuint GetPlaceholder(glm::u8vec4 color);
+
+	static size_t GetPendingCount() { return s_requests.size(); }
+
+private:
+	struct DecodedImage
+	{
+		Texture2D* Target = nullptr;
+		uint64_t RequestID = 0;
+		int Width = 0;
+		int Height = 0;
+		int Channels = 0;
+		unsigned char* Pixels = nullptr;
+	};
+
+	struct InFlightUpload
+	{
+		Texture2D* Target = nullptr;
+		uint64_t RequestID = 0;
+		GLsync Fence = nullptr;
+		GLintptr End = 0;
+	};
+
+	static bool IsRequested(Texture2D* texture, uint64_t requestID);
+	static bool AllocateStaging(GLsizeiptr size, GLintptr& offset);
+	static void Upload(DecodedImage& image, const void* pixels);
+
+private:
+	static JobSystem* s_jobSystem;
+	static JobCounter* s_decodeJobs;
+
+	static GLuint s_unpackBuffer;
+	static GLubyte* s_mapped;
+	static GLintptr s_head;
+	static GLintptr s_tail;
+
+	/* Main thread only; request id tells a new request apart from one for deleted texture at same address */
+	static std::unordered_map<Texture2D*, uint64_t> s_requests;
+	static uint64_t s_nextRequestID;
+
+	static std::mutex s_decodedMutex;
+	static std::deque<DecodedImage> s_decoded;
+	static std::deque<InFlightUpload> s_inFlight;
+
+	static std::unordered_map<uint32_t, GLuint> s_placeholders;
+
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+/* 64-bit FNV-1a */
+constexpr uint64_t HashUniformName(std::string_view name)
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (const char character : name)
+	{
+		hash ^= static_cast<uint64_t>(static_cast<unsigned char>(character));
+		hash *= 0x100000001b3ull;
+	}
+
+	// Zero marks an empty slot of location table
+	return (hash == 0) ? 1 : hash;
+}
+
+/*
+* Uniform name hashed at compile time. String literals convert implicitly,
+* so Shader::SetXXX("name", ...) never builds a std::string or hashes at runtime.
+**/
+struct UniformID
+{
+	consteval UniformID(const char* name) :
+		Hash(HashUniformName(name))
+	{
+	}
+
+	/* For names only known at runtime(ex. reflection); not intended for hot path */
+	static constexpr UniformID FromString(std::string_view name)
+	{
+		return UniformID(HashUniformName(name), 0);
+	}
+
+	uint64_t Hash = 0;
+
+private:
+	constexpr UniformID(uint64_t hash, int) :
+		Hash(hash)
+	{
+	}
+
+};
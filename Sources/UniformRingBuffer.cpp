@@ -0,0 +1,91 @@
+#include "UniformRingBuffer.h"
+
+#include <cstring>
+#include <iostream>
+
+constexpr GLuint64 FenceWaitTimeout = 1000000; // ns
+
+UniformRingBuffer::UniformRingBuffer(GLsizeiptr frameSize)
+{
+	GLint alignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	if (alignment > 0)
+	{
+		m_alignment = alignment;
+	}
+
+	m_frameSize = ((frameSize + m_alignment - 1) / m_alignment) * m_alignment;
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glCreateBuffers(1, &m_buffer);
+	glNamedBufferStorage(m_buffer, m_frameSize * UniformRingFrameCount, nullptr, flags);
+	m_mapped = static_cast<GLubyte*>(glMapNamedBufferRange(m_buffer, 0, m_frameSize * UniformRingFrameCount, flags));
+	if (m_mapped == nullptr)
+	{
+		std::cout << "UniformRingBuffer : Failed to map persistent uniform buffer" << std::endl;
+	}
+}
+
+UniformRingBuffer::~UniformRingBuffer()
+{
+	for (GLsync& fence : m_fences)
+	{
+		if (fence != nullptr)
+		{
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+
+	if (m_mapped != nullptr)
+	{
+		glUnmapNamedBuffer(m_buffer);
+		m_mapped = nullptr;
+	}
+
+	glDeleteBuffers(1, &m_buffer);
+}
+
+void UniformRingBuffer::BeginFrame()
+{
+	m_frame = (m_frame + 1) % UniformRingFrameCount;
+	m_offset = 0;
+
+	GLsync& fence = m_fences[m_frame];
+	if (fence != nullptr)
+	{
+		GLenum result = glClientWaitSync(fence, 0, 0);
+		while (result == GL_TIMEOUT_EXPIRED)
+		{
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FenceWaitTimeout);
+		}
+
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+}
+
+void UniformRingBuffer::EndFrame()
+{
+	m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void UniformRingBuffer::Bind(GLuint binding, const void* data, GLsizeiptr size)
+{
+	if (m_mapped == nullptr)
+	{
+		return;
+	}
+
+	if (m_offset + size > m_frameSize)
+	{
+		std::cout << "UniformRingBuffer : Out of frame region(" << m_frameSize << " bytes)" << std::endl;
+		return;
+	}
+
+	const GLintptr offset = m_frameSize * m_frame + m_offset;
+	std::memcpy(m_mapped + offset, data, size);
+	glBindBufferRange(GL_UNIFORM_BUFFER, binding, m_buffer, offset, size);
+
+	m_offset += ((size + m_alignment - 1) / m_alignment) * m_alignment;
+}
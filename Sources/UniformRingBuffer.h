@@ -0,0 +1,41 @@
+#pragma once
+#include "Rendering.h"
+
+/* Frames which may be in flight at once; each owns its own region of the ring */
+constexpr unsigned int UniformRingFrameCount = 3;
+
+/*
+* Persistently mapped uniform buffer, split into one region per in-flight frame.
+* Constants are written straight into mapped memory and bound with glBindBufferRange.
+* Region of a frame is reused only after the fence placed at the end of that frame is signaled.
+**/
+class UniformRingBuffer
+{
+public:
+	UniformRingBuffer(GLsizeiptr frameSize);
+	~UniformRingBuffer();
+
+	/* Waits until GPU finished with the region of this frame */
+	void BeginFrame();
+	void EndFrame();
+
+	/* Copies data into the region of current frame and binds it to uniform block binding point */
+	void Bind(GLuint binding, const void* data, GLsizeiptr size);
+
+	template <typename T>
+	void Bind(GLuint binding, const T& data)
+	{
+		Bind(binding, &data, sizeof(T));
+	}
+
+private:
+	GLuint m_buffer = 0;
+	GLubyte* m_mapped = nullptr;
+	GLsizeiptr m_frameSize = 0;
+	GLsizeiptr m_alignment = 256;
+
+	GLsync m_fences[UniformRingFrameCount] = { nullptr, nullptr, nullptr };
+	unsigned int m_frame = 0;
+	GLsizeiptr m_offset = 0;
+
+};
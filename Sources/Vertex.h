@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include <glm/glm.hpp>
+#include <cstdint>
 
 /*
 * @ float3 : POSITION
@@ -14,3 +15,21 @@ struct VertexPosTexNT
    glm::vec3 Normal;
    glm::vec3 Tangent;
 };
+
+/*
+* Packed layout of VertexPosTexNT
+* @ unorm16x3 : POSITION, quantized in bounds of its mesh; followed by 2 bytes padding
+* @ half2 : TEXCOORD0
+* @ snorm16x2 : NORMAL, octahedral
+* @ snorm16x2 : TANGENT, octahedral
+**/
+struct VertexPacked
+{
+   uint16_t Position[3];
+   uint16_t Padding;
+   uint32_t TexCoord;
+   uint32_t Normal;
+   uint32_t Tangent;
+};
+
+static_assert(sizeof(VertexPacked) == 20, "VertexPacked must be 20 bytes");
@@ -1,8 +1,9 @@
 #include "Viewport.h"
+#include "GLStateCache.h"
 
 #include "GL/gl3w.h"
 
 void Viewport::Bind()
 {
-	glViewport(m_x, m_y, m_width, m_height);
+	GLStateCache::Viewport(m_x, m_y, m_width, m_height);
 }
\ No newline at end of file
@@ -4,10 +4,21 @@
 #include "tinygltf/tiny_gltf.h"
 #include "TestApp.h"
 #include <iostream>
+#include <cstring>
 
-int main()
+int main(int argc, char** argv)
 {
-	Application* app = new TestApp("Test", 1280, 720, false);
+	// --packed-vertices : use 20 bytes VertexPacked instead of full precision vertices
+	bool bPackedVertices = false;
+	for (int idx = 1; idx < argc; ++idx)
+	{
+		if (std::strcmp(argv[idx], "--packed-vertices") == 0)
+		{
+			bPackedVertices = true;
+		}
+	}
+
+	Application* app = new TestApp("Test", 1280, 720, false, bPackedVertices);
 	//Application* app = new TestApp("Test", 1920, 1080, true);
 
 	int res = app->Run();